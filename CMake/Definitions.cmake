@@ -18,6 +18,9 @@ foreach(
   DEVILUTIONX_RESAMPLER_SPEEX
   DEVILUTIONX_RESAMPLER_SDL
   DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
+  DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+  DEVILUTIONX_MMAP_MPQS
+  DEVILUTIONX_CLX_CACHE
   SCREEN_READER_INTEGRATION
   UNPACKED_MPQS
   UNPACKED_SAVES
@@ -1,5 +1,6 @@
 set(BUILD_TESTING OFF)
 set(NONET ON)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 set(PREFILL_PLAYER_NAME ON)
 set(HAS_KBCTRL 1)
 set(LTO ON)
@@ -1,4 +1,6 @@
 set(BUILD_TESTING OFF)
+set(DEVILUTIONX_MMAP_MPQS OFF)
+set(DEVILUTIONX_CLX_CACHE OFF)
 set(BUILD_ASSETS_MPQ OFF)
 set(DISABLE_ZERO_TIER ON)
 set(DEVILUTIONX_SYSTEM_SDL_AUDIOLIB OFF)
@@ -1,6 +1,7 @@
 set(BUILD_ASSETS_MPQ OFF)
 set(DISABLE_ZERO_TIER ON)
 set(USE_SDL1 ON)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 
 # Do not warn about unknown attributes, such as [[nodiscard]].
 # As this build uses an older compiler, there are lots of them.
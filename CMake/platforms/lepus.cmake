@@ -1,5 +1,6 @@
 set(BUILD_ASSETS_MPQ OFF)
 set(USE_SDL1 ON)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 
 set(SDL1_VIDEO_MODE_BPP 8)
 set(SDL1_VIDEO_MODE_FLAGS SDL_HWSURFACE|SDL_TRIPLEBUF)
@@ -1,6 +1,7 @@
 set(BUILD_ASSETS_MPQ OFF)
 set(USE_SDL1 ON)
 set(NONET ON)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 set(DEVILUTIONX_SYSTEM_LIBFMT OFF)
 set(DEVILUTIONX_SYSTEM_LIBSODIUM OFF)
 set(DEVILUTIONX_SYSTEM_BZIP2 OFF)
@@ -2,6 +2,8 @@
 set(ASAN OFF)
 set(UBSAN OFF)
 set(BUILD_TESTING OFF)
+set(DEVILUTIONX_MMAP_MPQS OFF)
+set(DEVILUTIONX_CLX_CACHE OFF)
 set(BUILD_ASSETS_MPQ OFF)
 set(DEVILUTIONX_SYSTEM_LIBSODIUM OFF)
 set(DEVILUTIONX_SYSTEM_LIBFMT OFF)
@@ -1,5 +1,6 @@
 set(DISCORD_INTEGRATION OFF)
 set(BUILD_TESTING OFF)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 set(ASAN OFF)
 set(UBSAN OFF)
 SET(DISABLE_LTO ON)
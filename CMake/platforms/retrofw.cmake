@@ -1,6 +1,7 @@
 set(BUILD_ASSETS_MPQ OFF)
 set(NONET ON)
 set(USE_SDL1 ON)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 set(PREFILL_PLAYER_NAME ON)
 set(HAS_KBCTRL 1)
 set(DEVILUTIONX_GAMEPAD_TYPE Nintendo)
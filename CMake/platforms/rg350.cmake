@@ -1,5 +1,6 @@
 set(BUILD_ASSETS_MPQ OFF)
 set(USE_SDL1 ON)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 
 # LTO temporarily disabled to work around a compiler bug.
 # https://github.com/diasurgical/devilutionX/issues/4953
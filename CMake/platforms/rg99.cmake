@@ -4,6 +4,7 @@ set(UNPACKED_MPQS ON)
 set(UNPACKED_SAVES ON)
 set(NONET ON)
 set(USE_SDL1 ON)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 
 # Link `libstdc++` dynamically: ~1.3 MiB.
 # The OPK is mounted as squashfs and the binary is decompressed, while
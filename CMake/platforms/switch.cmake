@@ -3,6 +3,7 @@ list(APPEND CMAKE_MODULE_PATH "${CMAKE_CURRENT_LIST_DIR}/switch")
 set(ASAN OFF)
 set(UBSAN OFF)
 set(BUILD_TESTING OFF)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 set(BUILD_ASSETS_MPQ OFF)
 
 set(DEVILUTIONX_SYSTEM_SDL_IMAGE OFF)
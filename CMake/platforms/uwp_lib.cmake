@@ -3,6 +3,7 @@ set(UBSAN OFF)
 set(BUILD_ASSETS_MPQ OFF)
 set(BUILD_TESTING OFF)
 set(DISCORD_INTEGRATION OFF)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 
 # setting all libs to be built statically and from source
 set(DEVILUTIONX_SYSTEM_SDL2 OFF)
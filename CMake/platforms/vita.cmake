@@ -4,6 +4,7 @@ set(DEVILUTIONX_STATIC_CXX_STDLIB OFF)
 set(DEVILUTIONX_SYSTEM_SDL_IMAGE OFF)
 set(DEVILUTIONX_SYSTEM_LIBSODIUM OFF)
 set(BUILD_TESTING OFF)
+set(DEVILUTIONX_MMAP_MPQS OFF)
 set(DISABLE_ZERO_TIER ON)
 set(PREFILL_PLAYER_NAME ON)
 set(NOEXIT ON)
@@ -3,6 +3,8 @@ set(UBSAN OFF)
 set(DIST ON)
 
 set(NONET ON)
+set(DEVILUTIONX_MMAP_MPQS OFF)
+set(DEVILUTIONX_CLX_CACHE OFF)
 set(DISABLE_ZERO_TIER ON)
 set(USE_SDL1 ON)
 set(DEVILUTIONX_SYSTEM_BZIP2 OFF)
@@ -1,4 +1,6 @@
 set(NONET ON)
+set(DEVILUTIONX_MMAP_MPQS OFF)
+set(DEVILUTIONX_CLX_CACHE OFF)
 set(ASAN OFF)
 set(UBSAN OFF)
 
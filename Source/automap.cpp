@@ -7,6 +7,8 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <optional>
 
 #include <fmt/format.h>
 
@@ -14,6 +16,7 @@
 #include "engine/load_file.hpp"
 #include "engine/palette.h"
 #include "engine/render/automap_render.hpp"
+#include "engine/render/render_stats.hpp"
 #include "levels/gendung.h"
 #include "levels/setmaps.h"
 #include "player.h"
@@ -969,6 +972,15 @@ AutomapTile GetAutomapTypeView(Point map)
 	return GetAutomapTileType(map);
 }
 
+uint8_t GetAutomapLavaColor()
+{
+	if (leveltype == DTYPE_NEST)
+		return MapColorsAcid;
+	if (setlevel && setlvlnum == Quests[Q_PWATER]._qslvl)
+		return Quests[Q_PWATER]._qactive != QUEST_DONE ? MapColorsAcid : MapColorsWater;
+	return MapColorsLava;
+}
+
 /**
  * @brief Renders the given automap shape at the specified screen coordinates.
  */
@@ -1055,16 +1067,7 @@ void DrawAutomapTile(const Surface &out, Point center, Point map)
 		DrawWallConnections(out, center, tile, nwTile, neTile, colorBright, colorDim);
 	}
 
-	uint8_t lavaColor = MapColorsLava;
-	if (leveltype == DTYPE_NEST) {
-		lavaColor = MapColorsAcid;
-	} else if (setlevel && setlvlnum == Quests[Q_PWATER]._qslvl) {
-		if (Quests[Q_PWATER]._qactive != QUEST_DONE) {
-			lavaColor = MapColorsAcid;
-		} else {
-			lavaColor = MapColorsWater;
-		}
-	}
+	const uint8_t lavaColor = GetAutomapLavaColor();
 
 	switch (tile.type) {
 	case AutomapTile::Types::Diamond: // stand-alone column or other unpassable object
@@ -1247,6 +1250,199 @@ void DrawAutomapTile(const Surface &out, Point center, Point map)
 	}
 }
 
+/** @brief Marks the pixels of the automap layer that no tile has drawn to, the tiles never use this color. */
+constexpr uint8_t AutomapLayerTransparentColor = PAL16_GRAY + 15;
+/** @brief 8 pixels of `AutomapLayerTransparentColor`. */
+constexpr uint64_t AutomapLayerTransparentPixels = 0x0101010101010101 * uint64_t { AutomapLayerTransparentColor };
+
+/** @brief Larger layers are not kept, at 16 MiB the automap is cached up to a zoom of 175%. */
+constexpr size_t MaxAutomapLayerBytes = 16 * 1024 * 1024;
+
+/** @brief The cells that can draw something: the level and the edges around it. */
+constexpr int AutomapLayerMinCell = -2;
+constexpr int AutomapLayerMaxCell = DMAXX + 1;
+static_assert(DMAXX == DMAXY, "The automap layer assumes a square level");
+
+/**
+ * @brief The explored automap of the whole level, rendered at the current scale.
+ *
+ * `DrawAutomap` composites the visible part of it every frame instead of drawing every visible cell.
+ * The layer keeps a copy of the state its cells were drawn from and only redraws the area around the cells that
+ * changed, which also catches the changes to `AutomapView` made by loading a game or by other players.
+ * It is freed while the automap is closed and when the level changes, see `ReleaseAutomapLayer`.
+ */
+struct AutomapLayer {
+	std::optional<OwnedSurface> surface;
+	bool valid = false;
+	int scale;
+	/** @brief The distance between horizontally or vertically adjacent cells is twice this. */
+	Displacement cellOffset;
+	/** @brief How far the drawing of a cell can reach from its center. */
+	Displacement reach;
+	/** @brief The center of cell { 0, 0 } on the layer. */
+	Point origin;
+	uint8_t lavaColor;
+	uint8_t view[DMAXX][DMAXY];
+	uint8_t dungeon[DMAXX][DMAXY];
+
+	Point cellCenter(Point map) const
+	{
+		return origin + Displacement { (map.x - map.y) * cellOffset.deltaX, (map.x + map.y) * cellOffset.deltaY };
+	}
+};
+
+AutomapLayer Layer;
+
+/**
+ * @brief Clears the given area of the layer and redraws the cells that reach into it.
+ */
+void DrawAutomapLayerArea(AutomapLayer &layer, int left, int top, int right, int bottom)
+{
+	left = std::max(left, 0);
+	top = std::max(top, 0);
+	right = std::min(right, layer.surface->w());
+	bottom = std::min(bottom, layer.surface->h());
+	if (left >= right || top >= bottom)
+		return;
+
+	const Surface out = layer.surface->subregion(left, top, right - left, bottom - top);
+	for (int y = 0; y < out.h(); y++)
+		memset(out.at(0, y), AutomapLayerTransparentColor, out.w());
+
+	AutomapDrawingToLayer = true;
+	// In the same order as `DrawAutomap` used to draw them, so that the lines overlap the same way.
+	for (int sum = 2 * AutomapLayerMinCell; sum <= 2 * AutomapLayerMaxCell; sum++) {
+		const int centerY = layer.origin.y + sum * layer.cellOffset.deltaY;
+		if (centerY + layer.reach.deltaY < top || centerY - layer.reach.deltaY >= bottom)
+			continue;
+		for (int x = AutomapLayerMinCell; x <= AutomapLayerMaxCell; x++) {
+			const Point map { x, sum - x };
+			if (map.y < AutomapLayerMinCell || map.y > AutomapLayerMaxCell)
+				continue;
+			const Point center = layer.cellCenter(map);
+			if (center.x + layer.reach.deltaX < left || center.x - layer.reach.deltaX >= right)
+				continue;
+			DrawAutomapTile(out, center - Displacement { left, top }, map);
+		}
+	}
+	AutomapDrawingToLayer = false;
+}
+
+/**
+ * @brief Brings the automap layer up to date.
+ * @return false if the layer can't be used and the automap has to be drawn cell by cell.
+ */
+bool UpdateAutomapLayer(int scale)
+{
+#ifdef _DEBUG
+	// The lit tiles change all the time.
+	if (DebugVision)
+		return false;
+#endif
+
+	const Displacement cellOffset { AmOffset(AmWidthOffset::FullTileRight, AmHeightOffset::None).deltaX, AmOffset(AmWidthOffset::None, AmHeightOffset::FullTileDown).deltaY };
+	// The cells of the layer are laid out on a grid, the scales used by the game (multiples of 25%) are exact.
+	if (AmOffset(AmWidthOffset::DoubleTileRight, AmHeightOffset::None).deltaX != 2 * cellOffset.deltaX
+	    || AmOffset(AmWidthOffset::None, AmHeightOffset::DoubleTileDown).deltaY != 2 * cellOffset.deltaY) {
+		return false;
+	}
+
+	const int radius = AmLine(AmLineLength::OctupleTile);
+	// The pentagrams are the largest shapes, they reach twice their radius to the left, see `DrawMapEllipse`.
+	const Displacement reach { 2 * radius + 2, radius + 2 };
+	const int span = AutomapLayerMaxCell - AutomapLayerMinCell;
+	const Size size { 2 * span * cellOffset.deltaX + 2 * reach.deltaX + 1, 2 * span * cellOffset.deltaY + 2 * reach.deltaY + 1 };
+	if (static_cast<size_t>(size.width) * size.height > MaxAutomapLayerBytes) {
+		ReleaseAutomapLayer();
+		return false;
+	}
+
+	const uint8_t lavaColor = GetAutomapLavaColor();
+	if (!Layer.valid || Layer.scale != scale || Layer.lavaColor != lavaColor) {
+		if (!Layer.surface || Layer.surface->w() != size.width || Layer.surface->h() != size.height)
+			Layer.surface.emplace(size);
+		Layer.scale = scale;
+		Layer.cellOffset = cellOffset;
+		Layer.reach = reach;
+		Layer.origin = { span * cellOffset.deltaX + reach.deltaX, -2 * AutomapLayerMinCell * cellOffset.deltaY + reach.deltaY };
+		Layer.lavaColor = lavaColor;
+		memcpy(Layer.view, AutomapView, sizeof(Layer.view));
+		memcpy(Layer.dungeon, dungeon, sizeof(Layer.dungeon));
+		DrawAutomapLayerArea(Layer, 0, 0, size.width, size.height);
+		Layer.valid = true;
+		return true;
+	}
+
+	Point min { DMAXX, DMAXY };
+	Point max { -1, -1 };
+	for (int x = 0; x < DMAXX; x++) {
+		for (int y = 0; y < DMAXY; y++) {
+			if (Layer.view[x][y] == AutomapView[x][y] && Layer.dungeon[x][y] == dungeon[x][y])
+				continue;
+			min = { std::min(min.x, x), std::min(min.y, y) };
+			max = { std::max(max.x, x), std::max(max.y, y) };
+		}
+	}
+	if (max.x < 0)
+		return true;
+
+	memcpy(Layer.view, AutomapView, sizeof(Layer.view));
+	memcpy(Layer.dungeon, dungeon, sizeof(Layer.dungeon));
+
+	// A cell is drawn from the cells up to two cells away, see `GetAutomapTypeView` and `GetAutomapTileType`.
+	min -= Displacement { 2, 2 };
+	max += Displacement { 2, 2 };
+	const Point topLeft = Layer.cellCenter({ min.x, max.y });
+	const Point bottomRight = Layer.cellCenter({ max.x, min.y });
+	DrawAutomapLayerArea(Layer, topLeft.x - reach.deltaX, Layer.cellCenter(min).y - reach.deltaY,
+	    bottomRight.x + reach.deltaX + 1, Layer.cellCenter(max).y + reach.deltaY + 1);
+	return true;
+}
+
+/**
+ * @brief Composites the automap layer onto the output buffer.
+ * @param cellZero The position of the center of cell { 0, 0 } on the output buffer.
+ */
+void DrawAutomapLayer(const Surface &out, Point cellZero)
+{
+	const Displacement offset = cellZero - Layer.origin;
+	int left = std::max(0, offset.deltaX);
+	int top = std::max(0, offset.deltaY);
+	int right = std::min(out.w(), offset.deltaX + Layer.surface->w());
+	int bottom = std::min(out.h(), offset.deltaY + Layer.surface->h());
+	if (GetAutomapType() == AutomapType::Minimap) {
+		left = std::max(left, MinimapRect.position.x);
+		top = std::max(top, MinimapRect.position.y);
+		right = std::min(right, MinimapRect.position.x + MinimapRect.size.width);
+		bottom = std::min(bottom, MinimapRect.position.y + MinimapRect.size.height);
+	}
+	if (left >= right || top >= bottom)
+		return;
+
+	const bool transparent = GetAutomapType() == AutomapType::Transparent;
+	const int width = right - left;
+	for (int y = top; y < bottom; y++) {
+		const uint8_t *src = Layer.surface->at(left - offset.deltaX, y - offset.deltaY);
+		uint8_t *dst = out.at(left, y);
+		int x = 0;
+		// Most of the layer is empty, skip it 8 pixels at a time.
+		for (; x + 8 <= width; x += 8) {
+			uint64_t pixels;
+			memcpy(&pixels, &src[x], sizeof(pixels));
+			if (pixels == AutomapLayerTransparentPixels)
+				continue;
+			for (int i = x; i < x + 8; i++) {
+				if (src[i] != AutomapLayerTransparentColor)
+					dst[i] = transparent ? paletteTransparencyLookup[src[i]][dst[i]] : src[i];
+			}
+		}
+		for (; x < width; x++) {
+			if (src[x] != AutomapLayerTransparentColor)
+				dst[x] = transparent ? paletteTransparencyLookup[src[x]][dst[x]] : src[x];
+		}
+	}
+}
+
 Displacement GetAutomapScreen()
 {
 	Displacement screen = {};
@@ -1673,12 +1869,19 @@ void InitAutomap()
 	}
 
 	memset(AutomapView, 0, sizeof(AutomapView));
+	ReleaseAutomapLayer();
 
 	for (auto &column : dFlags)
 		for (auto &dFlag : column)
 			dFlag &= ~DungeonFlag::Explored;
 }
 
+void ReleaseAutomapLayer()
+{
+	Layer.valid = false;
+	Layer.surface = std::nullopt;
+}
+
 void StartAutomap()
 {
 	AutomapOffset = { 0, 0 };
@@ -1731,6 +1934,8 @@ void AutomapZoomOut()
 
 void DrawAutomap(const Surface &out)
 {
+	const RenderStatsScope renderStats { RenderStatsCategory::Automap };
+
 	Automap = { (ViewPosition.x - 8) / 2, (ViewPosition.y - 8) / 2 };
 	if (leveltype != DTYPE_TOWN) {
 		Automap += { -4, -4 };
@@ -1816,21 +2021,27 @@ void DrawAutomap(const Surface &out)
 
 	Point map = { Automap.x - cells, Automap.y - 1 };
 
-	for (int i = 0; i <= cells + 1; i++) {
-		Point tile1 = screen;
-		for (int j = 0; j < cells; j++) {
-			DrawAutomapTile(out, tile1, { map.x + j, map.y - j });
-			tile1.x += AmOffset(AmWidthOffset::DoubleTileRight, AmHeightOffset::None).deltaX;
-		}
-		map.y++;
+	if (UpdateAutomapLayer(scale)) {
+		// `screen` is the center of `map`, the layer needs the position of cell { 0, 0 }.
+		const Displacement cellOffset = Layer.cellOffset;
+		DrawAutomapLayer(out, screen - Displacement { (map.x - map.y) * cellOffset.deltaX, (map.x + map.y) * cellOffset.deltaY });
+	} else {
+		for (int i = 0; i <= cells + 1; i++) {
+			Point tile1 = screen;
+			for (int j = 0; j < cells; j++) {
+				DrawAutomapTile(out, tile1, { map.x + j, map.y - j });
+				tile1.x += AmOffset(AmWidthOffset::DoubleTileRight, AmHeightOffset::None).deltaX;
+			}
+			map.y++;
 
-		Point tile2 = screen + AmOffset(AmWidthOffset::FullTileLeft, AmHeightOffset::FullTileDown);
-		for (int j = 0; j <= cells; j++) {
-			DrawAutomapTile(out, tile2, { map.x + j, map.y - j });
-			tile2.x += AmOffset(AmWidthOffset::DoubleTileRight, AmHeightOffset::None).deltaX;
+			Point tile2 = screen + AmOffset(AmWidthOffset::FullTileLeft, AmHeightOffset::FullTileDown);
+			for (int j = 0; j <= cells; j++) {
+				DrawAutomapTile(out, tile2, { map.x + j, map.y - j });
+				tile2.x += AmOffset(AmWidthOffset::DoubleTileRight, AmHeightOffset::None).deltaX;
+			}
+			map.x++;
+			screen.y += AmOffset(AmWidthOffset::None, AmHeightOffset::DoubleTileDown).deltaY;
 		}
-		map.x++;
-		screen.y += AmOffset(AmWidthOffset::None, AmHeightOffset::DoubleTileDown).deltaY;
 	}
 
 	for (const Player &player : Players) {
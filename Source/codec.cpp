@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <cstring>
 
+#include "codec.h"
+
 #include "appfat.h"
 #include "sha.h"
 #include "utils/endian.hpp"
@@ -18,7 +20,8 @@ struct CodecSignature {
 };
 
 constexpr size_t BlockSizeBytes = BlockSize * sizeof(uint32_t);
-constexpr size_t SignatureSize = 8;
+constexpr size_t SignatureSize = CodecSignatureSize;
+static_assert(BlockSizeBytes == CodecChunkSize);
 
 SHA1Context CodecInitKey(const char *pszPassword)
 {
@@ -52,7 +55,7 @@ SHA1Context CodecInitKey(const char *pszPassword)
 	return context;
 }
 
-CodecSignature GetCodecSignature(std::byte *src)
+CodecSignature GetCodecSignature(const std::byte *src)
 {
 	CodecSignature result;
 	result.checksum = LoadLE32(src);
@@ -90,40 +93,71 @@ void XorBlock(const uint32_t *shaResult, uint32_t *out)
 
 std::size_t codec_decode(std::byte *pbSrcDst, std::size_t size, const char *pszPassword)
 {
-	uint32_t buf[BlockSize];
-	uint32_t dst[SHA1HashSize];
-
-	SHA1Context context = CodecInitKey(pszPassword);
+	CodecDecoder decoder(pszPassword);
 	if (size <= SignatureSize)
 		return 0;
 	size -= SignatureSize;
 	if (size % BlockSize != 0)
 		return 0;
 	for (size_t i = 0; i < size; pbSrcDst += BlockSizeBytes, i += BlockSizeBytes) {
-		memcpy(buf, pbSrcDst, BlockSizeBytes);
-		ByteSwapBlock(buf);
-		SHA1Result(context, dst);
-		XorBlock(dst, buf);
-		SHA1Calculate(context, buf);
-		ByteSwapBlock(buf);
-		memcpy(pbSrcDst, buf, BlockSizeBytes);
+		decoder.DecodeChunk(pbSrcDst);
 	}
 
-	memset(buf, 0, sizeof(buf));
-	const CodecSignature sig = GetCodecSignature(pbSrcDst);
-	if (sig.error > 0) {
+	if (!decoder.Verify(pbSrcDst))
 		return 0;
+
+	size += GetCodecSignature(pbSrcDst).lastChunkSize - BlockSizeBytes;
+	return size;
+}
+
+CodecDecoder::CodecDecoder(const char *password)
+    : context_(std::make_unique<SHA1Context>(CodecInitKey(password)))
+{
+}
+
+CodecDecoder::~CodecDecoder() = default;
+
+std::size_t CodecDecoder::DecodedSize(std::size_t encodedSize, const std::byte *signature)
+{
+	if (encodedSize <= SignatureSize)
+		return 0;
+	encodedSize -= SignatureSize;
+	if (encodedSize % BlockSizeBytes != 0)
+		return 0;
+	const CodecSignature sig = GetCodecSignature(signature);
+	if (sig.error > 0 || sig.lastChunkSize == 0 || sig.lastChunkSize > BlockSizeBytes)
+		return 0;
+	return encodedSize + sig.lastChunkSize - BlockSizeBytes;
+}
+
+void CodecDecoder::DecodeChunk(std::byte *chunk)
+{
+	uint32_t buf[BlockSize];
+	uint32_t dst[SHA1HashSize];
+
+	memcpy(buf, chunk, BlockSizeBytes);
+	ByteSwapBlock(buf);
+	SHA1Result(*context_, dst);
+	XorBlock(dst, buf);
+	SHA1Calculate(*context_, buf);
+	ByteSwapBlock(buf);
+	memcpy(chunk, buf, BlockSizeBytes);
+}
+
+bool CodecDecoder::Verify(const std::byte *signature)
+{
+	const CodecSignature sig = GetCodecSignature(signature);
+	if (sig.error > 0) {
+		return false;
 	}
 
-	SHA1Result(context, dst);
+	uint32_t dst[SHA1HashSize];
+	SHA1Result(*context_, dst);
 	if (sig.checksum != dst[0]) {
 		LogError("Checksum mismatch signature={} vs calculated={}", sig.checksum, dst[0]);
-		memset(dst, 0, sizeof(dst));
-		return 0;
+		return false;
 	}
-
-	size += sig.lastChunkSize - BlockSizeBytes;
-	return size;
+	return true;
 }
 
 std::size_t codec_get_encoded_len(std::size_t dwSrcBytes)
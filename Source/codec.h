@@ -6,11 +6,46 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 
 namespace devilution {
 
+struct SHA1Context;
+
+/** @brief The data is encoded in chunks of this many bytes. */
+constexpr std::size_t CodecChunkSize = 64;
+/** @brief Size of the signature that follows the encoded chunks. */
+constexpr std::size_t CodecSignatureSize = 8;
+
 std::size_t codec_decode(std::byte *pbSrcDst, std::size_t size, const char *pszPassword);
 std::size_t codec_get_encoded_len(std::size_t dwSrcBytes);
 void codec_encode(std::byte *pbSrcDst, std::size_t size, std::size_t size_64, const char *pszPassword);
 
+/**
+ * @brief Decodes the output of `codec_encode` one chunk at a time.
+ *
+ * Unlike `codec_decode`, the checksum can only be verified once all the chunks have been decoded.
+ */
+class CodecDecoder {
+public:
+	explicit CodecDecoder(const char *password);
+	~CodecDecoder();
+
+	/**
+	 * @brief Returns the decoded size of the encoded data, or 0 if it is invalid.
+	 *
+	 * @param signature The last `CodecSignatureSize` bytes of the encoded data.
+	 */
+	static std::size_t DecodedSize(std::size_t encodedSize, const std::byte *signature);
+
+	/** @brief Decodes the next `CodecChunkSize` bytes in place. */
+	void DecodeChunk(std::byte *chunk);
+
+	/** @brief Checks the signature once all the chunks have been decoded. */
+	bool Verify(const std::byte *signature);
+
+private:
+	std::unique_ptr<SHA1Context> context_;
+};
+
 } // namespace devilution
@@ -28,6 +28,7 @@
 #include "discord/discord.h"
 #include "doom.h"
 #include "encrypt.h"
+#include "engine/assets.hpp"
 #include "engine/backbuffer_state.hpp"
 #include "engine/clx_sprite.hpp"
 #include "engine/demomode.h"
@@ -36,6 +37,8 @@
 #include "engine/load_cel.hpp"
 #include "engine/load_file.hpp"
 #include "engine/random.hpp"
+#include "engine/render/prelit_tile_cache.hpp"
+#include "engine/render/render_stats.hpp"
 #include "engine/sound.h"
 #include "gamemenu.h"
 #include "gmenu.h"
@@ -90,6 +93,7 @@
 #include "utils/paths.h"
 #include "utils/screen_reader.hpp"
 #include "utils/str_cat.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/utf8.hpp"
 
 #ifndef USE_SDL1
@@ -1163,6 +1167,7 @@ void ApplicationInit()
 {
 	if (*sgOptions.Graphics.showFPS)
 		EnableFrameCount();
+	SetRenderStatsEnabled(*sgOptions.Graphics.showRenderStats);
 
 	init_create_window();
 	was_window_init = true;
@@ -1268,6 +1273,7 @@ void DiabloDeinit()
 	if (was_window_init)
 		dx_cleanup(); // Cleanup SDL surfaces stuff, so we have to do it before SDL_Quit().
 	UnloadFonts();
+	ShutDownWorkerThreadPool();
 	if (SDL_WasInit(SDL_INIT_EVERYTHING & ~SDL_INIT_HAPTIC) != 0)
 		SDL_Quit();
 }
@@ -1321,6 +1327,7 @@ void LoadLvlGFX()
 	default:
 		app_fatal("LoadLvlGFX");
 	}
+	InvalidatePreLitTiles();
 }
 
 void LoadAllGFX()
@@ -2847,6 +2854,9 @@ void DisableInputEventHandler(const SDL_Event &event, uint16_t modState)
 
 void LoadGameLevel(bool firstflag, lvl_entry lvldir)
 {
+	if (IsAssetStatsEnabled())
+		SetAssetStatsPhase(setlevel ? StrCat("setlevel ", static_cast<int>(setlvlnum)) : StrCat("level ", static_cast<int>(currlevel)));
+
 	_music_id neededTrack = GetLevelMusic(leveltype);
 	ClearFloatingNumbers();
 
@@ -2916,6 +2926,8 @@ void LoadGameLevel(bool firstflag, lvl_entry lvldir)
 
 		if (leveltype != DTYPE_TOWN) {
 			GetLevelMTypes();
+			// Read the monster graphics while the rest of the level is set up.
+			PrefetchMonsterGFX();
 			InitThemes();
 			if (!HeadlessMode)
 				LoadAllGFX();
@@ -3026,6 +3038,7 @@ void LoadGameLevel(bool firstflag, lvl_entry lvldir)
 		LoadSetMap();
 		IncProgress();
 		GetLevelMTypes();
+		PrefetchMonsterGFX();
 		IncProgress();
 		InitGolems();
 		InitMonsters();
@@ -3099,6 +3112,7 @@ void LoadGameLevel(bool firstflag, lvl_entry lvldir)
 	if (leveltype != DTYPE_TOWN) {
 		memcpy(dLight, dPreLight, sizeof(dLight));                                     // resets the light on entering a level to get rid of incorrect light
 		ChangeLightXY(Players[MyPlayerId].lightId, Players[MyPlayerId].position.tile); // forces player light refresh
+		UpdateLighting = true;
 		ProcessLightList();
 		ProcessVisionList();
 	}
@@ -3124,6 +3138,7 @@ void LoadGameLevel(bool firstflag, lvl_entry lvldir)
 	}
 
 	CompleteProgress();
+	ClearPrefetchedAssets();
 
 	// Recalculate mouse selection of entities after level change/load
 	LastMouseButtonAction = MouseActionType::None;
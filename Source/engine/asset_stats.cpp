@@ -0,0 +1,145 @@
+#include "engine/asset_stats.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "utils/logged_fstream.hpp"
+#include "utils/sdl_mutex.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+std::atomic<bool> AssetStatsEnabled;
+
+namespace {
+
+struct AssetStatsRecord {
+	/** @brief Index into `Phases`. */
+	uint32_t phase;
+	std::string path;
+	std::string_view source;
+	uint32_t lookupMicroseconds;
+	uint32_t reads;
+	uint64_t bytes;
+	/** @brief Includes the decompression of MPQ files. */
+	uint64_t readMicroseconds;
+};
+
+/** @brief Guards `Records` and `Phases`, assets are also read on the worker threads. */
+SdlMutex AssetStatsMutex;
+std::vector<AssetStatsRecord> Records;
+std::vector<std::string> Phases { "startup" };
+
+uint32_t ToMicroseconds(std::chrono::steady_clock::duration duration)
+{
+	const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+	return static_cast<uint32_t>(std::clamp<decltype(microseconds)>(microseconds, 0, UINT32_MAX));
+}
+
+/** @brief Returns the directory of the asset, which tells which part of the game loads it, e.g. "monsters" or "sfx". */
+std::string_view GetAssetDirectory(std::string_view path)
+{
+	const size_t end = path.find_first_of("\\/");
+	return end == std::string_view::npos ? std::string_view {} : path.substr(0, end);
+}
+
+/** @brief Quotes a CSV field if needed. */
+void AppendCsvField(std::string &csv, std::string_view field)
+{
+	if (field.find_first_of(",\"\n") == std::string_view::npos) {
+		csv.append(field);
+		return;
+	}
+	csv += '"';
+	for (const char c : field) {
+		if (c == '"')
+			csv += '"';
+		csv += c;
+	}
+	csv += '"';
+}
+
+} // namespace
+
+void SetAssetStatsEnabled(bool enabled)
+{
+	if (enabled && !IsAssetStatsEnabled()) {
+		std::lock_guard<SdlMutex> lock(AssetStatsMutex);
+		Records.clear();
+		Phases.erase(Phases.begin(), Phases.end() - 1);
+	}
+	AssetStatsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SetAssetStatsPhase(std::string_view phase)
+{
+	std::lock_guard<SdlMutex> lock(AssetStatsMutex);
+	if (Records.empty() || Records.back().phase != Phases.size() - 1)
+		Phases.back() = phase;
+	else
+		Phases.emplace_back(phase);
+}
+
+uint32_t RecordAssetLookup(std::string_view path, std::string_view source, std::chrono::steady_clock::duration elapsed)
+{
+	std::lock_guard<SdlMutex> lock(AssetStatsMutex);
+	if (Records.size() >= MaxAssetStatsRecords)
+		return NoAssetStatsRecord;
+	Records.push_back(AssetStatsRecord {
+	    static_cast<uint32_t>(Phases.size() - 1),
+	    std::string(path),
+	    source,
+	    ToMicroseconds(elapsed),
+	    /*reads=*/0,
+	    /*bytes=*/0,
+	    /*readMicroseconds=*/0,
+	});
+	return static_cast<uint32_t>(Records.size() - 1);
+}
+
+void RecordAssetRead(uint32_t record, size_t bytes, std::chrono::steady_clock::duration elapsed)
+{
+	std::lock_guard<SdlMutex> lock(AssetStatsMutex);
+	// The records may have been cleared by restarting the collection while the asset was open.
+	if (record >= Records.size())
+		return;
+	AssetStatsRecord &stats = Records[record];
+	++stats.reads;
+	stats.bytes += bytes;
+	stats.readMicroseconds += ToMicroseconds(elapsed);
+}
+
+size_t GetAssetStatsRecordCount()
+{
+	std::lock_guard<SdlMutex> lock(AssetStatsMutex);
+	return Records.size();
+}
+
+std::string FormatAssetStatsCsv()
+{
+	std::lock_guard<SdlMutex> lock(AssetStatsMutex);
+	std::string csv = "phase,path,directory,source,lookup_us,reads,bytes,read_us\n";
+	for (const AssetStatsRecord &record : Records) {
+		AppendCsvField(csv, Phases[record.phase]);
+		csv += ',';
+		AppendCsvField(csv, record.path);
+		csv += ',';
+		AppendCsvField(csv, GetAssetDirectory(record.path));
+		StrAppend(csv, ",", record.source, ",", record.lookupMicroseconds, ",", record.reads, ",", record.bytes, ",", record.readMicroseconds, "\n");
+	}
+	return csv;
+}
+
+bool ExportAssetStatsCsv(const std::string &path)
+{
+	const std::string csv = FormatAssetStatsCsv();
+	LoggedFStream out;
+	if (!out.Open(path.c_str(), "wb"))
+		return false;
+	const bool ok = out.Write(csv.data(), csv.size());
+	out.Close();
+	return ok;
+}
+
+} // namespace devilution
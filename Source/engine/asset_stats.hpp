@@ -0,0 +1,88 @@
+/**
+ * @file asset_stats.hpp
+ *
+ * Runtime asset loading profiling: which assets are looked up and read, where they come from and how long it takes.
+ *
+ * Collection is off by default and costs a single branch per lookup and read when off.
+ * It is toggled with `assets.stats()` in Lua, and `assets.exportStats()` writes the records as CSV.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace devilution {
+
+/** @brief Toggled on the main thread and read by the threads that load assets. */
+extern std::atomic<bool> AssetStatsEnabled;
+
+inline bool IsAssetStatsEnabled()
+{
+	return AssetStatsEnabled.load(std::memory_order_relaxed);
+}
+
+/** @brief Marks an asset lookup or handle that is not being profiled. */
+constexpr uint32_t NoAssetStatsRecord = UINT32_MAX;
+
+/** @brief Recording stops once there are this many records, to bound memory usage. */
+constexpr size_t MaxAssetStatsRecords = 1 << 16;
+
+/** @brief Starts or stops collecting asset stats. Starting clears the records. */
+void SetAssetStatsEnabled(bool enabled);
+
+/**
+ * @brief Labels the records that follow, e.g. with the level being loaded.
+ *
+ * Lets the records of each level load be told apart in the export.
+ */
+void SetAssetStatsPhase(std::string_view phase);
+
+/**
+ * @brief Records an asset lookup, only call this when `IsAssetStatsEnabled()`.
+ *
+ * @param source Where the asset was found, e.g. the name of an MPQ archive. Must be a string literal.
+ * @return The record that reads of the asset are added to, or `NoAssetStatsRecord` if the records are full.
+ */
+uint32_t RecordAssetLookup(std::string_view path, std::string_view source, std::chrono::steady_clock::duration elapsed);
+
+/** @brief Adds a read to a record. Thread-safe. */
+void RecordAssetRead(uint32_t record, size_t bytes, std::chrono::steady_clock::duration elapsed);
+
+/** @brief Adds the time spent in its lifetime to a record as a read of `bytes` bytes. */
+class AssetReadStatsScope {
+public:
+	AssetReadStatsScope(uint32_t record, size_t bytes)
+	    : record_(record)
+	    , bytes_(bytes)
+	{
+		if (record_ != NoAssetStatsRecord)
+			start_ = std::chrono::steady_clock::now();
+	}
+
+	AssetReadStatsScope(const AssetReadStatsScope &) = delete;
+	AssetReadStatsScope &operator=(const AssetReadStatsScope &) = delete;
+
+	~AssetReadStatsScope()
+	{
+		if (record_ != NoAssetStatsRecord)
+			RecordAssetRead(record_, bytes_, std::chrono::steady_clock::now() - start_);
+	}
+
+private:
+	uint32_t record_;
+	size_t bytes_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+size_t GetAssetStatsRecordCount();
+
+/** @brief Formats the records as CSV, one asset lookup per row, in order. */
+std::string FormatAssetStatsCsv();
+
+bool ExportAssetStatsCsv(const std::string &path);
+
+} // namespace devilution
@@ -1,6 +1,7 @@
 #include "engine/assets.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <string_view>
@@ -12,7 +13,19 @@
 #include "utils/str_cat.hpp"
 
 #ifndef UNPACKED_MPQS
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "engine/clx_cache.hpp"
 #include "mpq/mpq_sdl_rwops.hpp"
+#include "utils/sdl_cond.h"
+#include "utils/sdl_mutex.h"
+#include "utils/stdcompat/filesystem.hpp"
+#include "utils/str_case.hpp"
+#include "utils/thread_pool.hpp"
 #endif
 
 namespace devilution {
@@ -53,9 +66,164 @@ SDL_RWops *OpenOptionalRWops(const std::string &path)
 	return SDL_RWFromFile(path.c_str(), "rb");
 };
 
+/** @brief Where a file lives in the loaded MPQ archives, see `RebuildAssetIndex`. */
+struct MpqFileLocation {
+	/** The highest-priority archive that has the file, including the Hellfire ones. */
+	MpqArchive *archive = nullptr;
+	uint32_t fileNumber;
+
+	/** The highest-priority archive that has the file, excluding the Hellfire ones. */
+	MpqArchive *nonHellfireArchive = nullptr;
+	uint32_t nonHellfireFileNumber;
+};
+
+/** @brief All the files of all the loaded MPQs, keyed by `hashA << 32 | hashB`. */
+std::unordered_map<uint64_t, MpqFileLocation> MpqFileIndex;
+
+/** @brief False if some archive could not be indexed, in which case we probe the archives one by one. */
+bool MpqFileIndexValid;
+
+/** @brief Lower-case paths relative to `PrefPath()` of all the files in it, with `/` separators. */
+std::unordered_set<std::string> PrefPathFileIndex;
+bool PrefPathFileIndexValid;
+
+uint64_t MpqFileIndexKey(uint32_t hashA, uint32_t hashB)
+{
+	return (static_cast<uint64_t>(hashA) << 32) | hashB;
+}
+
+/** @brief Set once `MpqArchivesChecksum` has been computed for the currently loaded archives. */
+bool MpqArchivesChecksumValid;
+uint64_t MpqArchivesChecksum;
+
+struct IndexedArchive {
+	std::optional<MpqArchive> *archive;
+	bool isHellfire;
+	std::string_view name;
+};
+
+std::array<IndexedArchive, 11> GetIndexedArchives()
+{
+	// Must be kept in sync with the priority order of `FindMpqFile`.
+	return { {
+	    { &font_mpq, false, "fonts" },
+	    { &lang_mpq, false, "lang" },
+	    { &devilutionx_mpq, false, "devilutionx" },
+	    { &hfvoice_mpq, true, "hfvoice" },
+	    { &hfmusic_mpq, true, "hfmusic" },
+	    { &hfbarb_mpq, true, "hfbarb" },
+	    { &hfbard_mpq, true, "hfbard" },
+	    { &hfmonk_mpq, true, "hfmonk" },
+	    { &hellfire_mpq, true, "hellfire" },
+	    { &spawn_mpq, false, "spawn" },
+	    { &diabdat_mpq, false, "diabdat" },
+	} };
+}
+
+void IndexMpqArchives()
+{
+	MpqFileIndex.clear();
+	MpqFileIndexValid = true;
+	MpqArchivesChecksumValid = false;
+
+	for (const IndexedArchive &indexed : GetIndexedArchives()) {
+		if (!*indexed.archive)
+			continue;
+		MpqArchive &archive = **indexed.archive;
+		const bool ok = archive.ForEachFile([&](uint32_t hashA, uint32_t hashB, uint32_t fileNumber) {
+			MpqFileLocation &location = MpqFileIndex[MpqFileIndexKey(hashA, hashB)];
+			if (location.archive == nullptr) {
+				location.archive = &archive;
+				location.fileNumber = fileNumber;
+			}
+			if (!indexed.isHellfire && location.nonHellfireArchive == nullptr) {
+				location.nonHellfireArchive = &archive;
+				location.nonHellfireFileNumber = fileNumber;
+			}
+		});
+		if (!ok) {
+			LogWarn("Failed to index MPQ archive, falling back to per-archive lookups");
+			MpqFileIndex.clear();
+			MpqFileIndexValid = false;
+			return;
+		}
+	}
+	LogVerbose("Indexed {} MPQ files", static_cast<unsigned>(MpqFileIndex.size()));
+}
+
+void IndexPrefPathFiles()
+{
+	PrefPathFileIndex.clear();
+	PrefPathFileIndexValid = false;
+#ifdef DVL_HAS_FILESYSTEM
+	const std::filesystem::path root = std::filesystem::u8path(paths::PrefPath());
+	std::error_code error;
+	if (!std::filesystem::is_directory(root, error)) {
+		PrefPathFileIndexValid = true;
+		return;
+	}
+	std::filesystem::recursive_directory_iterator it { root, error };
+	for (; !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+		if (it->is_directory(error)) {
+			// The converted sprites cannot override MPQ contents.
+			if (it.depth() == 0 && it->path().filename() == ClxCacheDirectory)
+				it.disable_recursion_pending();
+			continue;
+		}
+		const auto utf8Path = it->path().lexically_relative(root).generic_u8string();
+		std::string relativePath { utf8Path.begin(), utf8Path.end() };
+		AsciiStrToLower(relativePath);
+		PrefPathFileIndex.insert(std::move(relativePath));
+	}
+	if (error) {
+		LogVerbose("Failed to index {}: {}", paths::PrefPath(), error.message());
+		PrefPathFileIndex.clear();
+		return;
+	}
+	PrefPathFileIndexValid = true;
+#endif
+}
+
+/**
+ * @brief Returns false if `relativePath` is definitely not in the `PrefPath()` directory.
+ *
+ * Only knows about the files that were there at the last `RebuildAssetIndex`.
+ */
+bool MayExistInPrefPath(std::string_view relativePath)
+{
+	if (!PrefPathFileIndexValid)
+		return true;
+	std::string key = AsciiStrToLower(relativePath);
+	std::replace(key.begin(), key.end(), '\\', '/');
+	return PrefPathFileIndex.count(key) != 0;
+}
+
+/** @brief Where an asset was found, for `asset_stats.hpp`. */
+std::string_view GetAssetSource(const AssetRef &ref)
+{
+	if (ref.archive != nullptr) {
+		for (const IndexedArchive &indexed : GetIndexedArchives()) {
+			if (*indexed.archive && &**indexed.archive == ref.archive)
+				return indexed.name;
+		}
+		return "mpq";
+	}
+	return ref.directHandle != nullptr ? "file" : "missing";
+}
+
 bool FindMpqFile(std::string_view filename, MpqArchive **archive, uint32_t *fileNumber)
 {
 	const MpqFileHash fileHash = CalculateMpqFileHash(filename);
+	if (MpqFileIndexValid) {
+		const auto it = MpqFileIndex.find(MpqFileIndexKey(fileHash[1], fileHash[2]));
+		if (it == MpqFileIndex.end())
+			return false;
+		const MpqFileLocation &location = it->second;
+		*archive = gbIsHellfire ? location.archive : location.nonHellfireArchive;
+		*fileNumber = gbIsHellfire ? location.fileNumber : location.nonHellfireFileNumber;
+		return *archive != nullptr;
+	}
+
 	const auto at = [=](std::optional<MpqArchive> &src) -> bool {
 		if (src && src->GetFileNumber(fileHash, *fileNumber)) {
 			*archive = &(*src);
@@ -67,12 +235,100 @@ bool FindMpqFile(std::string_view filename, MpqArchive **archive, uint32_t *file
 	return at(font_mpq) || at(lang_mpq) || at(devilutionx_mpq)
 	    || (gbIsHellfire && (at(hfvoice_mpq) || at(hfmusic_mpq) || at(hfbarb_mpq) || at(hfbard_mpq) || at(hfmonk_mpq) || at(hellfire_mpq))) || at(spawn_mpq) || at(diabdat_mpq);
 }
+
+/** @brief An asset being read in the background, see `PrefetchAssets`. */
+struct PrefetchedAsset {
+	enum class State : uint8_t {
+		Queued,
+		Loading,
+		Done,
+	};
+
+	State state = State::Queued;
+
+	/** The file contents, or `nullptr` if it could not be read. */
+	std::unique_ptr<char[]> data;
+	size_t size = 0;
+};
+
+/** @brief Guards `PrefetchedAssets` and the `state` of its entries. */
+SdlMutex PrefetchMutex;
+SdlCond PrefetchDone;
+std::unordered_map<std::string, std::shared_ptr<PrefetchedAsset>> PrefetchedAssets;
+
+AssetRef FindAssetUncached(std::string_view filename);
+
+void LoadPrefetchedAsset(PrefetchedAsset &asset, std::string_view filename)
+{
+	AssetRef ref = FindAssetUncached(filename);
+	if (!ref.ok())
+		return;
+	const size_t size = ref.size();
+	if (size == 0)
+		return;
+	std::unique_ptr<char[]> data { new char[size] };
+	AssetHandle handle = OpenAsset(std::move(ref), /*threadsafe=*/true);
+	if (!handle.ok() || !handle.read(data.get(), size))
+		return;
+	asset.data = std::move(data);
+	asset.size = size;
+}
+
+int CloseOwnedMemRWops(SDL_RWops *context)
+{
+	delete[] reinterpret_cast<char *>(context->hidden.mem.base);
+	SDL_FreeRW(context);
+	return 0;
+}
+
+/**
+ * @brief Hands over a prefetched asset to the caller.
+ *
+ * Waits for the asset if it is still being read, or reads it right away if no worker has picked it up yet.
+ *
+ * @return An in-memory handle that owns the data, or `nullptr` if `filename` was not prefetched.
+ */
+SDL_RWops *TakePrefetchedAsset(std::string_view filename)
+{
+	std::shared_ptr<PrefetchedAsset> asset;
+	bool loadNow = false;
+	{
+		std::lock_guard<SdlMutex> lock(PrefetchMutex);
+		if (PrefetchedAssets.empty())
+			return nullptr;
+		const auto it = PrefetchedAssets.find(std::string(filename));
+		if (it == PrefetchedAssets.end())
+			return nullptr;
+		asset = std::move(it->second);
+		PrefetchedAssets.erase(it);
+		if (asset->state == PrefetchedAsset::State::Queued) {
+			asset->state = PrefetchedAsset::State::Loading;
+			loadNow = true;
+		} else {
+			PrefetchDone.wait(PrefetchMutex, [&]() { return asset->state == PrefetchedAsset::State::Done; });
+		}
+	}
+	if (loadNow)
+		LoadPrefetchedAsset(*asset, filename);
+	if (asset->data == nullptr)
+		return nullptr;
+
+	SDL_RWops *rwops = SDL_RWFromConstMem(asset->data.get(), static_cast<int>(asset->size));
+	if (rwops == nullptr)
+		return nullptr;
+	// The handle now owns the data and frees it on close.
+	asset->data.release();
+	rwops->close = &CloseOwnedMemRWops;
+	return rwops;
+}
 #endif
 
 } // namespace
 
 #ifdef UNPACKED_MPQS
-AssetRef FindAsset(std::string_view filename)
+namespace {
+
+AssetRef FindAssetUnprofiled(std::string_view filename)
 {
 	AssetRef result;
 	if (filename.empty() || filename.back() == '\\')
@@ -111,8 +367,30 @@ AssetRef FindAsset(std::string_view filename)
 	}
 	return result;
 }
-#else
+
+} // namespace
+
 AssetRef FindAsset(std::string_view filename)
+{
+	if (!IsAssetStatsEnabled())
+		return FindAssetUnprofiled(filename);
+	const auto start = std::chrono::steady_clock::now();
+	AssetRef result = FindAssetUnprofiled(filename);
+	result.statsRecord = RecordAssetLookup(filename, result.ok() ? "file" : "missing", std::chrono::steady_clock::now() - start);
+	return result;
+}
+
+void PrefetchAssets(const std::vector<std::string> & /*paths*/)
+{
+}
+
+void ClearPrefetchedAssets()
+{
+}
+#else
+namespace {
+
+AssetRef FindAssetUncached(std::string_view filename)
 {
 	AssetRef result;
 	if (filename.empty() || filename.back() == '\\')
@@ -131,7 +409,7 @@ AssetRef FindAsset(std::string_view filename)
 	}
 
 	// Files in the `PrefPath()` directory can override MPQ contents.
-	{
+	if (MayExistInPrefPath(relativePath)) {
 		const std::string path = paths::PrefPath() + relativePath;
 		result.directHandle = OpenOptionalRWops(path);
 		if (result.directHandle != nullptr) {
@@ -163,23 +441,138 @@ AssetRef FindAsset(std::string_view filename)
 
 	return result;
 }
+
+} // namespace
+
+AssetRef FindAsset(std::string_view filename)
+{
+	const bool profile = IsAssetStatsEnabled();
+	const std::chrono::steady_clock::time_point start = profile ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point {};
+	AssetRef result;
+	result.directHandle = TakePrefetchedAsset(filename);
+	std::string_view source = "prefetch";
+	if (result.directHandle == nullptr) {
+		result = FindAssetUncached(filename);
+		source = GetAssetSource(result);
+	}
+	if (profile)
+		result.statsRecord = RecordAssetLookup(filename, source, std::chrono::steady_clock::now() - start);
+	return result;
+}
+
+void PrefetchAssets(const std::vector<std::string> &paths)
+{
+	ThreadPool &pool = GetWorkerThreadPool();
+	// Without workers, nothing would ever pick up the queued reads.
+	if (pool.numWorkers() == 0)
+		return;
+	std::lock_guard<SdlMutex> lock(PrefetchMutex);
+	for (const std::string &path : paths) {
+		auto [it, inserted] = PrefetchedAssets.try_emplace(path, nullptr);
+		if (!inserted)
+			continue;
+		it->second = std::make_shared<PrefetchedAsset>();
+		pool.submit([asset = it->second, path]() {
+			{
+				std::lock_guard<SdlMutex> lock(PrefetchMutex);
+				// Cleared or taken over by the main thread.
+				if (asset->state != PrefetchedAsset::State::Queued)
+					return;
+				asset->state = PrefetchedAsset::State::Loading;
+			}
+			LoadPrefetchedAsset(*asset, path);
+			{
+				std::lock_guard<SdlMutex> lock(PrefetchMutex);
+				asset->state = PrefetchedAsset::State::Done;
+			}
+			PrefetchDone.notify_all();
+		});
+	}
+}
+
+void ClearPrefetchedAssets()
+{
+	std::lock_guard<SdlMutex> lock(PrefetchMutex);
+	// Waiting below releases the mutex, so detach the entries from the map first.
+	const std::unordered_map<std::string, std::shared_ptr<PrefetchedAsset>> assets = std::move(PrefetchedAssets);
+	PrefetchedAssets.clear();
+	for (const auto &[path, asset] : assets) {
+		if (asset->state == PrefetchedAsset::State::Queued) {
+			asset->state = PrefetchedAsset::State::Done;
+			continue;
+		}
+		PrefetchDone.wait(PrefetchMutex, [&]() { return asset->state == PrefetchedAsset::State::Done; });
+		if (asset->data != nullptr)
+			LogVerbose("Prefetched asset was not used: {}", path);
+	}
+}
+
+void RebuildAssetIndex()
+{
+	IndexMpqArchives();
+	IndexPrefPathFiles();
+}
+
+void ClearAssetIndex()
+{
+	MpqFileIndex.clear();
+	MpqFileIndexValid = false;
+	MpqArchivesChecksumValid = false;
+	PrefPathFileIndex.clear();
+	PrefPathFileIndexValid = false;
+}
+
+uint64_t GetMpqAssetSource(std::string_view filename)
+{
+	if (filename.empty() || filename[0] == '/' || MayExistInPrefPath(filename))
+		return 0;
+	MpqArchive *archive;
+	uint32_t fileNumber;
+	if (!FindMpqFile(filename, &archive, &fileNumber))
+		return 0;
+	const std::array<IndexedArchive, 11> archives = GetIndexedArchives();
+	for (size_t i = 0; i < archives.size(); ++i) {
+		if (*archives[i].archive && &**archives[i].archive == archive)
+			return (static_cast<uint64_t>(i + 1) << 32) | fileNumber;
+	}
+	return 0;
+}
+
+uint64_t GetMpqArchivesChecksum()
+{
+	if (MpqArchivesChecksumValid)
+		return MpqArchivesChecksum;
+	MpqArchivesChecksum = 0;
+	for (const IndexedArchive &indexed : GetIndexedArchives()) {
+		uint64_t checksum = 0;
+		if (*indexed.archive && !(*indexed.archive)->ComputeTablesChecksum(checksum)) {
+			MpqArchivesChecksum = 0;
+			break;
+		}
+		// Which archives are loaded matters too, not just their contents.
+		MpqArchivesChecksum = (MpqArchivesChecksum ^ checksum) * 0x100000001B3;
+	}
+	MpqArchivesChecksumValid = true;
+	return MpqArchivesChecksum;
+}
 #endif
 
 AssetHandle OpenAsset(AssetRef &&ref, bool threadsafe)
 {
 #if UNPACKED_MPQS
-	return AssetHandle { OpenFile(ref.path, "rb") };
+	AssetHandle result { OpenFile(ref.path, "rb") };
 #else
-	if (ref.archive != nullptr)
-		return AssetHandle { SDL_RWops_FromMpqFile(*ref.archive, ref.fileNumber, ref.filename, threadsafe) };
-	if (ref.directHandle != nullptr) {
+	AssetHandle result;
+	if (ref.archive != nullptr) {
+		result = AssetHandle { SDL_RWops_FromMpqFile(*ref.archive, ref.fileNumber, ref.filename, threadsafe) };
+	} else if (ref.directHandle != nullptr) {
 		// Transfer handle ownership:
-		SDL_RWops *handle = ref.directHandle;
+		result = AssetHandle { ref.directHandle };
 		ref.directHandle = nullptr;
-		return AssetHandle { handle };
 	}
-	return AssetHandle { nullptr };
 #endif
+	result.statsRecord = ref.statsRecord;
+	return result;
 }
 
 AssetHandle OpenAsset(std::string_view filename, bool threadsafe)
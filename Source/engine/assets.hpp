@@ -5,12 +5,14 @@
 #include <cstdio>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <SDL.h>
 #include <expected.hpp>
 
 #include "appfat.h"
 #include "diablo.h"
+#include "engine/asset_stats.hpp"
 #include "mpq/mpq_reader.hpp"
 #include "utils/file_util.h"
 #include "utils/str_cat.hpp"
@@ -24,6 +26,9 @@ struct AssetRef {
 
 	char path[PathBufSize];
 
+	/** @brief See `asset_stats.hpp`. */
+	uint32_t statsRecord = NoAssetStatsRecord;
+
 	[[nodiscard]] bool ok() const
 	{
 		return path[0] != '\0';
@@ -47,6 +52,9 @@ struct AssetRef {
 struct AssetHandle {
 	FILE *handle = nullptr;
 
+	/** @brief See `asset_stats.hpp`. */
+	uint32_t statsRecord = NoAssetStatsRecord;
+
 	AssetHandle() = default;
 
 	AssetHandle(FILE *handle)
@@ -56,6 +64,7 @@ struct AssetHandle {
 
 	AssetHandle(AssetHandle &&other) noexcept
 	    : handle(other.handle)
+	    , statsRecord(other.statsRecord)
 	{
 		other.handle = nullptr;
 	}
@@ -63,6 +72,7 @@ struct AssetHandle {
 	AssetHandle &operator=(AssetHandle &&other) noexcept
 	{
 		handle = other.handle;
+		statsRecord = other.statsRecord;
 		other.handle = nullptr;
 		return *this;
 	}
@@ -80,6 +90,7 @@ struct AssetHandle {
 
 	bool read(void *buffer, size_t len)
 	{
+		const AssetReadStatsScope stats(statsRecord, len);
 		return std::fread(buffer, len, 1, handle) == 1;
 	}
 
@@ -103,6 +114,9 @@ struct AssetRef {
 	// Alternatively, a direct SDL_RWops handle:
 	SDL_RWops *directHandle = nullptr;
 
+	/** @brief See `asset_stats.hpp`. */
+	uint32_t statsRecord = NoAssetStatsRecord;
+
 	AssetRef() = default;
 
 	AssetRef(AssetRef &&other) noexcept
@@ -110,6 +124,7 @@ struct AssetRef {
 	    , fileNumber(other.fileNumber)
 	    , filename(other.filename)
 	    , directHandle(other.directHandle)
+	    , statsRecord(other.statsRecord)
 	{
 		other.directHandle = nullptr;
 	}
@@ -122,6 +137,7 @@ struct AssetRef {
 		fileNumber = other.fileNumber;
 		filename = other.filename;
 		directHandle = other.directHandle;
+		statsRecord = other.statsRecord;
 		other.directHandle = nullptr;
 		return *this;
 	}
@@ -156,6 +172,9 @@ struct AssetRef {
 struct AssetHandle {
 	SDL_RWops *handle = nullptr;
 
+	/** @brief See `asset_stats.hpp`. */
+	uint32_t statsRecord = NoAssetStatsRecord;
+
 	AssetHandle() = default;
 
 	explicit AssetHandle(SDL_RWops *handle)
@@ -165,6 +184,7 @@ struct AssetHandle {
 
 	AssetHandle(AssetHandle &&other) noexcept
 	    : handle(other.handle)
+	    , statsRecord(other.statsRecord)
 	{
 		other.handle = nullptr;
 	}
@@ -175,6 +195,7 @@ struct AssetHandle {
 			SDL_RWclose(handle);
 		}
 		handle = other.handle;
+		statsRecord = other.statsRecord;
 		other.handle = nullptr;
 		return *this;
 	}
@@ -192,6 +213,7 @@ struct AssetHandle {
 
 	bool read(void *buffer, size_t len)
 	{
+		const AssetReadStatsScope stats(statsRecord, len);
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 		return handle->read(handle, buffer, len, 1) == 1;
 #else
@@ -245,6 +267,51 @@ inline bool ValidateHandle(std::string_view path, const AssetHandle &handle)
 
 AssetRef FindAsset(std::string_view filename);
 
+#ifndef UNPACKED_MPQS
+/**
+ * @brief Indexes the files of all the loaded MPQ archives and of the `PrefPath()` directory,
+ * so that `FindAsset` does a single hash lookup instead of probing each archive in turn.
+ *
+ * Must be called whenever an MPQ archive is opened or closed. Files added to `PrefPath()` afterwards
+ * only override MPQ contents after the next call.
+ */
+void RebuildAssetIndex();
+
+/** @brief Drops the index built by `RebuildAssetIndex`, once all the MPQ archives are closed. */
+void ClearAssetIndex();
+
+/**
+ * @brief Identifies the MPQ archive and the file in it that `filename` is read from.
+ *
+ * The same name can be read from different archives, e.g. depending on `gbIsHellfire`.
+ *
+ * @return The archive's priority (starting at 1) in the upper 32 bits and the file number in the lower ones,
+ * or 0 if `filename` is read from a loose file or not found.
+ */
+uint64_t GetMpqAssetSource(std::string_view filename);
+
+/**
+ * @brief Returns a checksum of all the loaded MPQ archives, or 0 if one of them could not be read.
+ *
+ * Computed on first use after `RebuildAssetIndex`.
+ */
+uint64_t GetMpqArchivesChecksum();
+#endif
+
+/**
+ * @brief Starts reading the given assets on the worker threads.
+ *
+ * A later `FindAsset` for one of these paths returns the data from memory,
+ * waiting for the read to finish if needed. Each prefetched asset can be taken once.
+ * Does nothing when there are no worker threads or with `UNPACKED_MPQS`.
+ *
+ * @param paths Asset paths, exactly as they will be passed to `FindAsset`.
+ */
+void PrefetchAssets(const std::vector<std::string> &paths);
+
+/** @brief Waits for the pending prefetches and drops the assets that have not been used. */
+void ClearPrefetchedAssets();
+
 AssetHandle OpenAsset(AssetRef &&ref, bool threadsafe = false);
 AssetHandle OpenAsset(std::string_view filename, bool threadsafe = false);
 AssetHandle OpenAsset(std::string_view filename, size_t &fileSize, bool threadsafe = false);
@@ -0,0 +1,139 @@
+#include "engine/clx_cache.hpp"
+
+#ifdef DEVILUTIONX_CLX_CACHE
+#include <cstdio>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "engine/assets.hpp"
+#include "mpq/mpq_common.hpp"
+#include "utils/endian.hpp"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+namespace {
+
+constexpr uint32_t ClxCacheMagic = LoadLE32("DXCC");
+
+/** @brief Must be incremented whenever the output of the CLX converters changes. */
+constexpr uint32_t ClxCacheVersion = 2;
+
+struct ClxCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t variant;
+	uint32_t size;
+	uint32_t numLists;
+	uint32_t reserved;
+	uint64_t archivesChecksum;
+	/** @brief The archive and file the entry was converted from, see `GetMpqAssetSource`. */
+	uint64_t assetSource;
+};
+
+std::string GetCacheDirectory()
+{
+	return StrCat(paths::PrefPath(), ClxCacheDirectory, DIRECTORY_SEPARATOR_STR);
+}
+
+std::string GetEntryPath(std::string_view path, uint32_t variant, uint64_t assetSource)
+{
+	// The MPQ hash is case- and separator-insensitive, just like asset lookups.
+	const MpqFileHash hash = CalculateMpqFileHash(path);
+	// The same path can be read from different archives, e.g. in Diablo and Hellfire games, so each gets its own entry.
+	const auto archive = static_cast<uint32_t>(assetSource >> 32);
+	return fmt::format("{}{:08x}{:08x}_{:x}_{:x}.clx", GetCacheDirectory(), hash[1], hash[2], variant, archive);
+}
+
+} // namespace
+
+std::unique_ptr<uint8_t[]> LoadCachedClx(std::string_view path, uint32_t variant, size_t &size, uint16_t &numLists)
+{
+	// Loose files override the MPQ contents and are not cached.
+	const uint64_t assetSource = GetMpqAssetSource(path);
+	if (assetSource == 0)
+		return nullptr;
+	const uint64_t archivesChecksum = GetMpqArchivesChecksum();
+	if (archivesChecksum == 0)
+		return nullptr;
+	const std::string entryPath = GetEntryPath(path, variant, assetSource);
+	FILE *file = OpenFile(entryPath.c_str(), "rb");
+	if (file == nullptr)
+		return nullptr;
+
+	std::unique_ptr<uint8_t[]> result;
+	ClxCacheHeader header;
+	if (std::fread(&header, sizeof(header), 1, file) == 1
+	    && header.magic == ClxCacheMagic && header.version == ClxCacheVersion
+	    && header.variant == variant && header.archivesChecksum == archivesChecksum && header.assetSource == assetSource
+	    && header.size != 0 && header.numLists <= UINT16_MAX) {
+		result = std::unique_ptr<uint8_t[]> { new uint8_t[header.size] };
+		if (std::fread(result.get(), header.size, 1, file) == 1) {
+			size = header.size;
+			numLists = static_cast<uint16_t>(header.numLists);
+		} else {
+			result = nullptr;
+		}
+	}
+	std::fclose(file);
+	// Entries that fail to load are rewritten by the caller's `StoreCachedClx`.
+	return result;
+}
+
+bool HasCachedClx(std::string_view path, uint32_t variant)
+{
+	const uint64_t assetSource = GetMpqAssetSource(path);
+	return assetSource != 0 && FileExists(GetEntryPath(path, variant, assetSource));
+}
+
+void StoreCachedClx(std::string_view path, uint32_t variant, const uint8_t *data, size_t size, uint16_t numLists)
+{
+	if (size == 0 || size > UINT32_MAX)
+		return;
+	const uint64_t assetSource = GetMpqAssetSource(path);
+	if (assetSource == 0)
+		return;
+	const uint64_t archivesChecksum = GetMpqArchivesChecksum();
+	if (archivesChecksum == 0)
+		return;
+
+	const std::string cacheDirectory = GetCacheDirectory();
+	if (!DirectoryExists(cacheDirectory.c_str()))
+		RecursivelyCreateDir(cacheDirectory.c_str());
+
+	// Write to a temporary file first, so that an interrupted write never leaves a truncated entry behind.
+	const std::string entryPath = GetEntryPath(path, variant, assetSource);
+	const std::string tempPath = entryPath + ".tmp";
+	FILE *file = OpenFile(tempPath.c_str(), "wb");
+	if (file == nullptr) {
+		LogVerbose("Failed to write {}", tempPath);
+		return;
+	}
+	const ClxCacheHeader header {
+		ClxCacheMagic,
+		ClxCacheVersion,
+		variant,
+		static_cast<uint32_t>(size),
+		numLists,
+		/*reserved=*/0,
+		archivesChecksum,
+		assetSource,
+	};
+	const bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+	    && std::fwrite(data, size, 1, file) == 1;
+	if (std::fclose(file) != 0 || !ok) {
+		LogVerbose("Failed to write {}", tempPath);
+		RemoveFile(tempPath.c_str());
+		return;
+	}
+	if (FileExists(entryPath))
+		RemoveFile(entryPath.c_str());
+	RenameFile(tempPath.c_str(), entryPath.c_str());
+}
+
+} // namespace devilution
+#endif
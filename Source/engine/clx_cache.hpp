@@ -0,0 +1,57 @@
+/**
+ * @file clx_cache.hpp
+ *
+ * On-disk cache of sprites converted to CLX.
+ *
+ * The MPQ archives store sprites as CEL and CL2, which are converted to CLX every time they are loaded.
+ * The converted sprites are saved under `PrefPath()/clx_cache/` and read back as-is on later launches.
+ * Each entry is tagged with a checksum of the loaded MPQ archives and is ignored once they change.
+ * Entries are also kept per archive the asset is read from, as e.g. Diablo and Hellfire games read some of them from different ones.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace devilution {
+
+/** @brief The cache directory within `PrefPath()`. */
+inline constexpr char ClxCacheDirectory[] = "clx_cache";
+
+#ifdef DEVILUTIONX_CLX_CACHE
+/**
+ * @brief Reads the cached conversion of the asset at `path`.
+ *
+ * @param variant Distinguishes conversions of the same asset with different parameters, e.g. the frame width.
+ * @return The converted data, or `nullptr` if the entry is missing or stale.
+ */
+std::unique_ptr<uint8_t[]> LoadCachedClx(std::string_view path, uint32_t variant, size_t &size, uint16_t &numLists);
+
+/** @brief Whether there is an entry for the asset at `path`, without checking whether it is stale. */
+bool HasCachedClx(std::string_view path, uint32_t variant);
+
+/**
+ * @brief Saves the conversion of the asset at `path`, see `LoadCachedClx`.
+ *
+ * Does nothing unless the asset comes from one of the loaded MPQ archives.
+ */
+void StoreCachedClx(std::string_view path, uint32_t variant, const uint8_t *data, size_t size, uint16_t numLists);
+#else
+inline std::unique_ptr<uint8_t[]> LoadCachedClx(std::string_view /*path*/, uint32_t /*variant*/, size_t & /*size*/, uint16_t & /*numLists*/)
+{
+	return nullptr;
+}
+
+inline bool HasCachedClx(std::string_view /*path*/, uint32_t /*variant*/)
+{
+	return false;
+}
+
+inline void StoreCachedClx(std::string_view /*path*/, uint32_t /*variant*/, const uint8_t * /*data*/, size_t /*size*/, uint16_t /*numLists*/)
+{
+}
+#endif
+
+} // namespace devilution
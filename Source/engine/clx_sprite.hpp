@@ -15,7 +15,9 @@
  *      0..2  | uint16_t | offset to data start (same as CL2)
  *      2..4  | uint16_t | width
  *      4..6  | uint16_t | height
- *      6..10 |    -     | unused
+ *      6..10 | uint32_t | offset to the span table, 0 if none
+ *
+ * The span table offset is always 0 in CLX files. Span tables are only built at runtime, see `engine/render/clx_spans.hpp`.
  *
  * The CLX format is otherwise identical to CL2.
  *
@@ -77,6 +79,15 @@ public:
 		return pixel_data_size_;
 	}
 
+	/**
+	 * @brief The precompiled span table of the sprite, or `nullptr` if it has none.
+	 */
+	[[nodiscard]] constexpr const uint8_t *spanTable() const
+	{
+		const uint32_t offset = LoadLE32(&data_[6]);
+		return offset != 0 ? &data_[offset] : nullptr;
+	}
+
 	constexpr bool operator==(const ClxSprite &other) const
 	{
 		return data_ == other.data_;
@@ -388,6 +399,9 @@ inline OwnedClxSpriteList ClxSpriteList::clone() const
 	const size_t dataSize = nextSpriteSheetOffsetOrFileSize();
 	std::unique_ptr<uint8_t[]> data { new uint8_t[dataSize] };
 	memcpy(data.get(), data_, dataSize);
+	// The span tables are not copied.
+	for (size_t i = 0; i < numSprites(); ++i)
+		WriteLE32(&data[spriteOffset(i) + 6], 0);
 	return OwnedClxSpriteList { std::move(data) };
 }
 
@@ -10,6 +10,7 @@
 
 #include "controls/plrctrls.h"
 #include "engine.h"
+#include "engine/render/render_stats.hpp"
 #include "options.h"
 #include "utils/display.h"
 #include "utils/log.hpp"
@@ -164,6 +165,7 @@ void Blit(SDL_Surface *src, SDL_Rect *srcRect, SDL_Rect *dstRect)
 	if (HeadlessMode)
 		return;
 
+	const RenderStatsScope renderStats { RenderStatsCategory::Blit };
 	SDL_Surface *dst = GetOutputSurface();
 #ifndef USE_SDL1
 	if (SDL_BlitSurface(src, srcRect, dst, dstRect) < 0)
@@ -13,12 +13,31 @@
 #ifdef UNPACKED_MPQS
 #include "engine/load_clx.hpp"
 #else
+#include "engine/clx_cache.hpp"
 #include "engine/load_file.hpp"
 #include "utils/cel_to_clx.hpp"
 #endif
 
 namespace devilution {
 
+#ifndef UNPACKED_MPQS
+namespace {
+
+void StoreCachedCelConversion(const char *path, uint16_t width, ClxSpriteListOrSheet listOrSheet)
+{
+	if (!listOrSheet.isSheet()) {
+		const ClxSpriteList list = listOrSheet.list();
+		StoreCachedClx(path, width, list.data(), list.nextSpriteSheetOffsetOrFileSize(), 0);
+		return;
+	}
+	const ClxSpriteSheet sheet = listOrSheet.sheet();
+	const size_t lastList = sheet.numLists() - 1;
+	StoreCachedClx(path, width, sheet.data(), sheet.sheetOffset(lastList) + sheet[lastList].nextSpriteSheetOffsetOrFileSize(), sheet.numLists());
+}
+
+} // namespace
+#endif
+
 OwnedClxSpriteListOrSheet LoadCelListOrSheet(const char *pszName, PointerOrValue<uint16_t> widthOrWidths)
 {
 	char path[MaxMpqPathSize];
@@ -26,12 +45,23 @@ OwnedClxSpriteListOrSheet LoadCelListOrSheet(const char *pszName, PointerOrValue
 #ifdef UNPACKED_MPQS
 	return LoadClxListOrSheet(path);
 #else
+	// Only conversions with a single frame width are cached, the cache key does not cover the widths array.
+	const bool cacheable = !widthOrWidths.HoldsPointer();
 	size_t size;
+	if (cacheable) {
+		uint16_t numLists;
+		std::unique_ptr<uint8_t[]> cached = LoadCachedClx(path, widthOrWidths.AsValue(), size, numLists);
+		if (cached != nullptr)
+			return OwnedClxSpriteListOrSheet { std::move(cached), numLists };
+	}
 	std::unique_ptr<uint8_t[]> data = LoadFileInMem<uint8_t>(path, &size);
 #ifdef DEBUG_CEL_TO_CL2_SIZE
 	std::cout << path;
 #endif
-	return CelToClx(data.get(), size, widthOrWidths);
+	OwnedClxSpriteListOrSheet result = CelToClx(data.get(), size, widthOrWidths);
+	if (cacheable)
+		StoreCachedCelConversion(path, widthOrWidths.AsValue(), result);
+	return result;
 #endif
 }
 
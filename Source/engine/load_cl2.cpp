@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "mpq/mpq_common.hpp"
 #include "utils/str_cat.hpp"
@@ -10,7 +11,9 @@
 #ifdef UNPACKED_MPQS
 #include "engine/load_clx.hpp"
 #else
+#include "engine/clx_cache.hpp"
 #include "engine/load_file.hpp"
+#include "engine/render/clx_spans.hpp"
 #include "utils/cl2_to_clx.hpp"
 #endif
 
@@ -23,9 +26,21 @@ OwnedClxSpriteListOrSheet LoadCl2ListOrSheet(const char *pszName, PointerOrValue
 #ifdef UNPACKED_MPQS
 	return LoadClxListOrSheet(path);
 #else
+	// Only conversions with a single frame width are cached, the cache key does not cover the widths array.
+	const bool cacheable = !widthOrWidths.HoldsPointer();
 	size_t size;
+	uint16_t numLists;
+	if (cacheable) {
+		const std::unique_ptr<uint8_t[]> cached = LoadCachedClx(path, widthOrWidths.AsValue(), size, numLists);
+		if (cached != nullptr)
+			return OwnedClxSpriteListOrSheet { CopyClxWithSpanTables(cached.get(), size), numLists };
+	}
 	std::unique_ptr<uint8_t[]> data = LoadFileInMem<uint8_t>(path, &size);
-	return Cl2ToClx(std::move(data), size, widthOrWidths);
+	std::vector<uint8_t> clxData;
+	numLists = Cl2ToClx(data.get(), size, widthOrWidths, clxData);
+	if (cacheable)
+		StoreCachedClx(path, widthOrWidths.AsValue(), clxData.data(), clxData.size(), numLists);
+	return OwnedClxSpriteListOrSheet { CopyClxWithSpanTables(clxData.data(), clxData.size()), numLists };
 #endif
 }
 
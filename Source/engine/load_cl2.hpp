@@ -3,12 +3,14 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 #include <function_ref.hpp>
 
 #include "appfat.h"
 #include "engine/clx_sprite.hpp"
 #include "engine/load_file.hpp"
+#include "engine/render/clx_spans.hpp"
 #include "mpq/mpq_common.hpp"
 #include "utils/cl2_to_clx.hpp"
 #include "utils/endian.hpp"
@@ -64,9 +66,11 @@ OwnedClxSpriteSheet LoadMultipleCl2Sheet(tl::function_ref<const char *(size_t)>
 		accumulatedSize += size;
 	}
 #ifdef UNPACKED_MPQS
-	return OwnedClxSpriteSheet { std::move(data), static_cast<uint16_t>(count) };
+	return OwnedClxSpriteSheet { CopyClxWithSpanTables(data.get(), accumulatedSize), static_cast<uint16_t>(count) };
 #else
-	return Cl2ToClx(std::move(data), accumulatedSize, frameWidth).sheet();
+	std::vector<uint8_t> clxData;
+	Cl2ToClx(data.get(), accumulatedSize, frameWidth, clxData);
+	return OwnedClxSpriteSheet { CopyClxWithSpanTables(clxData.data(), clxData.size()), static_cast<uint16_t>(count) };
 #endif
 }
 
@@ -10,6 +10,7 @@
 
 #include "engine/assets.hpp"
 #include "engine/load_file.hpp"
+#include "engine/render/clx_spans.hpp"
 
 namespace devilution {
 
@@ -25,14 +26,14 @@ OptionalOwnedClxSpriteListOrSheet LoadOptionalClxListOrSheet(const char *path)
 		if (!handle.ok() || !handle.read(data.get(), size))
 			return std::nullopt;
 	}
-	return OwnedClxSpriteListOrSheet::FromBuffer(std::move(data), size);
+	return OwnedClxSpriteListOrSheet::FromBuffer(CopyClxWithSpanTables(data.get(), size), size);
 }
 
 OwnedClxSpriteListOrSheet LoadClxListOrSheet(const char *path)
 {
 	size_t size;
 	std::unique_ptr<uint8_t[]> data = LoadFileInMem<uint8_t>(path, &size);
-	return OwnedClxSpriteListOrSheet::FromBuffer(std::move(data), size);
+	return OwnedClxSpriteListOrSheet::FromBuffer(CopyClxWithSpanTables(data.get(), size), size);
 }
 
 } // namespace devilution
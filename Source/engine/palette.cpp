@@ -6,6 +6,7 @@
 #include "engine/palette.h"
 
 #include <cstdint>
+#include <cstring>
 
 #include <fmt/core.h>
 
@@ -34,6 +35,10 @@ Uint8 paletteTransparencyLookup[256][256];
 uint16_t paletteTransparencyLookupBlack16[65536];
 #endif
 
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+uint8_t paletteTransparencyLookupPacked[PackedTransparencyLookupSize];
+#endif
+
 namespace {
 
 /** Specifies whether the palette has max brightness. */
@@ -112,6 +117,9 @@ void GenerateBlendedLookupTable(std::array<SDL_Color, 256> &palette, int skipFro
 		}
 	}
 #endif
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+	UpdatePackedTransparencyLookup();
+#endif
 }
 
 /**
@@ -128,6 +136,9 @@ void CycleColors(int from, int to)
 	}
 
 	std::rotate(&paletteTransparencyLookup[from][0], &paletteTransparencyLookup[from + 1][0], &paletteTransparencyLookup[to + 1][0]);
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+	UpdatePackedTransparencyLookup();
+#endif
 }
 
 /**
@@ -144,6 +155,9 @@ void CycleColorsReverse(int from, int to)
 	}
 
 	std::rotate(&paletteTransparencyLookup[from][0], &paletteTransparencyLookup[to][0], &paletteTransparencyLookup[to + 1][0]);
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+	UpdatePackedTransparencyLookup();
+#endif
 }
 
 } // namespace
@@ -423,6 +437,20 @@ void palette_update_quest_palette(int n)
 		Uint8 best = FindBestMatchForColor(logical_palette, blendedColor, 1, 31);
 		paletteTransparencyLookup[i][j] = paletteTransparencyLookup[j][i] = best;
 	}
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+	UpdatePackedTransparencyLookup();
+#endif
+}
+
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+void UpdatePackedTransparencyLookup()
+{
+	uint8_t *dst = paletteTransparencyLookupPacked;
+	for (unsigned i = 0; i < 256; ++i) {
+		std::memcpy(dst, paletteTransparencyLookup[i], i + 1);
+		dst += i + 1;
+	}
 }
+#endif
 
 } // namespace devilution
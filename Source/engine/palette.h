@@ -9,6 +9,7 @@
 #include <cstdint>
 
 #include "levels/gendung.h"
+#include "utils/attributes.h"
 
 namespace devilution {
 
@@ -36,7 +37,33 @@ extern std::array<SDL_Color, 256> logical_palette;
 extern std::array<SDL_Color, 256> system_palette;
 extern std::array<SDL_Color, 256> orig_palette;
 /** Lookup table for transparency */
-extern Uint8 paletteTransparencyLookup[256][256];
+extern DVL_API_FOR_TEST Uint8 paletteTransparencyLookup[256][256];
+
+/** Number of entries in one half of `paletteTransparencyLookup`, including the diagonal. */
+constexpr unsigned PackedTransparencyLookupSize = 256 * 257 / 2;
+
+/**
+ * @brief Index of the blend of colors i and j in `paletteTransparencyLookupPacked`.
+ *
+ * The blend does not depend on the order of the colors, so the table only stores the entries with `i >= j`.
+ */
+constexpr unsigned GetPackedTransparencyIndex(uint8_t i, uint8_t j)
+{
+	const unsigned hi = i >= j ? i : j;
+	const unsigned lo = i >= j ? j : i;
+	return hi * (hi + 1) / 2 + lo;
+}
+
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+/**
+ * A copy of `paletteTransparencyLookup` indexed with `GetPackedTransparencyIndex`,
+ * using half as much memory.
+ */
+extern DVL_API_FOR_TEST uint8_t paletteTransparencyLookupPacked[PackedTransparencyLookupSize];
+
+/** @brief Updates `paletteTransparencyLookupPacked` after changing `paletteTransparencyLookup`. */
+void UpdatePackedTransparencyLookup();
+#endif
 
 #if DEVILUTIONX_PALETTE_TRANSPARENCY_BLACK_16_LUT
 /**
@@ -161,8 +161,15 @@ void DrawMapFreeLine(const Surface &out, Point from, Point to, uint8_t colorInde
 	}
 }
 
+bool AutomapDrawingToLayer;
+
 void SetMapPixel(const Surface &out, Point position, uint8_t color)
 {
+	if (AutomapDrawingToLayer) {
+		out.SetPixel(position, color);
+		return;
+	}
+
 	if (GetAutomapType() == AutomapType::Minimap && !MinimapRect.contains(position))
 		return;
 
@@ -92,6 +92,13 @@ void DrawMapLineSteepNW(const Surface &out, Point from, int width, std::uint8_t
 void DrawMapLineSteepSW(const Surface &out, Point from, int width, std::uint8_t colorIndex);
 void DrawMapFreeLine(const Surface &out, Point from, Point to, uint8_t colorIndex);
 
+/**
+ * @brief Set while the automap is drawn to its off-screen layer.
+ *
+ * The layer stores the colors as they are, the transparency and the minimap clipping are applied when it is composited.
+ */
+extern bool AutomapDrawingToLayer;
+
 /**
  * @brief Draw an automap pixel.
  *
@@ -0,0 +1,311 @@
+#include "engine/render/blit_simd.hpp"
+
+#include <cstdint>
+
+#include "engine/palette.h"
+#include "utils/cpu_features.hpp"
+
+#if defined(DVL_SIMD_X86)
+#include <immintrin.h>
+#elif defined(DVL_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace devilution {
+
+namespace {
+
+void BlitPixelsWithMapScalar(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	BlitPixelsWithMap(dst, src, length, colorMap);
+}
+
+void BlitFillBlendedScalar(uint8_t *dst, unsigned length, uint8_t color)
+{
+	BlitFillBlended(dst, length, color);
+}
+
+void BlitPixelsBlendedScalar(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length)
+{
+	BlitPixelsBlended(dst, src, length);
+}
+
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+void BlitPixelsBlendedPackedScalar(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length)
+{
+	for (const uint8_t *end = src + length; src < end; ++src, ++dst)
+		*dst = paletteTransparencyLookupPacked[GetPackedTransparencyIndex(*dst, *src)];
+}
+#endif
+
+#if defined(DVL_SIMD_X86)
+
+// `pshufb` can only index 16 entries, so the 256-entry map is split into 16 rows.
+// For row `i` we subtract `16 * i` from the indices and add 0x70 with unsigned saturation:
+// indices that fall into the row end up in [0x70, 0x80) and select `row[index & 0xF]`,
+// all others have the high bit set and make `pshufb` produce 0. OR-ing the rows gives the result.
+
+DVL_ATTRIBUTE_TARGET("ssse3") __m128i LookupSsse3(const __m128i *rows, __m128i indices)
+{
+	const __m128i bias = _mm_set1_epi8(0x70);
+	const __m128i rowSize = _mm_set1_epi8(16);
+	__m128i result = _mm_shuffle_epi8(rows[0], _mm_adds_epu8(indices, bias));
+	for (int i = 1; i < 16; ++i) {
+		indices = _mm_sub_epi8(indices, rowSize);
+		result = _mm_or_si128(result, _mm_shuffle_epi8(rows[i], _mm_adds_epu8(indices, bias)));
+	}
+	return result;
+}
+
+/**
+ * @brief Maps all the whole vectors of `src` to `dst`, which can be the same buffer.
+ * @return The number of pixels left at the end.
+ */
+DVL_ATTRIBUTE_TARGET("ssse3") unsigned MapVectorsSsse3(uint8_t *dst, const uint8_t *src, unsigned length, const uint8_t *colorMap)
+{
+	__m128i rows[16];
+	for (int i = 0; i < 16; ++i)
+		rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(colorMap + 16 * i));
+
+	for (; length >= 16; length -= 16, src += 16, dst += 16) {
+		const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst), LookupSsse3(rows, indices));
+	}
+	return length;
+}
+
+DVL_ATTRIBUTE_TARGET("avx2") unsigned MapVectorsAvx2(uint8_t *dst, const uint8_t *src, unsigned length, const uint8_t *colorMap)
+{
+	// `vpshufb` shuffles within each 128-bit lane, so both lanes get a copy of the row.
+	__m256i rows[16];
+	for (int i = 0; i < 16; ++i)
+		rows[i] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(colorMap + 16 * i)));
+
+	const __m256i bias = _mm256_set1_epi8(0x70);
+	const __m256i rowSize = _mm256_set1_epi8(16);
+	for (; length >= 32; length -= 32, src += 32, dst += 32) {
+		__m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+		__m256i result = _mm256_shuffle_epi8(rows[0], _mm256_adds_epu8(indices, bias));
+		for (int i = 1; i < 16; ++i) {
+			indices = _mm256_sub_epi8(indices, rowSize);
+			result = _mm256_or_si256(result, _mm256_shuffle_epi8(rows[i], _mm256_adds_epu8(indices, bias)));
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), result);
+	}
+	if (length >= 16) {
+		__m128i lowRows[16];
+		for (int i = 0; i < 16; ++i)
+			lowRows[i] = _mm256_castsi256_si128(rows[i]);
+		const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst), LookupSsse3(lowRows, indices));
+		length -= 16;
+	}
+	return length;
+}
+
+DVL_ATTRIBUTE_TARGET("ssse3") void BlitPixelsWithMapSsse3(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	const unsigned remaining = MapVectorsSsse3(dst, src, length, colorMap);
+	if (remaining != 0)
+		BlitPixelsWithMap(dst + length - remaining, src + length - remaining, remaining, colorMap);
+}
+
+DVL_ATTRIBUTE_TARGET("avx2") void BlitPixelsWithMapAvx2(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	const unsigned remaining = MapVectorsAvx2(dst, src, length, colorMap);
+	if (remaining != 0)
+		BlitPixelsWithMap(dst + length - remaining, src + length - remaining, remaining, colorMap);
+}
+
+DVL_ATTRIBUTE_TARGET("ssse3") void BlitFillBlendedSsse3(uint8_t *dst, unsigned length, uint8_t color)
+{
+	const unsigned remaining = MapVectorsSsse3(dst, dst, length, paletteTransparencyLookup[color]);
+	if (remaining != 0)
+		BlitFillBlended(dst + length - remaining, remaining, color);
+}
+
+DVL_ATTRIBUTE_TARGET("avx2") void BlitFillBlendedAvx2(uint8_t *dst, unsigned length, uint8_t color)
+{
+	const unsigned remaining = MapVectorsAvx2(dst, dst, length, paletteTransparencyLookup[color]);
+	if (remaining != 0)
+		BlitFillBlended(dst + length - remaining, remaining, color);
+}
+
+// There is no byte gather, so the blended pixels are gathered as the 32-bit words that contain them.
+// The words are read at 4-byte aligned offsets, which keeps the reads within the table,
+// and the byte is then shifted down into place.
+
+template <bool Packed>
+DVL_ATTRIBUTE_TARGET("avx2") __m256i GatherBlendedAvx2(const uint8_t *dst, const uint8_t *src)
+{
+	const __m256i d = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(dst)));
+	const __m256i s = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)));
+	__m256i index;
+	const int *table;
+	if constexpr (Packed) {
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+		const __m256i hi = _mm256_max_epu32(d, s);
+		const __m256i lo = _mm256_min_epu32(d, s);
+		const __m256i triangle = _mm256_srli_epi32(_mm256_mullo_epi32(hi, _mm256_add_epi32(hi, _mm256_set1_epi32(1))), 1);
+		index = _mm256_add_epi32(triangle, lo);
+		table = reinterpret_cast<const int *>(paletteTransparencyLookupPacked);
+#endif
+	} else {
+		index = _mm256_or_si256(_mm256_slli_epi32(d, 8), s);
+		table = reinterpret_cast<const int *>(paletteTransparencyLookup);
+	}
+	const __m256i words = _mm256_i32gather_epi32(table, _mm256_srli_epi32(index, 2), 4);
+	const __m256i shift = _mm256_slli_epi32(_mm256_and_si256(index, _mm256_set1_epi32(3)), 3);
+	return _mm256_and_si256(_mm256_srlv_epi32(words, shift), _mm256_set1_epi32(0xFF));
+}
+
+template <bool Packed>
+DVL_ATTRIBUTE_TARGET("avx2") void BlitPixelsBlendedGatherAvx2(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length)
+{
+	for (; length >= 16; length -= 16, src += 16, dst += 16) {
+		const __m256i lo = GatherBlendedAvx2<Packed>(dst, src);
+		const __m256i hi = GatherBlendedAvx2<Packed>(dst + 8, src + 8);
+		// Narrow 2x8 32-bit values to 16 bytes, undoing the per-lane interleaving of the packs.
+		__m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+		packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(packed, packed), 0x08);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(packed));
+	}
+	if (length != 0)
+		BlitPixelsBlended(dst, src, length);
+}
+
+#elif defined(DVL_SIMD_NEON)
+
+/**
+ * @brief Maps all the whole vectors of `src` to `dst`, which can be the same buffer.
+ * @return The number of pixels left at the end.
+ */
+unsigned MapVectorsNeon(uint8_t *dst, const uint8_t *src, unsigned length, const uint8_t *colorMap)
+{
+	// `tbl` looks up 64 entries at once and yields 0 for out-of-range indices,
+	// `tbx` leaves such lanes untouched, so 4 lookups cover the whole map.
+	uint8x16x4_t quarters[4];
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j)
+			quarters[i].val[j] = vld1q_u8(colorMap + 64 * i + 16 * j);
+	}
+
+	const uint8x16_t quarterSize = vdupq_n_u8(64);
+	for (; length >= 16; length -= 16, src += 16, dst += 16) {
+		uint8x16_t indices = vld1q_u8(src);
+		uint8x16_t result = vqtbl4q_u8(quarters[0], indices);
+		indices = vsubq_u8(indices, quarterSize);
+		result = vqtbx4q_u8(result, quarters[1], indices);
+		indices = vsubq_u8(indices, quarterSize);
+		result = vqtbx4q_u8(result, quarters[2], indices);
+		indices = vsubq_u8(indices, quarterSize);
+		result = vqtbx4q_u8(result, quarters[3], indices);
+		vst1q_u8(dst, result);
+	}
+	return length;
+}
+
+void BlitPixelsWithMapNeon(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	const unsigned remaining = MapVectorsNeon(dst, src, length, colorMap);
+	if (remaining != 0)
+		BlitPixelsWithMap(dst + length - remaining, src + length - remaining, remaining, colorMap);
+}
+
+void BlitFillBlendedNeon(uint8_t *dst, unsigned length, uint8_t color)
+{
+	const unsigned remaining = MapVectorsNeon(dst, dst, length, paletteTransparencyLookup[color]);
+	if (remaining != 0)
+		BlitFillBlended(dst + length - remaining, remaining, color);
+}
+
+#endif
+
+BlitPixelsWithMapFn SelectBlitPixelsWithMapKernel()
+{
+	[[maybe_unused]] const CpuFeatures &features = GetCpuFeatures();
+#if defined(DVL_SIMD_X86)
+	if (features.avx2)
+		return &BlitPixelsWithMapAvx2;
+	if (features.ssse3)
+		return &BlitPixelsWithMapSsse3;
+#elif defined(DVL_SIMD_NEON)
+	if (features.neon)
+		return &BlitPixelsWithMapNeon;
+#endif
+	// SSE2 has no byte shuffle, so there is nothing to gain over the scalar loop.
+	return &BlitPixelsWithMapScalar;
+}
+
+BlitFillBlendedFn SelectBlitFillBlendedKernel()
+{
+	// On x86, the scalar loop over a single 256-byte row that stays in L1 is as fast as
+	// the 16 shuffles per vector needed by `pshufb` (see `blit_simd_benchmark`).
+#if defined(DVL_SIMD_NEON)
+	if (GetCpuFeatures().neon)
+		return &BlitFillBlendedNeon;
+#endif
+	return &BlitFillBlendedScalar;
+}
+
+BlitPixelsBlendedFn SelectBlitPixelsBlendedKernel()
+{
+	[[maybe_unused]] const CpuFeatures &features = GetCpuFeatures();
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+#if defined(DVL_SIMD_X86)
+	if (features.avx2)
+		return &BlitPixelsBlendedGatherAvx2</*Packed=*/true>;
+#endif
+	return &BlitPixelsBlendedPackedScalar;
+#else
+#if defined(DVL_SIMD_X86)
+	if (features.avx2)
+		return &BlitPixelsBlendedGatherAvx2</*Packed=*/false>;
+#endif
+	return &BlitPixelsBlendedScalar;
+#endif
+}
+
+} // namespace
+
+BlitPixelsWithMapFn BlitPixelsWithMapKernel = SelectBlitPixelsWithMapKernel();
+BlitFillBlendedFn BlitFillBlendedKernel = SelectBlitFillBlendedKernel();
+BlitPixelsBlendedFn BlitPixelsBlendedKernel = SelectBlitPixelsBlendedKernel();
+
+std::vector<BlitKernelVariant<BlitFillBlendedFn>> GetBlitFillBlendedVariants()
+{
+	std::vector<BlitKernelVariant<BlitFillBlendedFn>> variants;
+	[[maybe_unused]] const CpuFeatures &features = GetCpuFeatures();
+#if defined(DVL_SIMD_X86)
+	if (features.avx2)
+		variants.push_back({ "AVX2", &BlitFillBlendedAvx2 });
+	if (features.ssse3)
+		variants.push_back({ "SSSE3", &BlitFillBlendedSsse3 });
+#elif defined(DVL_SIMD_NEON)
+	if (features.neon)
+		variants.push_back({ "NEON", &BlitFillBlendedNeon });
+#endif
+	variants.push_back({ "Scalar", &BlitFillBlendedScalar });
+	return variants;
+}
+
+std::vector<BlitKernelVariant<BlitPixelsBlendedFn>> GetBlitPixelsBlendedVariants()
+{
+	std::vector<BlitKernelVariant<BlitPixelsBlendedFn>> variants;
+	[[maybe_unused]] const CpuFeatures &features = GetCpuFeatures();
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+#if defined(DVL_SIMD_X86)
+	if (features.avx2)
+		variants.push_back({ "AVX2 gather, packed LUT", &BlitPixelsBlendedGatherAvx2</*Packed=*/true> });
+#endif
+	variants.push_back({ "Scalar, packed LUT", &BlitPixelsBlendedPackedScalar });
+#endif
+#if defined(DVL_SIMD_X86)
+	if (features.avx2)
+		variants.push_back({ "AVX2 gather", &BlitPixelsBlendedGatherAvx2</*Packed=*/false> });
+#endif
+	variants.push_back({ "Scalar", &BlitPixelsBlendedScalar });
+	return variants;
+}
+
+} // namespace devilution
@@ -0,0 +1,107 @@
+/**
+ * @file blit_simd.hpp
+ *
+ * Vectorized variants of the palette mapping blitters, selected at startup.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/render/blit_impl.hpp"
+#include "utils/attributes.h"
+
+namespace devilution {
+
+using BlitPixelsWithMapFn = void (*)(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap);
+
+/**
+ * @brief The fastest `BlitPixelsWithMap` implementation supported by the host CPU.
+ *
+ * Looks up 16 or 32 pixels per iteration by keeping the 256-entry color map in vector registers
+ * (SSSE3 / AVX2 `pshufb`, AArch64 `tbl`/`tbx`). Falls back to the scalar loop everywhere else.
+ */
+extern DVL_API_FOR_TEST BlitPixelsWithMapFn BlitPixelsWithMapKernel;
+
+/** @brief Lines shorter than this are not worth the indirect call and the table load. */
+constexpr unsigned BlitPixelsWithMapKernelMinLength = 16;
+
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsWithMapFast(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	if (length < BlitPixelsWithMapKernelMinLength) {
+		BlitPixelsWithMap(dst, src, length, colorMap);
+		return;
+	}
+	BlitPixelsWithMapKernel(dst, src, length, colorMap);
+}
+
+using BlitFillBlendedFn = void (*)(uint8_t *dst, unsigned length, uint8_t color);
+using BlitPixelsBlendedFn = void (*)(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length);
+
+/**
+ * @brief The fastest `BlitFillBlended` implementation supported by the host CPU.
+ *
+ * Blending with a single color is a lookup in one row of `paletteTransparencyLookup`.
+ * On AArch64 this uses the same `tbl`/`tbx` lookups as `BlitPixelsWithMapKernel`.
+ */
+extern DVL_API_FOR_TEST BlitFillBlendedFn BlitFillBlendedKernel;
+
+/**
+ * @brief The fastest `BlitPixelsBlended` implementation supported by the host CPU.
+ *
+ * Uses AVX2 gathers where available. Reads `paletteTransparencyLookupPacked` if it is enabled.
+ */
+extern DVL_API_FOR_TEST BlitPixelsBlendedFn BlitPixelsBlendedKernel;
+
+/** @brief Lines shorter than this are blended by the scalar loop. */
+constexpr unsigned BlitPixelsBlendedKernelMinLength = 16;
+
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitFillBlendedFast(uint8_t *dst, unsigned length, uint8_t color)
+{
+	if (length < BlitPixelsBlendedKernelMinLength) {
+		BlitFillBlended(dst, length, color);
+		return;
+	}
+	BlitFillBlendedKernel(dst, length, color);
+}
+
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlendedFast(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length)
+{
+	if (length < BlitPixelsBlendedKernelMinLength) {
+		BlitPixelsBlended(dst, src, length);
+		return;
+	}
+	BlitPixelsBlendedKernel(dst, src, length);
+}
+
+/** @brief A named kernel, for comparing the implementations in tests and benchmarks. */
+template <typename Fn>
+struct BlitKernelVariant {
+	const char *name;
+	Fn fn;
+};
+
+/** @brief All the `BlitFillBlended` implementations that the host CPU supports. */
+std::vector<BlitKernelVariant<BlitFillBlendedFn>> GetBlitFillBlendedVariants();
+
+/** @brief All the `BlitPixelsBlended` implementations that the host CPU supports. */
+std::vector<BlitKernelVariant<BlitPixelsBlendedFn>> GetBlitPixelsBlendedVariants();
+
+/**
+ * @brief Same as `BlitPixelsBlendedWithMap`, but maps the source through `colorMap` with the vector kernel first.
+ *
+ * @param length Must not exceed `MaxLength`.
+ */
+template <unsigned MaxLength>
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void BlitPixelsBlendedWithMapFast(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, unsigned length, const uint8_t *DVL_RESTRICT colorMap)
+{
+	if (length < BlitPixelsWithMapKernelMinLength) {
+		BlitPixelsBlendedWithMap(dst, src, length, colorMap);
+		return;
+	}
+	uint8_t mapped[MaxLength];
+	BlitPixelsWithMapKernel(mapped, src, length, colorMap);
+	BlitPixelsBlendedFast(dst, mapped, length);
+}
+
+} // namespace devilution
@@ -9,6 +9,9 @@
 #include <cstdint>
 
 #include "engine/render/blit_impl.hpp"
+#include "engine/render/blit_simd.hpp"
+#include "engine/render/clx_spans.hpp"
+#include "engine/render/render_stats.hpp"
 #include "engine/render/scrollrt.h"
 #include "utils/attributes.h"
 #include "utils/clx_decode.hpp"
@@ -209,6 +212,103 @@ void DoRenderBackwards(
 	}
 }
 
+struct BlitWithMapFast {
+	const uint8_t *DVL_RESTRICT colorMap;
+
+	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(BlitCommand cmd, uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src) const
+	{
+		switch (cmd.type) {
+		case BlitType::Fill:
+			BlitFillWithMap(dst, cmd.length, cmd.color, colorMap);
+			return;
+		case BlitType::Pixels:
+			BlitPixelsWithMapFast(dst, src, cmd.length, colorMap);
+			return;
+		case BlitType::Transparent:
+			return;
+		}
+	}
+};
+
+struct BlitBlendedWithMapFast {
+	const uint8_t *colorMap;
+
+	DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void operator()(BlitCommand cmd, uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src) const
+	{
+		switch (cmd.type) {
+		case BlitType::Fill:
+			BlitFillBlendedFast(dst, cmd.length, colorMap[cmd.color]);
+			return;
+		case BlitType::Pixels:
+			BlitPixelsBlendedWithMapFast<MaxClxSpanLength>(dst, src, cmd.length, colorMap);
+			return;
+		case BlitType::Transparent:
+			return;
+		}
+	}
+};
+
+DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT BlitCommand GetSpanBlitCommand(const ClxSpan &span, const uint8_t *src, unsigned length)
+{
+	return BlitCommand { span.type, nullptr, length, span.type == BlitType::Fill ? src[span.srcOffset] : uint8_t { 0 } };
+}
+
+template <typename BlitFn>
+void DoRenderSpans(
+    const Surface &out, Point position, ClxSprite clx, const uint8_t *spanTable, BlitFn &&blitFn)
+{
+	const int height = clx.height();
+	if (position.y < 0 || position.y + 1 >= out.h() + height)
+		return;
+	const ClipX clipX = CalculateClipX(position.x, clx.width(), out);
+	if (clipX.width <= 0)
+		return;
+
+	const ClxSpanTable spans { spanTable, clx.height() };
+	const uint8_t *src = clx.pixelData();
+	// Lines below the bottom of the output are skipped without decoding them.
+	const int firstLine = std::max(position.y - (out.h() - 1), 0);
+	const int lastLine = std::min(position.y, height - 1);
+	uint8_t *dstLine = &out[Point { 0, position.y - firstLine }];
+	const int dstPitch = out.pitch();
+
+	if (clipX.left == 0 && clipX.right == 0) {
+		for (int line = firstLine; line <= lastLine; ++line, dstLine -= dstPitch) {
+			for (const ClxSpan *span = spans.lineBegin(line), *end = spans.lineEnd(line); span != end; ++span) {
+				blitFn(GetSpanBlitCommand(*span, src, span->length), dstLine + (position.x + span->x), src + span->srcOffset);
+			}
+		}
+		return;
+	}
+
+	const int clipBegin = clipX.left;
+	const int clipEnd = clipX.left + clipX.width;
+	for (int line = firstLine; line <= lastLine; ++line, dstLine -= dstPitch) {
+		for (const ClxSpan *span = spans.lineBegin(line), *end = spans.lineEnd(line); span != end; ++span) {
+			const int begin = std::max<int>(span->x, clipBegin);
+			const int length = std::min<int>(span->x + span->length, clipEnd) - begin;
+			if (length <= 0)
+				continue;
+			const int srcSkip = span->type == BlitType::Pixels ? begin - span->x : 0;
+			blitFn(GetSpanBlitCommand(*span, src, length), dstLine + (position.x + begin), src + span->srcOffset + srcSkip);
+		}
+	}
+}
+
+/**
+ * @brief Renders the sprite from its span table if it has one, from its CLX commands otherwise.
+ */
+template <typename BlitFn>
+void DoRenderClx(const Surface &out, Point position, ClxSprite clx, BlitFn &&blitFn)
+{
+	const uint8_t *spanTable = clx.spanTable();
+	if (spanTable != nullptr) {
+		DoRenderSpans(out, position, clx, spanTable, std::forward<BlitFn>(blitFn));
+	} else {
+		DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), std::forward<BlitFn>(blitFn));
+	}
+}
+
 template <bool North, bool West, bool South, bool East>
 DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void RenderOutlineForPixel(uint8_t *dst, int dstPitch, uint8_t color)
 {
@@ -783,26 +883,31 @@ std::string ClxDescribe(ClxSprite clx)
 
 void ClxDraw(const Surface &out, Point position, ClxSprite clx)
 {
-	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), BlitDirect {});
+	const RenderStatsScope renderStats { RenderStatsCategory::Sprites };
+	DoRenderClx(out, position, clx, BlitDirect {});
 }
 
 void ClxDrawTRN(const Surface &out, Point position, ClxSprite clx, const uint8_t *trn)
 {
-	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), BlitWithMap { trn });
+	const RenderStatsScope renderStats { RenderStatsCategory::Sprites };
+	DoRenderClx(out, position, clx, BlitWithMapFast { trn });
 }
 
 void ClxDrawBlendedTRN(const Surface &out, Point position, ClxSprite clx, const uint8_t *trn)
 {
-	DoRenderBackwards(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), clx.height(), BlitBlendedWithMap { trn });
+	const RenderStatsScope renderStats { RenderStatsCategory::Sprites };
+	DoRenderClx(out, position, clx, BlitBlendedWithMapFast { trn });
 }
 
 void ClxDrawOutline(const Surface &out, uint8_t col, Point position, ClxSprite clx)
 {
+	const RenderStatsScope renderStats { RenderStatsCategory::Sprites };
 	RenderClxOutline</*SkipColorIndexZero=*/false>(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), col);
 }
 
 void ClxDrawOutlineSkipColorZero(const Surface &out, uint8_t col, Point position, ClxSprite clx)
 {
+	const RenderStatsScope renderStats { RenderStatsCategory::Sprites };
 	RenderClxOutline</*SkipColorIndexZero=*/true>(out, position, clx.pixelData(), clx.pixelDataSize(), clx.width(), col);
 }
 
@@ -83,7 +83,7 @@ inline void RenderClxSpriteWithTRN(const Surface &out, ClxSprite clx, Point posi
 void ClxDrawBlendedTRN(const Surface &out, Point position, ClxSprite clx, const uint8_t *trn);
 
 // defined in scrollrt.cpp
-extern int LightTableIndex;
+extern thread_local int LightTableIndex;
 
 /**
  * @brief Blit CL2 sprite, and apply lighting, to the given buffer at the given coordinates
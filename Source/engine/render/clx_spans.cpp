@@ -0,0 +1,126 @@
+#include "engine/render/clx_spans.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/clx_decode.hpp"
+#include "utils/endian.hpp"
+
+namespace devilution {
+
+namespace {
+
+constexpr size_t SpanTableLinkOffset = 6;
+
+/**
+ * @brief Calls `fn(line, span)` for every opaque run of the sprite, splitting the runs that cross a line boundary.
+ */
+template <typename Fn>
+void ForEachClxSpan(ClxSprite sprite, Fn &&fn)
+{
+	const unsigned width = sprite.width();
+	const unsigned height = sprite.height();
+	if (width == 0)
+		return;
+	const uint8_t *const begin = sprite.pixelData();
+	const uint8_t *const end = begin + sprite.pixelDataSize();
+	const uint8_t *src = begin;
+	unsigned line = 0;
+	unsigned x = 0;
+	while (src < end && line < height) {
+		const BlitCommand cmd = ClxGetBlitCommand(src);
+		if (cmd.type == BlitType::Transparent) {
+			x += cmd.length;
+			line += x / width;
+			x %= width;
+		} else {
+			auto srcOffset = static_cast<uint32_t>(src + 1 - begin);
+			unsigned remaining = cmd.length;
+			while (remaining > 0 && line < height) {
+				const unsigned length = std::min(remaining, width - x);
+				fn(line, ClxSpan { static_cast<uint16_t>(x), static_cast<uint8_t>(length), cmd.type, srcOffset });
+				if (cmd.type == BlitType::Pixels)
+					srcOffset += length;
+				remaining -= length;
+				x += length;
+				if (x == width) {
+					x = 0;
+					++line;
+				}
+			}
+		}
+		src = cmd.srcEnd;
+	}
+}
+
+size_t MeasureSpanTable(ClxSprite sprite)
+{
+	size_t numSpans = 0;
+	ForEachClxSpan(sprite, [&numSpans](unsigned, ClxSpan) { ++numSpans; });
+	return sizeof(uint32_t) * (sprite.height() + 1) + sizeof(ClxSpan) * numSpans;
+}
+
+/** @return The end of the span table. */
+uint8_t *WriteSpanTable(ClxSprite sprite, uint8_t *table)
+{
+	const unsigned height = sprite.height();
+	auto *lineStarts = reinterpret_cast<uint32_t *>(table);
+	auto *spans = reinterpret_cast<ClxSpan *>(table + sizeof(uint32_t) * (height + 1));
+	uint32_t numSpans = 0;
+	unsigned nextLine = 0;
+	ForEachClxSpan(sprite, [&](unsigned line, ClxSpan span) {
+		while (nextLine <= line)
+			lineStarts[nextLine++] = numSpans;
+		spans[numSpans++] = span;
+	});
+	while (nextLine <= height)
+		lineStarts[nextLine++] = numSpans;
+	return reinterpret_cast<uint8_t *>(&spans[numSpans]);
+}
+
+template <typename Fn>
+void ForEachClxSpriteList(const uint8_t *data, size_t size, Fn &&fn)
+{
+	const uint16_t numLists = GetNumListsFromClxListOrSheetBuffer(data, size);
+	if (numLists == 0) {
+		fn(ClxSpriteList { data });
+		return;
+	}
+	for (ClxSpriteList list : ClxSpriteSheet { data, numLists })
+		fn(list);
+}
+
+} // namespace
+
+size_t MeasureClxSpanTables(const uint8_t *data, size_t size)
+{
+	size_t result = 0;
+	ForEachClxSpriteList(data, size, [&result](ClxSpriteList list) {
+		for (ClxSprite sprite : list)
+			result += MeasureSpanTable(sprite);
+	});
+	return result;
+}
+
+void WriteClxSpanTables(uint8_t *data, size_t size, uint8_t *tables)
+{
+	ForEachClxSpriteList(data, size, [&tables, data](ClxSpriteList list) {
+		const size_t listOffset = static_cast<size_t>(list.data() - data);
+		for (size_t i = 0; i < list.numSprites(); ++i) {
+			uint8_t *sprite = &data[listOffset + list.spriteOffset(i)];
+			WriteLE32(&sprite[SpanTableLinkOffset], static_cast<uint32_t>(tables - sprite));
+			tables = WriteSpanTable(list[i], tables);
+		}
+	});
+}
+
+std::unique_ptr<uint8_t[]> CopyClxWithSpanTables(const uint8_t *data, size_t size)
+{
+	const size_t tablesOffset = GetClxSpanTablesOffset(size);
+	std::unique_ptr<uint8_t[]> result { new uint8_t[tablesOffset + MeasureClxSpanTables(data, size)] };
+	std::memcpy(result.get(), data, size);
+	WriteClxSpanTables(result.get(), size, &result[tablesOffset]);
+	return result;
+}
+
+} // namespace devilution
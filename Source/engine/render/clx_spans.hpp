@@ -0,0 +1,93 @@
+/**
+ * @file clx_spans.hpp
+ *
+ * Precompiled line spans of CLX sprites.
+ *
+ * Drawing a sprite straight from its CLX commands means decoding every skipped line when the sprite is clipped,
+ * and dispatching on every transparent run. The span table of a sprite instead lists the opaque runs of each line,
+ * so that any line can be reached directly and only opaque pixels are visited.
+ *
+ * Span tables are built at load time and stored in the same buffer as the sprites, after the end of the CLX data.
+ * Each sprite links to its table through bytes 6..10 of its frame header, see `ClxSprite::spanTable()`.
+ *
+ * Span table layout:
+ *
+ *      uint32_t lineStarts[height + 1]; // Index of the first span of each line, bottom line first.
+ *      ClxSpan spans[];
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+
+#include "engine/clx_sprite.hpp"
+#include "engine/render/blit_impl.hpp"
+
+namespace devilution {
+
+/** @brief A run of opaque pixels within a single line of a sprite. */
+struct ClxSpan {
+	/** @brief Distance from the left edge of the sprite. */
+	uint16_t x;
+	uint8_t length;
+	/** @brief Either `BlitType::Pixels` or `BlitType::Fill`. */
+	BlitType type;
+	/** @brief Offset into `ClxSprite::pixelData()` of the first pixel or of the fill color. */
+	uint32_t srcOffset;
+};
+
+/** @brief The longest span, a CLX pixels command never writes more than this. */
+constexpr unsigned MaxClxSpanLength = 128;
+
+class ClxSpanTable {
+public:
+	explicit ClxSpanTable(const uint8_t *data, uint16_t height)
+	    : lineStarts_(reinterpret_cast<const uint32_t *>(data))
+	    , spans_(reinterpret_cast<const ClxSpan *>(data + sizeof(uint32_t) * (height + 1)))
+	{
+	}
+
+	/** @param line Line index, 0 being the bottom line of the sprite. */
+	[[nodiscard]] const ClxSpan *lineBegin(unsigned line) const
+	{
+		return &spans_[lineStarts_[line]];
+	}
+
+	[[nodiscard]] const ClxSpan *lineEnd(unsigned line) const
+	{
+		return &spans_[lineStarts_[line + 1]];
+	}
+
+private:
+	const uint32_t *lineStarts_;
+	const ClxSpan *spans_;
+};
+
+/** @brief Where the span tables start in a buffer with `size` bytes of CLX data. */
+constexpr size_t GetClxSpanTablesOffset(size_t size)
+{
+	return (size + alignof(ClxSpan) - 1) & ~(alignof(ClxSpan) - 1);
+}
+
+/**
+ * @brief Returns the size of the span tables of all the sprites of a CLX list or sheet.
+ */
+size_t MeasureClxSpanTables(const uint8_t *data, size_t size);
+
+/**
+ * @brief Writes the span tables of all the sprites of a CLX list or sheet and links the sprites to them.
+ *
+ * @param data CLX list or sheet.
+ * @param size Size of the CLX list or sheet.
+ * @param tables Where to write `MeasureClxSpanTables(data, size)` bytes, after `data` in the same buffer and aligned to `alignof(ClxSpan)`.
+ */
+void WriteClxSpanTables(uint8_t *data, size_t size, uint8_t *tables);
+
+/**
+ * @brief Copies a CLX list or sheet into a new buffer, followed by its span tables.
+ */
+std::unique_ptr<uint8_t[]> CopyClxWithSpanTables(const uint8_t *data, size_t size);
+
+} // namespace devilution
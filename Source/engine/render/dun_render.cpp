@@ -17,8 +17,12 @@
 #include <algorithm>
 #include <climits>
 #include <cstdint>
+#include <optional>
 
 #include "engine/render/blit_impl.hpp"
+#include "engine/render/blit_simd.hpp"
+#include "engine/render/prelit_tile_cache.hpp"
+#include "engine/render/render_stats.hpp"
 #include "levels/dun_tile.hpp"
 #include "lighting.h"
 #include "options.h"
@@ -26,7 +30,7 @@
 #ifdef DEBUG_STR
 #include "engine/render/text_render.hpp"
 #endif
-#if defined(DEBUG_STR) || defined(DUN_RENDER_STATS)
+#ifdef DEBUG_STR
 #include "utils/str_cat.hpp"
 #endif
 
@@ -175,7 +179,7 @@ template <>
 DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void RenderLineOpaque<LightType::PartiallyLit>(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, uint_fast8_t n, const uint8_t *DVL_RESTRICT tbl)
 {
 #ifndef DEBUG_RENDER_COLOR
-	BlitPixelsWithMap(dst, src, n, tbl);
+	BlitPixelsWithMapFast(dst, src, n, tbl);
 #else
 	BlitFillDirect(dst, n, tbl[DBGCOLOR]);
 #endif
@@ -188,19 +192,19 @@ DVL_ALWAYS_INLINE DVL_ATTRIBUTE_HOT void RenderLineTransparent(uint8_t *DVL_REST
 template <>
 void RenderLineTransparent<LightType::FullyDark>(uint8_t *DVL_RESTRICT dst, [[maybe_unused]] const uint8_t *DVL_RESTRICT src, uint_fast8_t n, [[maybe_unused]] const uint8_t *DVL_RESTRICT tbl)
 {
-	BlitFillBlended(dst, n, 0);
+	BlitFillBlendedFast(dst, n, 0);
 }
 
 template <>
 void RenderLineTransparent<LightType::FullyLit>(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, uint_fast8_t n, [[maybe_unused]] const uint8_t *DVL_RESTRICT tbl)
 {
-	BlitPixelsBlended(dst, src, n);
+	BlitPixelsBlendedFast(dst, src, n);
 }
 
 template <>
 void RenderLineTransparent<LightType::PartiallyLit>(uint8_t *DVL_RESTRICT dst, const uint8_t *DVL_RESTRICT src, uint_fast8_t n, const uint8_t *DVL_RESTRICT tbl)
 {
-	BlitPixelsBlendedWithMap(dst, src, n, tbl);
+	BlitPixelsBlendedWithMapFast<Width>(dst, src, n, tbl);
 }
 #else // DEBUG_RENDER_COLOR
 template <LightType Light>
@@ -1088,42 +1092,28 @@ void RenderBlackTileFull(uint8_t *DVL_RESTRICT dst, uint16_t dstPitch)
 	}
 }
 
-} // namespace
-
-#ifdef DUN_RENDER_STATS
-std::unordered_map<DunRenderType, size_t, DunRenderTypeHash> DunRenderStats;
-
-std::string_view TileTypeToString(TileType tileType)
-{
-	// clang-format off
-	switch (tileType) {
-	case TileType::Square: return "Square";
-	case TileType::TransparentSquare: return "TransparentSquare";
-	case TileType::LeftTriangle: return "LeftTriangle";
-	case TileType::RightTriangle: return "RightTriangle";
-	case TileType::LeftTrapezoid: return "LeftTrapezoid";
-	case TileType::RightTrapezoid: return "RightTrapezoid";
-	default: return "???";
-	}
-	// clang-format on
-}
-
-std::string_view MaskTypeToString(MaskType maskType)
-{
-	// clang-format off
-	switch (maskType) {
-	case MaskType::Solid: return "Solid";
-	case MaskType::Transparent: return "Transparent";
-	case MaskType::Right: return "Right";
-	case MaskType::Left: return "Left";
-	case MaskType::RightFoliage: return "RightFoliage";
-	case MaskType::LeftFoliage: return "LeftFoliage";
-	default: return "???";
-	}
-	// clang-format on
+#ifndef DEBUG_RENDER_COLOR
+/**
+ * @brief Returns the light level of `tbl` if it is one of the partially lit `LightTables`.
+ *
+ * Fully lit and fully dark tiles are already cheap to render and TRNs are not cached.
+ */
+std::optional<uint8_t> GetPartialLightLevel(const uint8_t *tbl)
+{
+	const auto first = reinterpret_cast<uintptr_t>(LightTables[1].data());
+	const auto last = reinterpret_cast<uintptr_t>(LightTables[LightsMax - 1].data());
+	const auto address = reinterpret_cast<uintptr_t>(tbl);
+	if (address < first || address > last)
+		return std::nullopt;
+	const uintptr_t offset = address - reinterpret_cast<uintptr_t>(LightTables[0].data());
+	if (offset % LightTables[0].size() != 0)
+		return std::nullopt;
+	return static_cast<uint8_t>(offset / LightTables[0].size());
 }
 #endif
 
+} // namespace
+
 void RenderTile(const Surface &out, Point position,
     LevelCelBlock levelCelBlock, MaskType maskType, const uint8_t *tbl)
 {
@@ -1143,14 +1133,26 @@ void RenderTile(const Surface &out, Point position,
 	if (clip.width <= 0 || clip.height <= 0)
 		return;
 
-	const auto *pFrameTable = reinterpret_cast<const uint32_t *>(pDungeonCels.get());
-	const auto *src = reinterpret_cast<const uint8_t *>(&pDungeonCels[SDL_SwapLE32(pFrameTable[levelCelBlock.frame()])]);
+	const RenderStatsScope renderStats { RenderStatsCategory::Tiles };
+
+	const uint8_t *src = nullptr;
+#ifndef DEBUG_RENDER_COLOR
+	if (const std::optional<uint8_t> lightLevel = GetPartialLightLevel(tbl); lightLevel) {
+		// The pre-lit frame already has the light table applied, so it is rendered like a fully lit one.
+		src = GetPreLitTileFrame(pDungeonCels.get(), levelCelBlock, *lightLevel, tbl);
+		if (src != nullptr)
+			tbl = LightTables[0].data();
+	}
+#endif
+	if (src == nullptr) {
+		const auto *pFrameTable = reinterpret_cast<const uint32_t *>(pDungeonCels.get());
+		src = reinterpret_cast<const uint8_t *>(&pDungeonCels[SDL_SwapLE32(pFrameTable[levelCelBlock.frame()])]);
+	}
 	uint8_t *dst = out.at(static_cast<int>(position.x + clip.left), static_cast<int>(position.y - clip.bottom));
 	const uint16_t dstPitch = out.pitch();
 
-#ifdef DUN_RENDER_STATS
-	++DunRenderStats[DunRenderType { tile, maskType }];
-#endif
+	if (RenderStatsEnabled)
+		CountRenderedTile(tile, maskType);
 
 	switch (maskType) {
 	case MaskType::Solid:
@@ -13,11 +13,6 @@
 #include "engine/surface.hpp"
 #include "levels/dun_tile.hpp"
 
-// #define DUN_RENDER_STATS
-#ifdef DUN_RENDER_STATS
-#include <unordered_map>
-#endif
-
 namespace devilution {
 
 /**
@@ -141,28 +136,6 @@ enum class MaskType : uint8_t {
 	LeftFoliage,
 };
 
-#ifdef DUN_RENDER_STATS
-struct DunRenderType {
-	TileType tileType;
-	MaskType maskType;
-	bool operator==(const DunRenderType &other) const
-	{
-		return tileType == other.tileType && maskType == other.maskType;
-	}
-};
-struct DunRenderTypeHash {
-	size_t operator()(DunRenderType t) const noexcept
-	{
-		return std::hash<uint32_t> {}((1 < static_cast<uint8_t>(t.tileType)) | static_cast<uint8_t>(t.maskType));
-	}
-};
-extern std::unordered_map<DunRenderType, size_t, DunRenderTypeHash> DunRenderStats;
-
-std::string_view TileTypeToString(TileType tileType);
-
-std::string_view MaskTypeToString(MaskType maskType);
-#endif
-
 /**
  * @brief Blit current world CEL to the given buffer
  * @param out Target buffer
@@ -0,0 +1,224 @@
+#include "engine/render/prelit_tile_cache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <SDL_endian.h>
+
+#include "engine/render/blit_simd.hpp"
+#include "lighting.h"
+
+namespace devilution {
+
+namespace {
+
+constexpr uint32_t NoEntry = std::numeric_limits<uint32_t>::max();
+
+/** Incremented by `InvalidatePreLitTiles`, each thread's cache clears itself when it sees a new value. */
+std::atomic<uint32_t> Generation { 0 };
+
+/** Incremented by `InvalidateColorCycledPreLitTiles`. */
+std::atomic<uint32_t> ColorCyclingGeneration { 0 };
+
+/** @brief Whether `color` is one of the colors rotated by `lighting_color_cycling`. */
+bool IsColorCycled(uint8_t color)
+{
+	return color >= 1 && color <= 31;
+}
+
+/**
+ * @brief Applies `lightTable` to the pixels of a `TransparentSquare` frame, copying the run headers as they are.
+ * @return Whether any of the pixels uses a color cycled color.
+ */
+bool LightTransparentSquare(uint8_t *dst, const uint8_t *src, size_t size, const uint8_t *lightTable)
+{
+	bool usesCycledColors = false;
+	const uint8_t *const srcEnd = src + size;
+	for (auto i = 0; i < DunFrameHeight; ++i) {
+		int_fast16_t remainingWidth = DunFrameWidth;
+		while (remainingWidth > 0) {
+			auto v = static_cast<int8_t>(*src++);
+			*dst++ = static_cast<uint8_t>(v);
+			if (v > 0) {
+				usesCycledColors = usesCycledColors || std::any_of(src, src + v, IsColorCycled);
+				BlitPixelsWithMapFast(dst, src, v, lightTable);
+				src += v;
+				dst += v;
+			} else {
+				v = -v;
+			}
+			remainingWidth -= v;
+		}
+	}
+	// Anything after the last line is never read by the renderer.
+	std::copy(src, srcEnd, dst);
+	return usesCycledColors;
+}
+
+/**
+ * A least recently used cache of pre-lit frames.
+ *
+ * Frames are looked up through a table indexed by `frame * NumLightingLevels + lightLevel`.
+ * Evicted entries keep their buffer for the next frame that takes their place.
+ */
+class PreLitTileCache {
+public:
+	const uint8_t *get(const std::byte *cels, LevelCelBlock levelCelBlock, uint8_t lightLevel, const uint8_t *lightTable)
+	{
+		const uint32_t generation = Generation.load(std::memory_order_relaxed);
+		if (generation != generation_ || cels != cels_) {
+			clear();
+			generation_ = generation;
+			cels_ = cels;
+		}
+		const uint32_t colorCyclingGeneration = ColorCyclingGeneration.load(std::memory_order_relaxed);
+		if (colorCyclingGeneration != colorCyclingGeneration_) {
+			removeColorCycled();
+			colorCyclingGeneration_ = colorCyclingGeneration;
+		}
+
+		const auto *frameTable = reinterpret_cast<const uint32_t *>(cels);
+		const uint32_t numFrames = SDL_SwapLE32(frameTable[0]);
+		const uint16_t frame = levelCelBlock.frame();
+		if (frame == 0 || frame > numFrames)
+			return nullptr;
+
+		const size_t key = static_cast<size_t>(frame) * NumLightingLevels + lightLevel;
+		if (slots_.size() <= key)
+			slots_.resize((static_cast<size_t>(numFrames) + 1) * NumLightingLevels, NoEntry);
+
+		uint32_t index = slots_[key];
+		if (index != NoEntry) {
+			unlink(index);
+			pushFront(index);
+			return entries_[index].data.data();
+		}
+
+		index = allocate();
+		Entry &entry = entries_[index];
+		const uint32_t begin = SDL_SwapLE32(frameTable[frame]);
+		const uint32_t end = SDL_SwapLE32(frameTable[frame + 1]);
+		const auto *src = reinterpret_cast<const uint8_t *>(&cels[begin]);
+		const size_t size = end - begin;
+		entry.key = static_cast<uint32_t>(key);
+		entry.data.resize(size);
+		if (levelCelBlock.type() == TileType::TransparentSquare) {
+			entry.usesCycledColors = LightTransparentSquare(entry.data.data(), src, size, lightTable);
+		} else {
+			// The other tile types only consist of pixels (and padding which is never drawn).
+			entry.usesCycledColors = std::any_of(src, src + size, IsColorCycled);
+			BlitPixelsWithMapFast(entry.data.data(), src, static_cast<unsigned>(size), lightTable);
+		}
+		slots_[key] = index;
+		pushFront(index);
+		return entry.data.data();
+	}
+
+private:
+	struct Entry {
+		uint32_t key;
+		uint32_t prev;
+		uint32_t next;
+		bool usesCycledColors;
+		std::vector<uint8_t> data;
+	};
+
+	void clear()
+	{
+		slots_.clear();
+		free_.clear();
+		for (uint32_t i = 0; i < entries_.size(); ++i)
+			free_.push_back(i);
+		head_ = NoEntry;
+		tail_ = NoEntry;
+	}
+
+	void removeColorCycled()
+	{
+		for (uint32_t index = head_; index != NoEntry;) {
+			const uint32_t next = entries_[index].next;
+			if (entries_[index].usesCycledColors) {
+				unlink(index);
+				slots_[entries_[index].key] = NoEntry;
+				free_.push_back(index);
+			}
+			index = next;
+		}
+	}
+
+	uint32_t allocate()
+	{
+		if (!free_.empty()) {
+			const uint32_t index = free_.back();
+			free_.pop_back();
+			return index;
+		}
+		if (entries_.size() < PreLitTileCacheCapacity) {
+			entries_.emplace_back();
+			return static_cast<uint32_t>(entries_.size() - 1);
+		}
+		const uint32_t index = tail_;
+		unlink(index);
+		slots_[entries_[index].key] = NoEntry;
+		return index;
+	}
+
+	void unlink(uint32_t index)
+	{
+		Entry &entry = entries_[index];
+		if (entry.prev != NoEntry)
+			entries_[entry.prev].next = entry.next;
+		else
+			head_ = entry.next;
+		if (entry.next != NoEntry)
+			entries_[entry.next].prev = entry.prev;
+		else
+			tail_ = entry.prev;
+	}
+
+	void pushFront(uint32_t index)
+	{
+		Entry &entry = entries_[index];
+		entry.prev = NoEntry;
+		entry.next = head_;
+		if (head_ != NoEntry)
+			entries_[head_].prev = index;
+		head_ = index;
+		if (tail_ == NoEntry)
+			tail_ = index;
+	}
+
+	std::vector<uint32_t> slots_;
+	std::vector<Entry> entries_;
+	std::vector<uint32_t> free_;
+	uint32_t head_ = NoEntry;
+	uint32_t tail_ = NoEntry;
+	uint32_t generation_ = 0;
+	uint32_t colorCyclingGeneration_ = 0;
+	const std::byte *cels_ = nullptr;
+};
+
+} // namespace
+
+const uint8_t *GetPreLitTileFrame(const std::byte *cels, LevelCelBlock levelCelBlock, uint8_t lightLevel, const uint8_t *lightTable)
+{
+	// With multithreaded rendering every band is drawn by a different thread,
+	// keeping a cache per thread avoids locking in the hot path.
+	thread_local PreLitTileCache Cache;
+	return Cache.get(cels, levelCelBlock, lightLevel, lightTable);
+}
+
+void InvalidatePreLitTiles()
+{
+	++Generation;
+}
+
+void InvalidateColorCycledPreLitTiles()
+{
+	++ColorCyclingGeneration;
+}
+
+} // namespace devilution
@@ -0,0 +1,41 @@
+/**
+ * @file prelit_tile_cache.hpp
+ *
+ * Cache of level CEL frames with a light table already applied.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "levels/dun_tile.hpp"
+
+namespace devilution {
+
+/** @brief Maximum number of frames kept by the cache of each rendering thread. */
+constexpr size_t PreLitTileCacheCapacity = 2048;
+
+/**
+ * @brief Returns the frame of `levelCelBlock` with `lightTable` applied to all of its pixels.
+ *
+ * The returned frame is encoded the same way as the source frame and must be rendered as fully lit.
+ * Each rendering thread has its own cache, so the frame stays valid until the next call on the same thread.
+ *
+ * @param cels The level CEL file (`pDungeonCels`).
+ * @param levelCelBlock The frame to look up.
+ * @param lightLevel Index of `lightTable` in `LightTables`, part of the cache key.
+ * @param lightTable The light table to apply.
+ */
+const uint8_t *GetPreLitTileFrame(const std::byte *cels, LevelCelBlock levelCelBlock, uint8_t lightLevel, const uint8_t *lightTable);
+
+/**
+ * @brief Drops all pre-lit frames.
+ *
+ * Must be called when the level CEL file or the light tables are replaced.
+ */
+void InvalidatePreLitTiles();
+
+/** @brief Drops the pre-lit frames that use the colors rotated by `lighting_color_cycling`. */
+void InvalidateColorCycledPreLitTiles();
+
+} // namespace devilution
@@ -0,0 +1,302 @@
+#include "engine/render/render_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#include "DiabloUI/ui_flags.hpp"
+#include "engine.h"
+#include "engine/palette.h"
+#include "engine/render/text_render.hpp"
+#include "utils/format_int.hpp"
+#include "utils/logged_fstream.hpp"
+#include "utils/str_cat.hpp"
+
+namespace devilution {
+
+bool RenderStatsEnabled;
+
+namespace {
+
+constexpr size_t NumTileTypes = static_cast<size_t>(TileType::RightTrapezoid) + 1;
+constexpr size_t NumMaskTypes = static_cast<size_t>(MaskType::LeftFoliage) + 1;
+
+/** @brief Tiles and sprites are drawn on the worker threads with multithreaded rendering. */
+struct CategoryCounters {
+	std::atomic<uint32_t> count;
+	std::atomic<uint64_t> nanoseconds;
+};
+
+std::array<CategoryCounters, NumRenderStatsCategories> CurrentCounters;
+std::array<std::array<std::atomic<uint32_t>, NumMaskTypes>, NumTileTypes> CurrentTileCounts;
+std::array<std::array<uint32_t, NumMaskTypes>, NumTileTypes> LastFrameTileCounts;
+
+std::chrono::steady_clock::time_point FrameStart;
+
+std::array<RenderStatsFrame, RenderStatsHistorySize> History;
+/** @brief Index of the oldest frame once the history is full. */
+size_t HistoryStart;
+size_t HistoryCount;
+
+thread_local bool InRenderStatsScope;
+
+uint32_t ToMicroseconds(uint64_t nanoseconds)
+{
+	return static_cast<uint32_t>(std::min<uint64_t>(nanoseconds / 1000, UINT32_MAX));
+}
+
+void ResetCounters()
+{
+	for (CategoryCounters &counters : CurrentCounters) {
+		counters.count.store(0, std::memory_order_relaxed);
+		counters.nanoseconds.store(0, std::memory_order_relaxed);
+	}
+	for (auto &row : CurrentTileCounts) {
+		for (std::atomic<uint32_t> &count : row)
+			count.store(0, std::memory_order_relaxed);
+	}
+}
+
+/** @brief Formats a duration with 2 decimals, e.g. "1.25 ms". */
+std::string FormatMicroseconds(uint32_t microseconds)
+{
+	const uint32_t hundredths = (microseconds + 5) / 10;
+	const uint32_t fraction = hundredths % 100;
+	return StrCat(hundredths / 100, fraction < 10 ? ".0" : ".", fraction, " ms");
+}
+
+std::string_view TileTypeToString(TileType tileType)
+{
+	// clang-format off
+	switch (tileType) {
+	case TileType::Square: return "Square";
+	case TileType::TransparentSquare: return "TransparentSquare";
+	case TileType::LeftTriangle: return "LeftTriangle";
+	case TileType::RightTriangle: return "RightTriangle";
+	case TileType::LeftTrapezoid: return "LeftTrapezoid";
+	case TileType::RightTrapezoid: return "RightTrapezoid";
+	default: return "???";
+	}
+	// clang-format on
+}
+
+std::string_view MaskTypeToString(MaskType maskType)
+{
+	// clang-format off
+	switch (maskType) {
+	case MaskType::Solid: return "Solid";
+	case MaskType::Transparent: return "Transparent";
+	case MaskType::Right: return "Right";
+	case MaskType::Left: return "Left";
+	case MaskType::RightFoliage: return "RightFoliage";
+	case MaskType::LeftFoliage: return "LeftFoliage";
+	default: return "???";
+	}
+	// clang-format on
+}
+
+void DrawHistogram(const Surface &out, Point position)
+{
+	constexpr int BarWidth = 3;
+	constexpr int MaxBarHeight = 40;
+	const std::array<uint16_t, RenderStatsHistogramBuckets> histogram = GetRenderStatsHistogram();
+	const uint16_t maxCount = std::max<uint16_t>(1, *std::max_element(histogram.begin(), histogram.end()));
+
+	DrawHalfTransparentRectTo(out, position.x - 2, position.y - MaxBarHeight - 2, static_cast<int>(RenderStatsHistogramBuckets) * BarWidth + 4, MaxBarHeight + 4);
+	for (size_t i = 0; i < RenderStatsHistogramBuckets; ++i) {
+		if (histogram[i] == 0)
+			continue;
+		const int height = std::max(1, MaxBarHeight * histogram[i] / maxCount);
+		// Yellow up to 60 FPS, orange up to 30 FPS, red after.
+		const uint8_t color = i < 17 ? PAL8_YELLOW : (i < 33 ? PAL8_ORANGE : PAL8_RED);
+		FillRect(out, position.x + static_cast<int>(i) * BarWidth, position.y - height, BarWidth - 1, height, color);
+	}
+}
+
+} // namespace
+
+void SetRenderStatsEnabled(bool enabled)
+{
+	if (enabled && !RenderStatsEnabled) {
+		HistoryStart = 0;
+		HistoryCount = 0;
+		ResetCounters();
+	}
+	RenderStatsEnabled = enabled;
+}
+
+std::string_view RenderStatsCategoryToString(RenderStatsCategory category)
+{
+	// clang-format off
+	switch (category) {
+	case RenderStatsCategory::Tiles: return "Tiles";
+	case RenderStatsCategory::Sprites: return "Sprites";
+	case RenderStatsCategory::Text: return "Text";
+	case RenderStatsCategory::Automap: return "Automap";
+	case RenderStatsCategory::Blit: return "Blit";
+	default: return "???";
+	}
+	// clang-format on
+}
+
+void RenderStatsScope::begin(RenderStatsCategory category)
+{
+	if (InRenderStatsScope)
+		return;
+	InRenderStatsScope = true;
+	active_ = true;
+	category_ = category;
+	start_ = std::chrono::steady_clock::now();
+}
+
+void RenderStatsScope::end()
+{
+	const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+	CategoryCounters &counters = CurrentCounters[static_cast<size_t>(category_)];
+	counters.count.fetch_add(1, std::memory_order_relaxed);
+	counters.nanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+	InRenderStatsScope = false;
+}
+
+void CountRenderedTile(TileType tileType, MaskType maskType)
+{
+	CurrentTileCounts[static_cast<size_t>(tileType)][static_cast<size_t>(maskType)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void BeginRenderStatsFrame()
+{
+	if (!RenderStatsEnabled)
+		return;
+	ResetCounters();
+	FrameStart = std::chrono::steady_clock::now();
+}
+
+void EndRenderStatsFrame()
+{
+	if (!RenderStatsEnabled)
+		return;
+	RenderStatsFrame frame;
+	frame.frameMicroseconds = ToMicroseconds(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - FrameStart).count()));
+	for (size_t i = 0; i < NumRenderStatsCategories; ++i) {
+		frame.counts[i] = CurrentCounters[i].count.load(std::memory_order_relaxed);
+		frame.microseconds[i] = ToMicroseconds(CurrentCounters[i].nanoseconds.load(std::memory_order_relaxed));
+	}
+	for (size_t tileType = 0; tileType < NumTileTypes; ++tileType) {
+		for (size_t maskType = 0; maskType < NumMaskTypes; ++maskType)
+			LastFrameTileCounts[tileType][maskType] = CurrentTileCounts[tileType][maskType].load(std::memory_order_relaxed);
+	}
+
+	if (HistoryCount < RenderStatsHistorySize) {
+		History[HistoryCount++] = frame;
+	} else {
+		History[HistoryStart] = frame;
+		HistoryStart = (HistoryStart + 1) % RenderStatsHistorySize;
+	}
+}
+
+size_t GetRenderStatsFrameCount()
+{
+	return HistoryCount;
+}
+
+const RenderStatsFrame &GetRenderStatsFrame(size_t index)
+{
+	return History[(HistoryStart + index) % RenderStatsHistorySize];
+}
+
+uint32_t GetRenderedTileCount(TileType tileType, MaskType maskType)
+{
+	return LastFrameTileCounts[static_cast<size_t>(tileType)][static_cast<size_t>(maskType)];
+}
+
+std::array<uint16_t, RenderStatsHistogramBuckets> GetRenderStatsHistogram()
+{
+	std::array<uint16_t, RenderStatsHistogramBuckets> histogram {};
+	for (size_t i = 0; i < HistoryCount; ++i) {
+		const size_t bucket = std::min<size_t>(GetRenderStatsFrame(i).frameMicroseconds / 1000, RenderStatsHistogramBuckets - 1);
+		++histogram[bucket];
+	}
+	return histogram;
+}
+
+std::string FormatRenderStatsCsv()
+{
+	std::string csv = "frame,frame_us";
+	for (RenderStatsCategory category : enum_values<RenderStatsCategory>()) {
+		const std::string_view name = RenderStatsCategoryToString(category);
+		StrAppend(csv, ",", name, ",", name, "_us");
+	}
+	csv += '\n';
+	for (size_t i = 0; i < HistoryCount; ++i) {
+		const RenderStatsFrame &frame = GetRenderStatsFrame(i);
+		StrAppend(csv, static_cast<unsigned>(i), ",", frame.frameMicroseconds);
+		for (size_t category = 0; category < NumRenderStatsCategories; ++category)
+			StrAppend(csv, ",", frame.counts[category], ",", frame.microseconds[category]);
+		csv += '\n';
+	}
+	return csv;
+}
+
+bool ExportRenderStatsCsv(const std::string &path)
+{
+	const std::string csv = FormatRenderStatsCsv();
+	LoggedFStream out;
+	if (!out.Open(path.c_str(), "wb"))
+		return false;
+	const bool ok = out.Write(csv.data(), csv.size());
+	out.Close();
+	return ok;
+}
+
+void DrawRenderStats(const Surface &out)
+{
+	if (!RenderStatsEnabled || HistoryCount == 0)
+		return;
+
+	// The overlay should not measure itself.
+	InRenderStatsScope = true;
+
+	uint64_t frameMicroseconds = 0;
+	uint32_t maxFrameMicroseconds = 0;
+	std::array<uint64_t, NumRenderStatsCategories> counts {};
+	std::array<uint64_t, NumRenderStatsCategories> microseconds {};
+	for (size_t i = 0; i < HistoryCount; ++i) {
+		const RenderStatsFrame &frame = GetRenderStatsFrame(i);
+		frameMicroseconds += frame.frameMicroseconds;
+		maxFrameMicroseconds = std::max(maxFrameMicroseconds, frame.frameMicroseconds);
+		for (size_t category = 0; category < NumRenderStatsCategories; ++category) {
+			counts[category] += frame.counts[category];
+			microseconds[category] += frame.microseconds[category];
+		}
+	}
+
+	constexpr int LineHeight = 14;
+	Point position { 8, 86 };
+	DrawString(out, StrCat("Frame ", FormatMicroseconds(static_cast<uint32_t>(frameMicroseconds / HistoryCount)), " avg, ", FormatMicroseconds(maxFrameMicroseconds), " max"), position, { .flags = UiFlags::ColorRed });
+	position.y += LineHeight;
+	for (RenderStatsCategory category : enum_values<RenderStatsCategory>()) {
+		const auto index = static_cast<size_t>(category);
+		DrawString(out, RenderStatsCategoryToString(category), position, { .flags = UiFlags::ColorRed });
+		DrawString(out, FormatInteger(static_cast<int>(counts[index] / HistoryCount)), Rectangle({ position.x + 60, position.y }, Size(50, LineHeight)), { .flags = UiFlags::ColorRed | UiFlags::AlignRight });
+		DrawString(out, FormatMicroseconds(static_cast<uint32_t>(microseconds[index] / HistoryCount)), Rectangle({ position.x + 110, position.y }, Size(70, LineHeight)), { .flags = UiFlags::ColorRed | UiFlags::AlignRight });
+		position.y += LineHeight;
+	}
+
+	position.y += 44;
+	DrawHistogram(out, position);
+	position.y += 4;
+
+	for (size_t tileType = 0; tileType < NumTileTypes; ++tileType) {
+		for (size_t maskType = 0; maskType < NumMaskTypes; ++maskType) {
+			const uint32_t count = LastFrameTileCounts[tileType][maskType];
+			if (count == 0)
+				continue;
+			DrawString(out, StrCat(MaskTypeToString(static_cast<MaskType>(maskType)), " ", TileTypeToString(static_cast<TileType>(tileType))), position, { .flags = UiFlags::ColorRed });
+			DrawString(out, FormatInteger(static_cast<int>(count)), Rectangle({ position.x + 180, position.y }, Size(40, LineHeight)), { .flags = UiFlags::ColorRed | UiFlags::AlignRight });
+			position.y += LineHeight;
+		}
+	}
+
+	InRenderStatsScope = false;
+}
+
+} // namespace devilution
@@ -0,0 +1,122 @@
+/**
+ * @file render_stats.hpp
+ *
+ * Runtime render profiling: per-frame counts and timings of the rendering primitives.
+ *
+ * Collection is off by default and costs a single branch per primitive when off.
+ * It is toggled with the "Show Render Stats" option or with `render.stats()` in Lua.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "engine/render/dun_render.hpp"
+#include "engine/surface.hpp"
+#include "levels/dun_tile.hpp"
+#include "utils/enum_traits.h"
+
+namespace devilution {
+
+enum class RenderStatsCategory : uint8_t {
+	/** @brief Level tiles, see `RenderTile`. */
+	Tiles,
+	/** @brief CLX sprites that are not part of a text. */
+	Sprites,
+	/** @brief Strings, including their glyphs. */
+	Text,
+	/** @brief The automap overlay, including its text. */
+	Automap,
+	/** @brief Copies of the back buffer to the output surface. */
+	Blit,
+
+	FIRST = Tiles,
+	LAST = Blit,
+};
+
+constexpr size_t NumRenderStatsCategories = enum_size<RenderStatsCategory>::value;
+
+struct RenderStatsFrame {
+	/** @brief Time spent in `DrawAndBlit`, not including the presentation of the frame. */
+	uint32_t frameMicroseconds;
+	std::array<uint32_t, NumRenderStatsCategories> counts;
+	/** @brief Summed over all the threads, so with multithreaded rendering this can exceed the frame time. */
+	std::array<uint32_t, NumRenderStatsCategories> microseconds;
+};
+
+/** @brief The number of frames kept for the overlay and the CSV export. */
+constexpr size_t RenderStatsHistorySize = 256;
+
+/** @brief Frame time histogram buckets, 1 ms each. The last bucket also counts all the slower frames. */
+constexpr size_t RenderStatsHistogramBuckets = 34;
+
+extern bool RenderStatsEnabled;
+
+/** @brief Starts or stops collecting render stats. Starting clears the history. */
+void SetRenderStatsEnabled(bool enabled);
+
+std::string_view RenderStatsCategoryToString(RenderStatsCategory category);
+
+/**
+ * @brief Adds the time spent in its lifetime and one item to a category.
+ *
+ * Scopes nested on the same thread are ignored, so that each item is attributed to the outermost category,
+ * e.g. the glyphs of a string are counted as text and not as sprites.
+ */
+class RenderStatsScope {
+public:
+	explicit RenderStatsScope(RenderStatsCategory category)
+	{
+		if (RenderStatsEnabled)
+			begin(category);
+	}
+
+	RenderStatsScope(const RenderStatsScope &) = delete;
+	RenderStatsScope &operator=(const RenderStatsScope &) = delete;
+
+	~RenderStatsScope()
+	{
+		if (active_)
+			end();
+	}
+
+private:
+	void begin(RenderStatsCategory category);
+	void end();
+
+	bool active_ = false;
+	RenderStatsCategory category_ = RenderStatsCategory::FIRST;
+	std::chrono::steady_clock::time_point start_;
+};
+
+/** @brief Records the shapes and masks of the tiles, only call this when `RenderStatsEnabled`. */
+void CountRenderedTile(TileType tileType, MaskType maskType);
+
+void BeginRenderStatsFrame();
+
+/** @brief Moves the counts and timings collected since `BeginRenderStatsFrame` to the history. */
+void EndRenderStatsFrame();
+
+/** @brief The number of frames in the history. */
+size_t GetRenderStatsFrameCount();
+
+/** @param index 0 is the oldest frame in the history. */
+const RenderStatsFrame &GetRenderStatsFrame(size_t index);
+
+/** @brief The number of tiles with the given shape and mask in the last frame. */
+uint32_t GetRenderedTileCount(TileType tileType, MaskType maskType);
+
+std::array<uint16_t, RenderStatsHistogramBuckets> GetRenderStatsHistogram();
+
+/** @brief Formats the history as CSV, one frame per row, oldest first. */
+std::string FormatRenderStatsCsv();
+
+bool ExportRenderStatsCsv(const std::string &path);
+
+/** @brief Draws the averages over the history, the frame time histogram and the tiles of the last frame. */
+void DrawRenderStats(const Surface &out);
+
+} // namespace devilution
@@ -5,8 +5,14 @@
  */
 #include "engine/render/scrollrt.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "DiabloUI/ui_flags.hpp"
 #include "automap.h"
@@ -19,7 +25,9 @@
 #include "engine/dx.h"
 #include "engine/render/clx_render.hpp"
 #include "engine/render/dun_render.hpp"
+#include "engine/render/render_stats.hpp"
 #include "engine/render/text_render.hpp"
+#include "engine/render/view_change_tracker.hpp"
 #include "engine/trn.hpp"
 #include "engine/world_tile.hpp"
 #include "gmenu.h"
@@ -45,11 +53,13 @@
 #include "qol/xpbar.h"
 #include "stores.h"
 #include "towners.h"
+#include "utils/algorithm/container.hpp"
 #include "utils/bitset2d.hpp"
 #include "utils/display.h"
 #include "utils/endian.hpp"
 #include "utils/log.hpp"
 #include "utils/str_cat.hpp"
+#include "utils/thread_pool.hpp"
 
 #ifndef USE_SDL1
 #include "controls/touch/renderers.h"
@@ -59,16 +69,14 @@
 #include "debug.h"
 #endif
 
-#ifdef DUN_RENDER_STATS
-#include "utils/format_int.hpp"
-#endif
-
 namespace devilution {
 
 /**
  * Specifies the current light entry.
+ *
+ * Thread-local so that the view can be drawn in parallel bands.
  */
-int LightTableIndex;
+thread_local int LightTableIndex;
 
 bool AutoMapShowItems;
 
@@ -80,9 +88,107 @@ bool frameflag;
 namespace {
 
 /**
- * @brief Contains all Missile at rendering position
+ * @brief A horizontal slice of the viewport that is drawn independently of the others.
+ *
+ * Every band walks the same tiles and relies on clipping to its surface, so the result matches
+ * drawing the whole viewport at once. Side effects that must happen once per tile are only
+ * performed by the band that owns the tile, i.e. the band containing the tile's anchor point.
+ */
+struct RenderBand {
+	/** @brief Y coordinate of the band's surface in the viewport. */
+	int top;
+	/** @brief Y coordinate of the first row below the band's surface. */
+	int bottom;
+	/** @brief The band owns the tiles with a viewport Y coordinate in `[ownedTop, ownedBottom)`. */
+	int ownedTop;
+	int ownedBottom;
+	/** @brief Item labels found while drawing the band, queued in drawing order after all bands are done. */
+	std::vector<std::pair<int8_t, Point>> itemLabels;
+
+	[[nodiscard]] Point toViewport(Point bandPosition) const
+	{
+		return bandPosition + Displacement { 0, top };
+	}
+
+	[[nodiscard]] bool ownsTile(Point targetBufferPosition) const
+	{
+		const int y = toViewport(targetBufferPosition).y;
+		return y >= ownedTop && y < ownedBottom;
+	}
+};
+
+/** @brief Bands thinner than this do not pay for the per-band walk over the tiles. */
+constexpr int MinRenderBandHeight = 4 * TILE_HEIGHT;
+
+/**
+ * @brief How far above and below a tile's screen position anything drawn for the tile can reach.
+ *
+ * Covers the tallest dungeon pieces, large sprites and the offsets of walking actors and missiles.
+ */
+constexpr int TileReachAbove = 12 * TILE_HEIGHT;
+constexpr int TileReachBelow = 2 * TILE_HEIGHT;
+
+/** @brief Tracks which parts of the view changed when only redrawing those. */
+ViewChangeTracker ViewChanges { TileReachAbove, TileReachBelow };
+
+/** @brief The view as of the last frame, without anything drawn on top of it. */
+std::optional<OwnedSurface> WorldLayer;
+
+/**
+ * @brief Missiles bucketed by rendering position
+ *
+ * Each tile holds the head of a chain through `entries_`, so looking up a tile is proportional to the missiles on it
+ * and rebuilding the index every frame does not allocate once the vector has grown.
  */
-std::unordered_multimap<WorldTilePosition, Missile *> MissilesAtRenderingTile;
+class MissileRenderingIndex {
+public:
+	MissileRenderingIndex()
+	{
+		for (auto &column : head_)
+			std::fill(std::begin(column), std::end(column), NoMissile);
+	}
+
+	void rebuild()
+	{
+		for (const Entry &entry : entries_)
+			head_[entry.tile.x][entry.tile.y] = NoMissile;
+		entries_.clear();
+
+		for (Missile &missile : Missiles) {
+			if (InDungeonBounds(missile.position.tileForRendering))
+				entries_.push_back({ &missile, missile.position.tileForRendering, NoMissile });
+		}
+		// Chain the missiles in reverse so that each tile lists them in the order they were added.
+		for (size_t i = entries_.size(); i-- > 0;) {
+			Entry &entry = entries_[i];
+			entry.next = head_[entry.tile.x][entry.tile.y];
+			head_[entry.tile.x][entry.tile.y] = static_cast<int>(i);
+		}
+	}
+
+	template <typename F>
+	void forEachAt(WorldTilePosition tile, F &&f) const
+	{
+		if (!InDungeonBounds(tile))
+			return;
+		for (int i = head_[tile.x][tile.y]; i != NoMissile; i = entries_[i].next)
+			f(*entries_[i].missile);
+	}
+
+private:
+	static constexpr int NoMissile = -1;
+
+	struct Entry {
+		Missile *missile;
+		WorldTilePosition tile;
+		int next;
+	};
+
+	std::vector<Entry> entries_;
+	int head_[MAXDUNX][MAXDUNY];
+};
+
+MissileRenderingIndex MissilesAtRenderingTile;
 
 /**
  * @brief Could the missile (at the next game tick) collide? This method is a simplified version of CheckMissileCol (for example without random).
@@ -158,12 +264,10 @@ void UpdateMissileRendererData(Missile &m)
 
 void UpdateMissilesRendererData()
 {
-	MissilesAtRenderingTile.clear();
-
 	for (auto &m : Missiles) {
 		UpdateMissileRendererData(m);
-		MissilesAtRenderingTile.insert(std::make_pair(m.position.tileForRendering, &m));
 	}
+	MissilesAtRenderingTile.rebuild();
 }
 
 int lastFpsUpdateInMs;
@@ -288,10 +392,9 @@ void DrawMissilePrivate(const Surface &out, const Missile &missile, Point target
  */
 void DrawMissile(const Surface &out, WorldTilePosition tilePosition, Point targetBufferPosition, bool pre)
 {
-	const auto [begin, end] = MissilesAtRenderingTile.equal_range(tilePosition);
-	for (auto it = begin; it != end; ++it) {
-		DrawMissilePrivate(out, *it->second, targetBufferPosition, pre);
-	}
+	MissilesAtRenderingTile.forEachAt(tilePosition, [&](const Missile &missile) {
+		DrawMissilePrivate(out, missile, targetBufferPosition, pre);
+	});
 }
 
 /**
@@ -412,6 +515,11 @@ void DrawPlayer(const Surface &out, const Player &player, Point tilePosition, Po
 	LightTableIndex = l;
 }
 
+bool IsDeadPlayerAt(const Player &player, Point tilePosition)
+{
+	return player.plractive && player._pHitPoints == 0 && player.isOnActiveLevel() && player.position.tile == tilePosition;
+}
+
 /**
  * @brief Render a player sprite
  * @param out Output buffer
@@ -420,11 +528,8 @@ void DrawPlayer(const Surface &out, const Player &player, Point tilePosition, Po
  */
 void DrawDeadPlayer(const Surface &out, Point tilePosition, Point targetBufferPosition)
 {
-	dFlags[tilePosition.x][tilePosition.y] &= ~DungeonFlag::DeadPlayer;
-
 	for (Player &player : Players) {
-		if (player.plractive && player._pHitPoints == 0 && player.isOnActiveLevel() && player.position.tile == tilePosition) {
-			dFlags[tilePosition.x][tilePosition.y] |= DungeonFlag::DeadPlayer;
+		if (IsDeadPlayerAt(player, tilePosition)) {
 			const Point playerRenderPosition { targetBufferPosition };
 			DrawPlayer(out, player, tilePosition, playerRenderPosition);
 		}
@@ -455,7 +560,7 @@ void DrawObject(const Surface &out, const Object &objectToDraw, Point tilePositi
 	}
 }
 
-static void DrawDungeon(const Surface & /*out*/, Point /*tilePosition*/, Point /*targetBufferPosition*/);
+static void DrawDungeon(const Surface & /*out*/, Point /*tilePosition*/, Point /*targetBufferPosition*/, RenderBand & /*band*/);
 
 /**
  * @brief Render a cell
@@ -608,9 +713,9 @@ void DrawFloor(const Surface &out, Point tilePosition, Point targetBufferPositio
  * @param out Output buffer
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Output buffer coordinates
- * @param pre Is the sprite in the background
+ * @param band The band being drawn
  */
-void DrawItem(const Surface &out, int8_t itemIndex, Point targetBufferPosition)
+void DrawItem(const Surface &out, int8_t itemIndex, Point targetBufferPosition, RenderBand &band)
 {
 	const Item &item = Items[itemIndex];
 	const ClxSprite sprite = item.AnimInfo.currentSprite();
@@ -619,8 +724,8 @@ void DrawItem(const Surface &out, int8_t itemIndex, Point targetBufferPosition)
 		ClxDrawOutlineSkipColorZero(out, GetOutlineColor(item, false), position, sprite);
 	}
 	ClxDrawLight(out, position, sprite);
-	if (item.AnimInfo.isLastFrame() || item._iCurs == ICURS_MAGIC_ROCK)
-		AddItemToLabelQueue(itemIndex, position);
+	if ((item.AnimInfo.isLastFrame() || item._iCurs == ICURS_MAGIC_ROCK) && band.ownsTile(targetBufferPosition))
+		band.itemLabels.emplace_back(itemIndex, band.toViewport(position));
 }
 
 /**
@@ -700,8 +805,9 @@ void DrawPlayerHelper(const Surface &out, const Player &player, Point tilePositi
  * @param out Target buffer
  * @param tilePosition dPiece coordinates
  * @param targetBufferPosition Target buffer coordinates
+ * @param band The band being drawn
  */
-void DrawDungeon(const Surface &out, Point tilePosition, Point targetBufferPosition)
+void DrawDungeon(const Surface &out, Point tilePosition, Point targetBufferPosition, RenderBand &band)
 {
 	assert(InDungeonBounds(tilePosition));
 	LightTableIndex = dLight[tilePosition.x][tilePosition.y];
@@ -741,7 +847,7 @@ void DrawDungeon(const Surface &out, Point tilePosition, Point targetBufferPosit
 		DrawObject(out, *object, tilePosition, targetBufferPosition);
 	}
 	if (bItem > 0 && !Items[bItem - 1]._iPostDraw) {
-		DrawItem(out, static_cast<int8_t>(bItem - 1), targetBufferPosition);
+		DrawItem(out, static_cast<int8_t>(bItem - 1), targetBufferPosition, band);
 	}
 
 	if (TileContainsDeadPlayer(tilePosition)) {
@@ -760,7 +866,7 @@ void DrawDungeon(const Surface &out, Point tilePosition, Point targetBufferPosit
 		DrawObject(out, *object, tilePosition, targetBufferPosition);
 	}
 	if (bItem > 0 && Items[bItem - 1]._iPostDraw) {
-		DrawItem(out, static_cast<int8_t>(bItem - 1), targetBufferPosition);
+		DrawItem(out, static_cast<int8_t>(bItem - 1), targetBufferPosition, band);
 	}
 
 	if (leveltype != DTYPE_TOWN) {
@@ -781,7 +887,7 @@ void DrawDungeon(const Surface &out, Point tilePosition, Point targetBufferPosit
 		// Tree leaves should always cover player when entering or leaving the tile,
 		// So delay the rendering until after the next row is being drawn.
 		// This could probably have been better solved by sprites in screen space.
-		if (tilePosition.x > 0 && tilePosition.y > 0 && targetBufferPosition.y > TILE_HEIGHT) {
+		if (tilePosition.x > 0 && tilePosition.y > 0 && band.toViewport(targetBufferPosition).y > TILE_HEIGHT) {
 			char bArch = dSpecial[tilePosition.x - 1][tilePosition.y - 1];
 			if (bArch != 0) {
 				ClxDraw(out, targetBufferPosition + Displacement { 0, -TILE_HEIGHT }, (*pSpecialCels)[bArch - 1]);
@@ -841,8 +947,9 @@ void DrawFloor(const Surface &out, Point tilePosition, Point targetBufferPositio
  * @param targetBufferPosition Buffer coordinates
  * @param rows Number of rows
  * @param columns Tile in a row
+ * @param band The band being drawn
  */
-void DrawTileContent(const Surface &out, Point tilePosition, Point targetBufferPosition, int rows, int columns)
+void DrawTileContent(const Surface &out, Point tilePosition, Point targetBufferPosition, int rows, int columns, RenderBand &band)
 {
 	// Keep evaluating until MicroTiles can't affect screen
 	rows += MicroTileLen;
@@ -852,9 +959,6 @@ void DrawTileContent(const Surface &out, Point tilePosition, Point targetBufferP
 		for (int j = 0; j < columns; j++) {
 			if (InDungeonBounds(tilePosition)) {
 				bool skipNext = false;
-#ifdef _DEBUG
-				DebugCoordsMap[tilePosition.x + tilePosition.y * MAXDUNX] = targetBufferPosition;
-#endif
 				if (tilePosition.x + 1 < MAXDUNX && tilePosition.y - 1 >= 0 && targetBufferPosition.x + TILE_WIDTH <= gnScreenWidth) {
 					// Render objects behind walls first to prevent sprites, that are moving
 					// between tiles, from poking through the walls as they exceed the tile bounds.
@@ -862,13 +966,13 @@ void DrawTileContent(const Surface &out, Point tilePosition, Point targetBufferP
 					// sprite screen position rather than tile position.
 					if (IsWall(tilePosition) && (IsWall(tilePosition + Displacement { 1, 0 }) || (tilePosition.x > 0 && IsWall(tilePosition + Displacement { -1, 0 })))) { // Part of a wall aligned on the x-axis
 						if (IsTileNotSolid(tilePosition + Displacement { 1, -1 }) && IsTileNotSolid(tilePosition + Displacement { 0, -1 })) {                              // Has walkable area behind it
-							DrawDungeon(out, tilePosition + Direction::East, { targetBufferPosition.x + TILE_WIDTH, targetBufferPosition.y });
+							DrawDungeon(out, tilePosition + Direction::East, { targetBufferPosition.x + TILE_WIDTH, targetBufferPosition.y }, band);
 							skipNext = true;
 						}
 					}
 				}
 				if (!skip) {
-					DrawDungeon(out, tilePosition, targetBufferPosition);
+					DrawDungeon(out, tilePosition, targetBufferPosition, band);
 				}
 				skip = skipNext;
 			}
@@ -893,6 +997,288 @@ void DrawTileContent(const Surface &out, Point tilePosition, Point targetBufferP
 	}
 }
 
+/**
+ * @brief Update the dungeon state that tile content drawing depends on, so that drawing itself has no side effects.
+ *
+ * Walks the same tiles as `DrawTileContent`: clears `DungeonFlag::DeadPlayer` for tiles whose dead player is gone
+ * and, in debug builds, records the screen coordinates of each tile.
+ * @param tilePosition dPiece coordinates
+ * @param targetBufferPosition Buffer coordinates
+ * @param rows Number of rows
+ * @param columns Tile in a row
+ */
+void PrepareTileContent(Point tilePosition, [[maybe_unused]] Point targetBufferPosition, int rows, int columns)
+{
+	rows += MicroTileLen;
+
+	for (int i = 0; i < rows; i++) {
+		for (int j = 0; j < columns; j++) {
+			if (InDungeonBounds(tilePosition)) {
+#ifdef _DEBUG
+				DebugCoordsMap[tilePosition.x + tilePosition.y * MAXDUNX] = targetBufferPosition;
+#endif
+				if (TileContainsDeadPlayer(tilePosition)) {
+					const bool hasDeadPlayer = c_any_of(Players, [tilePosition](const Player &player) { return IsDeadPlayerAt(player, tilePosition); });
+					if (!hasDeadPlayer)
+						dFlags[tilePosition.x][tilePosition.y] &= ~DungeonFlag::DeadPlayer;
+				}
+			}
+			tilePosition += Direction::East;
+			targetBufferPosition.x += TILE_WIDTH;
+		}
+		// Return to start of row
+		tilePosition += Displacement(Direction::West) * columns;
+		targetBufferPosition.x -= columns * TILE_WIDTH;
+
+		// Jump to next row
+		targetBufferPosition.y += TILE_HEIGHT / 2;
+		if ((i & 1) != 0) {
+			tilePosition.x++;
+			columns--;
+			targetBufferPosition.x += TILE_WIDTH / 2;
+		} else {
+			tilePosition.y++;
+			columns++;
+			targetBufferPosition.x -= TILE_WIDTH / 2;
+		}
+	}
+}
+
+void QueueItemLabels(const RenderBand &band)
+{
+	for (const auto &[itemIndex, position] : band.itemLabels)
+		AddItemToLabelQueue(itemIndex, position);
+}
+
+/**
+ * @brief Splits the view into equally sized rows, one for each thread that can take part in drawing.
+ * @param height Height of the view
+ * @param parallel Whether the rows will be drawn on the worker threads
+ */
+std::vector<RowSpan> GetBandSpans(int height, bool parallel)
+{
+	const int numBands = parallel
+	    ? std::max(1, std::min(static_cast<int>(GetWorkerThreadPool().numWorkers()) + 1, height / MinRenderBandHeight))
+	    : 1;
+	std::vector<RowSpan> spans(numBands);
+	for (int i = 0; i < numBands; i++)
+		spans[i] = RowSpan { height * i / numBands, height * (i + 1) / numBands };
+	return spans;
+}
+
+/**
+ * @brief Draw the floor and tile content of the given rows of the view, each in its own band.
+ * @param out Buffer to render to
+ * @param tilePosition dPiece coordinates of the first tile
+ * @param targetBufferPosition Buffer coordinates of the first tile
+ * @param rows Number of rows
+ * @param columns Tile in a row
+ * @param spans Rows of `out` to draw, sorted and non-overlapping
+ * @param parallel Whether to draw the bands on the worker threads
+ */
+void DrawTilesInBands(const Surface &out, Point tilePosition, Point targetBufferPosition, int rows, int columns, const std::vector<RowSpan> &spans, bool parallel)
+{
+	static std::vector<RenderBand> bands;
+	bands.resize(spans.size());
+	for (size_t i = 0; i < spans.size(); i++) {
+		RenderBand &band = bands[i];
+		band.top = spans[i].top;
+		band.bottom = spans[i].bottom;
+		band.ownedTop = i == 0 ? std::numeric_limits<int>::min() : band.top;
+		band.ownedBottom = i == spans.size() - 1 ? std::numeric_limits<int>::max() : band.bottom;
+		band.itemLabels.clear();
+	}
+
+	const auto drawBand = [&](unsigned i) {
+		RenderBand &band = bands[i];
+		const Surface bandOut = out.subregionY(band.top, band.bottom - band.top);
+		const Point bandPosition = targetBufferPosition - Displacement { 0, band.top };
+		DrawFloor(bandOut, tilePosition, bandPosition, rows, columns);
+		DrawTileContent(bandOut, tilePosition, bandPosition, rows, columns, band);
+	};
+	if (parallel && bands.size() > 1) {
+		GetWorkerThreadPool().parallelFor(static_cast<unsigned>(bands.size()), drawBand);
+	} else {
+		for (unsigned i = 0; i < bands.size(); i++)
+			drawBand(i);
+	}
+
+	for (const RenderBand &band : bands)
+		QueueItemLabels(band);
+}
+
+/**
+ * @brief Computes a fingerprint of everything that is drawn for the given tile.
+ *
+ * Mirrors the state read by `DrawFloor` and `DrawDungeon`, if the two diverge the view is not redrawn when it should be.
+ */
+uint64_t GetTileFingerprint(Point tilePosition)
+{
+	Fingerprint fingerprint;
+	if (!InDungeonBounds(tilePosition))
+		return fingerprint.value();
+
+	const int x = tilePosition.x;
+	const int y = tilePosition.y;
+	const int8_t transVal = dTransVal[x][y];
+	fingerprint.add(dPiece[x][y], dLight[x][y], static_cast<uint8_t>(dFlags[x][y]), transVal, TransList[transVal], dSpecial[x][y], dCorpse[x][y]);
+	if (leveltype == DTYPE_TOWN && x > 0 && y > 0)
+		fingerprint.add(dSpecial[x - 1][y - 1]);
+
+	const int8_t bItem = dItem[x][y];
+	fingerprint.add(bItem);
+	if (bItem > 0) {
+		const Item &item = Items[bItem - 1];
+		fingerprint.add(item.AnimInfo.currentSprite().pixelData(), item._iPostDraw, bItem - 1 == pcursitem);
+	}
+
+	if (dLight[x][y] < LightsMax) {
+		const Object *object = FindObjectAtPosition(tilePosition);
+		if (object != nullptr) {
+			const ClxSprite sprite = object->currentSprite();
+			const Displacement offset = object->getRenderingOffset(sprite, tilePosition);
+			fingerprint.add(sprite.pixelData(), offset.deltaX, offset.deltaY, object->_oPreFlag, object->applyLighting, object == ObjectUnderCursor);
+		}
+	}
+
+	const auto addPlayer = [&](const Player &player) {
+		const ClxSprite sprite = player.currentSprite();
+		const Displacement offset = player.getRenderingOffset(sprite);
+		fingerprint.add(sprite.pixelData(), offset.deltaX, offset.deltaY, &player == PlayerUnderCursor, player.pManaShield, player.wReflections > 0);
+	};
+	const bool playersVisible = IsTileLit(tilePosition) || MyPlayer->_pInfraFlag || MyPlayer->isOnArenaLevel() || leveltype == DTYPE_TOWN;
+	const int8_t playerId = dPlayer[x][y];
+	fingerprint.add(playerId);
+	if (playersVisible) {
+		if (TileContainsDeadPlayer(tilePosition)) {
+			for (const Player &player : Players) {
+				if (IsDeadPlayerAt(player, tilePosition))
+					addPlayer(player);
+			}
+		}
+		if (static_cast<size_t>(playerId - 1) < Players.size())
+			addPlayer(Players[playerId - 1]);
+	}
+
+	const int monsterId = dMonster[x][y];
+	fingerprint.add(monsterId);
+	if (monsterId != 0) {
+		const int mi = std::abs(monsterId) - 1;
+		if (leveltype == DTYPE_TOWN) {
+			if (monsterId > 0) {
+				const Towner &towner = Towners[mi];
+				fingerprint.add(towner.currentSprite().pixelData(), towner._tAnimWidth, mi == pcursmonst);
+			}
+		} else if (static_cast<size_t>(mi) < MaxMonsters) {
+			const Monster &monster = Monsters[mi];
+			fingerprint.add(monster.mode, monster.direction, monster.flags, mi == pcursmonst);
+			if (monster.animInfo.sprites) {
+				const ClxSprite sprite = monster.animInfo.currentSprite();
+				const Displacement offset = monster.getRenderingOffset(sprite);
+				fingerprint.add(sprite.pixelData(), offset.deltaX, offset.deltaY, monster.uniqueMonsterTRN.get());
+			}
+		}
+	}
+
+	MissilesAtRenderingTile.forEachAt(tilePosition, [&fingerprint](const Missile &missile) {
+		fingerprint.add(missile._miPreFlag, missile._miDrawFlag);
+		if (!missile._miDrawFlag)
+			return;
+		fingerprint.add((*missile._miAnimData)[missile._miAnimFrame - 1].pixelData(), missile.position.offsetForRendering.deltaX, missile.position.offsetForRendering.deltaY,
+		    missile._miAnimWidth2, missile._miLightFlag, missile._miUniqTrans, missile._misource);
+	});
+
+	return fingerprint.value();
+}
+
+/**
+ * @brief Computes a fingerprint of the state that affects the whole view. When it changes, the view is redrawn entirely.
+ */
+uint64_t GetViewFingerprint(const Surface &out, Point tilePosition, Point targetBufferPosition, int rows, int columns)
+{
+	Fingerprint fingerprint;
+	fingerprint.add(out.w(), out.h(), tilePosition.x, tilePosition.y, targetBufferPosition.x, targetBufferPosition.y, rows, columns);
+	fingerprint.add(leveltype, currlevel, setlevel, pDungeonCels.get(), MicroTileLen);
+	fingerprint.add(MyPlayer->_pInfraFlag, MyPlayer->isOnArenaLevel(), AutoMapShowItems, stextflag == TalkID::None, MissilePreFlag);
+	fingerprint.addBytes(LightTables.data(), sizeof(LightTables));
+#ifdef _DEBUG
+	fingerprint.add(DebugVision, (SDL_GetModState() & KMOD_ALT) != 0);
+#endif
+	return fingerprint.value();
+}
+
+/**
+ * @brief Feed the fingerprint of every tile that `DrawTileContent` walks to `ViewChanges`.
+ * @param tilePosition dPiece coordinates of the first tile
+ * @param targetBufferPosition Buffer coordinates of the first tile
+ * @param rows Number of rows
+ * @param columns Tile in a row
+ */
+void TrackTileChanges(Point tilePosition, Point targetBufferPosition, int rows, int columns)
+{
+	// Keep evaluating until MicroTiles can't affect screen
+	rows += MicroTileLen;
+
+	for (int i = 0; i < rows; i++) {
+		for (int j = 0; j < columns; j++) {
+			ViewChanges.addTile(GetTileFingerprint(tilePosition), targetBufferPosition.y);
+			tilePosition += Direction::East;
+			targetBufferPosition.x += TILE_WIDTH;
+		}
+		// Return to start of row
+		tilePosition += Displacement(Direction::West) * columns;
+		targetBufferPosition.x -= columns * TILE_WIDTH;
+
+		// Jump to next row
+		targetBufferPosition.y += TILE_HEIGHT / 2;
+		if ((i & 1) != 0) {
+			tilePosition.x++;
+			columns--;
+			targetBufferPosition.x += TILE_WIDTH / 2;
+		} else {
+			tilePosition.y++;
+			columns++;
+			targetBufferPosition.x -= TILE_WIDTH / 2;
+		}
+	}
+}
+
+/**
+ * @brief Draw the floor and tile content of the view, only redrawing the rows that changed since the last frame.
+ *
+ * The view is kept in `WorldLayer` and copied to `out`, because everything drawn on top of it changes independently.
+ * @param out Buffer to render to
+ * @param tilePosition dPiece coordinates of the first tile
+ * @param targetBufferPosition Buffer coordinates of the first tile
+ * @param rows Number of rows
+ * @param columns Tile in a row
+ */
+void DrawChangedTiles(const Surface &out, Point tilePosition, Point targetBufferPosition, int rows, int columns)
+{
+	if (!WorldLayer || WorldLayer->w() != out.w() || WorldLayer->h() != out.h()) {
+		WorldLayer.emplace(out.w(), out.h());
+		ViewChanges.invalidate();
+	}
+	// Item labels are collected while drawing the tiles, so they need all of them to be drawn.
+	if (IsRedrawEverything() || IsHighlightingLabelsEnabled())
+		ViewChanges.invalidate();
+#ifdef _DEBUG
+	if (DebugPath)
+		ViewChanges.invalidate();
+#endif
+
+	ViewChanges.beginFrame(GetViewFingerprint(out, tilePosition, targetBufferPosition, rows, columns), out.h());
+	TrackTileChanges(tilePosition, targetBufferPosition, rows, columns);
+	const bool parallel = *sgOptions.Graphics.multithreadedRendering;
+	if (ViewChanges.endFrame()) {
+		DrawTilesInBands(*WorldLayer, tilePosition, targetBufferPosition, rows, columns, GetBandSpans(out.h(), parallel), parallel);
+	} else if (!ViewChanges.dirtySpans().empty()) {
+		DrawTilesInBands(*WorldLayer, tilePosition, targetBufferPosition, rows, columns, ViewChanges.dirtySpans(), parallel);
+	}
+
+	out.BlitFrom(*WorldLayer, MakeSdlRect(0, 0, out.w(), out.h()), Point { 0, 0 });
+}
+
 /**
  * @brief Scale up the top left part of the buffer 2x.
  */
@@ -1047,34 +1433,18 @@ void DrawGame(const Surface &fullOut, Point position, Displacement offset)
 		}
 	}
 
-#ifdef DUN_RENDER_STATS
-	DunRenderStats.clear();
-#endif
-
-	DrawFloor(out, position, Point {} + offset, rows, columns);
-	DrawTileContent(out, position, Point {} + offset, rows, columns);
+	PrepareTileContent(position, Point {} + offset, rows, columns);
+	if (*sgOptions.Graphics.incrementalRendering) {
+		DrawChangedTiles(out, position, Point {} + offset, rows, columns);
+	} else {
+		WorldLayer = std::nullopt;
+		const bool parallel = *sgOptions.Graphics.multithreadedRendering;
+		DrawTilesInBands(out, position, Point {} + offset, rows, columns, GetBandSpans(out.h(), parallel), parallel);
+	}
 
 	if (*sgOptions.Graphics.zoom) {
 		Zoom(fullOut.subregionY(0, gnViewportHeight));
 	}
-
-#ifdef DUN_RENDER_STATS
-	std::vector<std::pair<DunRenderType, size_t>> sortedStats(DunRenderStats.begin(), DunRenderStats.end());
-	c_sort(sortedStats, [](const std::pair<DunRenderType, size_t> &a, const std::pair<DunRenderType, size_t> &b) {
-		return a.first.maskType == b.first.maskType
-		    ? static_cast<uint8_t>(a.first.tileType) < static_cast<uint8_t>(b.first.tileType)
-		    : static_cast<uint8_t>(a.first.maskType) < static_cast<uint8_t>(b.first.maskType);
-	});
-	Point pos { 100, 20 };
-	for (size_t i = 0; i < sortedStats.size(); ++i) {
-		const auto &stat = sortedStats[i];
-		DrawString(out, StrCat(i, "."), Rectangle(pos, Size { 20, 16 }), { .flags = UiFlags::AlignRight });
-		DrawString(out, MaskTypeToString(stat.first.maskType), { pos.x + 24, pos.y });
-		DrawString(out, TileTypeToString(stat.first.tileType), { pos.x + 184, pos.y });
-		DrawString(out, FormatInteger(stat.second), Rectangle({ pos.x + 354, pos.y }, Size(40, 16)), { .flags = UiFlags::AlignRight });
-		pos.y += 16;
-	}
-#endif
 }
 
 /**
@@ -1092,6 +1462,9 @@ void DrawView(const Surface &out, Point startPosition)
 	DrawGame(out, startPosition, offset);
 	if (AutomapActive) {
 		DrawAutomap(out.subregionY(0, gnViewportHeight));
+	} else {
+		// The layer can take up several MiB, don't keep it around while the automap is closed.
+		ReleaseAutomapLayer();
 	}
 #ifdef _DEBUG
 	bool debugGridTextNeeded = IsDebugGridTextNeeded();
@@ -1623,6 +1996,8 @@ void DrawAndBlit()
 		hgt = gnViewportHeight;
 	}
 
+	BeginRenderStatsFrame();
+
 	const Surface &out = GlobalBackBuffer();
 	UndrawCursor(out);
 
@@ -1658,6 +2033,7 @@ void DrawAndBlit()
 	DrawCursor(out);
 
 	DrawFPS(out);
+	DrawRenderStats(out);
 
 	LuaEvent("GameDrawComplete");
 
@@ -1674,6 +2050,7 @@ void DrawAndBlit()
 		}
 	}
 
+	EndRenderStatsFrame();
 	RenderPresent();
 }
 
@@ -13,7 +13,7 @@
 
 namespace devilution {
 
-extern int LightTableIndex;
+extern thread_local int LightTableIndex;
 extern bool AutoMapShowItems;
 extern bool frameflag;
 
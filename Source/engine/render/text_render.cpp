@@ -8,10 +8,13 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <optional>
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <fmt/core.h>
 
@@ -25,6 +28,7 @@
 #include "engine/palette.h"
 #include "engine/point.hpp"
 #include "engine/render/clx_render.hpp"
+#include "engine/render/render_stats.hpp"
 #include "utils/algorithm/container.hpp"
 #include "utils/display.h"
 #include "utils/language.h"
@@ -147,13 +151,17 @@ uint32_t GetFontId(GameFontTables size, uint16_t row)
 	return (size << 16) | row;
 }
 
-OptionalClxSpriteList LoadFont(GameFontTables size, text_color color, uint16_t row)
+void LoadColorTranslation(text_color color)
 {
 	if (ColorTranslations[color] != nullptr && !ColorTranslationsData[color]) {
 		ColorTranslationsData[color].emplace();
 		LoadFileInMem(ColorTranslations[color], *ColorTranslationsData[color]);
 	}
+}
 
+/** @brief Loads the glyphs of a font row, see `LoadFont(GameFontTables, text_color, uint16_t)` for drawing them. */
+OptionalClxSpriteList LoadFont(GameFontTables size, uint16_t row)
+{
 	const uint32_t fontId = GetFontId(size, row);
 	auto hotFont = Fonts.find(fontId);
 	if (hotFont != Fonts.end()) {
@@ -195,24 +203,37 @@ OptionalClxSpriteList LoadFont(GameFontTables size, text_color color, uint16_t r
 	return OptionalClxSpriteList(*font);
 }
 
+OptionalClxSpriteList LoadFont(GameFontTables size, text_color color, uint16_t row)
+{
+	LoadColorTranslation(color);
+	return LoadFont(size, row);
+}
+
 class CurrentFont {
 public:
 	OptionalClxSpriteList sprite;
 
-	bool load(GameFontTables size, text_color color, char32_t next)
+	/** @brief Loads the glyphs for measuring or laying out text, the color translation is only needed for drawing. */
+	bool load(GameFontTables size, char32_t next)
 	{
 		const uint32_t unicodeRow = GetUnicodeRow(next);
 		if (unicodeRow == currentUnicodeRow_ && hasAttemptedLoad_) {
 			return true;
 		}
 
-		sprite = LoadFont(size, color, unicodeRow);
+		sprite = LoadFont(size, unicodeRow);
 		hasAttemptedLoad_ = true;
 		currentUnicodeRow_ = unicodeRow;
 
 		return sprite;
 	}
 
+	bool load(GameFontTables size, text_color color, char32_t next)
+	{
+		LoadColorTranslation(color);
+		return load(size, next);
+	}
+
 	void clear()
 	{
 		hasAttemptedLoad_ = false;
@@ -472,6 +493,77 @@ uint32_t DoDrawString(const Surface &out, std::string_view text, Rectangle rect,
 	return static_cast<uint32_t>(remaining.data() - text.data());
 }
 
+/** @brief A glyph of a `TextLayout`, positioned relative to the top-left corner of the text rectangle. */
+struct LayoutGlyph {
+	Displacement offset;
+	ClxSprite sprite;
+};
+
+/**
+ * @brief The glyphs of a string as positioned by `DrawString`, without the cursor and the highlight.
+ *
+ * Static strings such as item labels, the info box and the store text are drawn with the same options every frame,
+ * so their layout is cached instead of decoding, measuring and wrapping them again.
+ */
+struct TextLayout {
+	std::string text;
+	UiFlags flags;
+	int spacing;
+	/** @brief The line height from the options, -1 for the height of the font. */
+	int requestedLineHeight;
+	/** @brief The width of the rectangle, or -1 if the layout does not depend on it. */
+	int keyWidth;
+	/** @brief The height of the rectangle, or -1 if the layout does not depend on it. */
+	int keyHeight;
+
+	/**
+	 * @brief The range of right and bottom margins (relative to the rectangle) that produce the same layout.
+	 *
+	 * Left aligned text only depends on the width of the rectangle where it wraps, and any text only depends on its
+	 * bottom where it is cut off, so e.g. a label drawn at another position can still reuse its layout.
+	 */
+	int minRightMargin;
+	int maxRightMargin;
+	int minBottomMargin;
+	int maxBottomMargin;
+
+	int lineHeight;
+	int initialX;
+	Displacement endPosition;
+	uint32_t bytesDrawn;
+	std::vector<LayoutGlyph> glyphs;
+
+	bool isValidFor(int rightMargin, int bottomMargin) const
+	{
+		return rightMargin >= minRightMargin && rightMargin <= maxRightMargin
+		    && bottomMargin >= minBottomMargin && bottomMargin <= maxBottomMargin;
+	}
+};
+
+/** @brief Beyond this many layouts the cache is cleared, this is several times what a store screen needs. */
+constexpr size_t MaxCachedTextLayouts = 1024;
+
+std::unordered_map<size_t, TextLayout> TextLayoutCache;
+
+struct WrappedText {
+	std::string text;
+	unsigned width;
+	GameFontTables size;
+	int spacing;
+	std::string wrapped;
+};
+
+constexpr size_t MaxCachedWrappedTexts = 256;
+
+std::unordered_map<size_t, WrappedText> WrappedTextCache;
+
+size_t HashCombine(size_t seed, size_t value)
+{
+	return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+std::string DoWordWrapString(std::string_view text, unsigned width, GameFontTables size, int spacing);
+
 } // namespace
 
 void LoadSmallSelectionSpinner()
@@ -481,6 +573,9 @@ void LoadSmallSelectionSpinner()
 
 void UnloadFonts()
 {
+	// The cached layouts refer to the glyphs of the fonts.
+	TextLayoutCache.clear();
+	WrappedTextCache.clear();
 	Fonts.clear();
 }
 
@@ -500,9 +595,9 @@ int GetLineWidth(std::string_view text, GameFontTables size, int spacing, int *c
 		if (next == U'\n')
 			break;
 
-		if (!currentFont.load(size, text_color::ColorDialogWhite, next)) {
+		if (!currentFont.load(size, next)) {
 			next = U'?';
-			if (!currentFont.load(size, text_color::ColorDialogWhite, next)) {
+			if (!currentFont.load(size, next)) {
 				app_fatal("Missing fonts");
 			}
 		}
@@ -552,9 +647,9 @@ int GetLineWidth(std::string_view fmt, DrawStringFormatArg *args, std::size_t ar
 		if (next == U'\n')
 			break;
 
-		if (!currentFont.load(size, text_color::ColorDialogWhite, next)) {
+		if (!currentFont.load(size, next)) {
 			next = U'?';
-			if (!currentFont.load(size, text_color::ColorDialogWhite, next)) {
+			if (!currentFont.load(size, next)) {
 				app_fatal("Missing fonts");
 			}
 		}
@@ -590,6 +685,33 @@ int AdjustSpacingToFitHorizontally(int &lineWidth, int maxSpacing, int character
 }
 
 std::string WordWrapString(std::string_view text, unsigned width, GameFontTables size, int spacing)
+{
+	size_t hash = std::hash<std::string_view> {}(text);
+	hash = HashCombine(hash, width);
+	hash = HashCombine(hash, size);
+	hash = HashCombine(hash, static_cast<size_t>(spacing));
+
+	auto it = WrappedTextCache.find(hash);
+	if (it != WrappedTextCache.end()) {
+		const WrappedText &cached = it->second;
+		if (cached.width == width && cached.size == size && cached.spacing == spacing && cached.text == text)
+			return cached.wrapped;
+	} else if (WrappedTextCache.size() >= MaxCachedWrappedTexts) {
+		WrappedTextCache.clear();
+	}
+
+	WrappedText &cached = WrappedTextCache[hash];
+	cached.text = text;
+	cached.width = width;
+	cached.size = size;
+	cached.spacing = spacing;
+	cached.wrapped = DoWordWrapString(text, width, size, spacing);
+	return cached.wrapped;
+}
+
+namespace {
+
+std::string DoWordWrapString(std::string_view text, unsigned width, GameFontTables size, int spacing)
 {
 	std::string output;
 	if (text.empty() || text[0] == '\0')
@@ -626,9 +748,9 @@ std::string WordWrapString(std::string_view text, unsigned width, GameFontTables
 
 		if (codepoint != ZWSP) {
 			const uint8_t frame = codepoint & 0xFF;
-			if (!currentFont.load(size, text_color::ColorDialogWhite, codepoint)) {
+			if (!currentFont.load(size, codepoint)) {
 				codepoint = U'?';
-				if (!currentFont.load(size, text_color::ColorDialogWhite, codepoint)) {
+				if (!currentFont.load(size, codepoint)) {
 					app_fatal("Missing fonts");
 				}
 			}
@@ -672,14 +794,184 @@ std::string WordWrapString(std::string_view text, unsigned width, GameFontTables
 	return output;
 }
 
+/** @brief Whether `DrawString` can draw the text from a cached layout, i.e. it has no cursor and no highlight. */
+bool CanUseTextLayout(const TextRenderOptions &opts)
+{
+	return opts.cursorPosition == -1
+	    && opts.highlightRange.begin >= opts.highlightRange.end
+	    && opts.renderedCursorPositionOut == nullptr;
+}
+
+/**
+ * @brief Positions the glyphs like `DrawString` and `DoDrawString` do, relative to the top-left corner of the rectangle.
+ * @param bottomMargin The bottom margin relative to the top of the rectangle.
+ */
+void LayoutString(std::string_view text, Size rectSize, int bottomMargin, GameFontTables size, TextRenderOptions opts, TextLayout &layout)
+{
+	const Rectangle rect { { 0, 0 }, rectSize };
+	const int rightMargin = rectSize.width;
+
+	int charactersInLine = 0;
+	int lineWidth = 0;
+	if (HasAnyOf(opts.flags, (UiFlags::AlignCenter | UiFlags::AlignRight | UiFlags::KerningFitSpacing)))
+		lineWidth = GetLineWidth(text, size, opts.spacing, &charactersInLine);
+
+	if (HasAnyOf(opts.flags, UiFlags::KerningFitSpacing))
+		opts.spacing = AdjustSpacingToFitHorizontally(lineWidth, opts.spacing, charactersInLine, rect.size.width);
+
+	Point characterPosition { GetLineStartX(opts.flags, rect, lineWidth), 0 };
+	layout.initialX = characterPosition.x;
+
+	if (opts.lineHeight == -1)
+		opts.lineHeight = GetLineHeight(text, size);
+	layout.lineHeight = opts.lineHeight;
+
+	if (HasAnyOf(opts.flags, UiFlags::VerticalCenter)) {
+		const int textHeight = static_cast<int>((c_count(text, '\n') + 1) * opts.lineHeight);
+		characterPosition.y += std::max(0, (rect.size.height - textHeight) / 2);
+	}
+
+	characterPosition.y += BaseLineOffset[size];
+
+	layout.minRightMargin = std::numeric_limits<int>::min();
+	layout.maxRightMargin = std::numeric_limits<int>::max();
+	layout.minBottomMargin = std::numeric_limits<int>::min();
+	layout.maxBottomMargin = std::numeric_limits<int>::max();
+	layout.glyphs.clear();
+
+	CurrentFont currentFont;
+	char32_t next;
+	std::string_view remaining = text;
+	size_t cpLen;
+	for (; !remaining.empty() && remaining[0] != '\0'
+	     && (next = DecodeFirstUtf8CodePoint(remaining, &cpLen)) != Utf8DecodeError;
+	     remaining.remove_prefix(cpLen)) {
+		if (next == ZWSP)
+			continue;
+
+		if (!currentFont.load(size, next)) {
+			next = U'?';
+			if (!currentFont.load(size, next)) {
+				app_fatal("Missing fonts");
+			}
+		}
+
+		const uint8_t frame = next & 0xFF;
+		const uint16_t width = (*currentFont.sprite)[frame].width();
+		const bool wraps = characterPosition.x + width > rightMargin;
+		if (next != U'\n') {
+			if (wraps)
+				layout.maxRightMargin = std::min(layout.maxRightMargin, characterPosition.x + width - 1);
+			else
+				layout.minRightMargin = std::max(layout.minRightMargin, characterPosition.x + width);
+		}
+		if (next == U'\n' || wraps) {
+			const int nextLineY = characterPosition.y + opts.lineHeight;
+			if (nextLineY >= bottomMargin) {
+				layout.maxBottomMargin = nextLineY;
+				break;
+			}
+			layout.minBottomMargin = std::max(layout.minBottomMargin, nextLineY + 1);
+			characterPosition.y = nextLineY;
+
+			if (HasAnyOf(opts.flags, (UiFlags::AlignCenter | UiFlags::AlignRight))) {
+				lineWidth = width;
+				if (remaining.size() > cpLen)
+					lineWidth += opts.spacing + GetLineWidth(remaining.substr(cpLen), size, opts.spacing);
+			}
+			characterPosition.x = GetLineStartX(opts.flags, rect, lineWidth);
+
+			if (next == U'\n')
+				continue;
+		}
+
+		layout.glyphs.push_back({ Displacement { characterPosition.x, characterPosition.y }, (*currentFont.sprite)[frame] });
+		characterPosition.x += width + opts.spacing;
+	}
+	layout.endPosition = Displacement { characterPosition.x, characterPosition.y };
+	layout.bytesDrawn = static_cast<uint32_t>(remaining.data() - text.data());
+}
+
+const TextLayout &GetTextLayout(std::string_view text, Size rectSize, int bottomMargin, GameFontTables size, const TextRenderOptions &opts)
+{
+	// Only centered, right aligned and fitted text depends on the width of the rectangle everywhere,
+	// for the others `TextLayout::isValidFor` checks the margins.
+	const int keyWidth = HasAnyOf(opts.flags, (UiFlags::AlignCenter | UiFlags::AlignRight | UiFlags::KerningFitSpacing)) ? rectSize.width : -1;
+	const int keyHeight = HasAnyOf(opts.flags, UiFlags::VerticalCenter) ? rectSize.height : -1;
+
+	size_t hash = std::hash<std::string_view> {}(text);
+	hash = HashCombine(hash, static_cast<size_t>(opts.flags));
+	hash = HashCombine(hash, static_cast<size_t>(opts.spacing));
+	hash = HashCombine(hash, static_cast<size_t>(opts.lineHeight));
+	hash = HashCombine(hash, static_cast<size_t>(keyWidth));
+	hash = HashCombine(hash, static_cast<size_t>(keyHeight));
+
+	auto it = TextLayoutCache.find(hash);
+	if (it != TextLayoutCache.end()) {
+		const TextLayout &layout = it->second;
+		if (layout.flags == opts.flags && layout.spacing == opts.spacing && layout.requestedLineHeight == opts.lineHeight
+		    && layout.keyWidth == keyWidth && layout.keyHeight == keyHeight && layout.text == text
+		    && layout.isValidFor(rectSize.width, bottomMargin)) {
+			return layout;
+		}
+	} else if (TextLayoutCache.size() >= MaxCachedTextLayouts) {
+		TextLayoutCache.clear();
+	}
+
+	// A miss, a hash collision or a margin outside of the valid range: lay the text out (again).
+	TextLayout &layout = TextLayoutCache[hash];
+	layout.text = text;
+	layout.flags = opts.flags;
+	layout.spacing = opts.spacing;
+	layout.requestedLineHeight = opts.lineHeight;
+	layout.keyWidth = keyWidth;
+	layout.keyHeight = keyHeight;
+	LayoutString(text, rectSize, bottomMargin, size, opts, layout);
+	return layout;
+}
+
+uint32_t DrawTextLayout(const Surface &out, std::string_view text, const Rectangle &rect, GameFontTables size, text_color color, const TextRenderOptions &opts)
+{
+	const int rightMargin = rect.position.x + rect.size.width;
+	const int bottomMargin = rect.size.height != 0 ? std::min(rect.position.y + rect.size.height + BaseLineOffset[size], out.h()) : out.h();
+	const TextLayout &layout = GetTextLayout(text, rect.size, bottomMargin - rect.position.y, size, opts);
+
+	LoadColorTranslation(color);
+	const bool outlined = HasAnyOf(opts.flags, UiFlags::Outlined);
+	const Surface clippedOut = ClipSurface(out, rect);
+	for (const LayoutGlyph &glyph : layout.glyphs) {
+		DrawFont(clippedOut, rect.position + glyph.offset, glyph.sprite, color, outlined);
+	}
+
+	if (HasAnyOf(opts.flags, UiFlags::PentaCursor)) {
+		const ClxSprite sprite = (*pSPentSpn2Cels)[PentSpn2Spin()];
+		Point characterPosition = rect.position + layout.endPosition;
+		MaybeWrap(characterPosition, sprite.width(), rightMargin, rect.position.x + layout.initialX, layout.lineHeight);
+		ClxDraw(clippedOut, characterPosition + Displacement { 0, layout.lineHeight - BaseLineOffset[size] }, sprite);
+	}
+
+	return layout.bytesDrawn;
+}
+
+} // namespace
+
 /**
  * @todo replace Rectangle with cropped Surface
  */
 uint32_t DrawString(const Surface &out, std::string_view text, const Rectangle &rect, TextRenderOptions opts)
 {
+	const RenderStatsScope renderStats { RenderStatsCategory::Text };
 	const GameFontTables size = GetFontSizeFromUiFlags(opts.flags);
 	const text_color color = GetColorFromFlags(opts.flags);
 
+	// Only draw the PentaCursor if the cursor is not at the end.
+	if (HasAnyOf(opts.flags, UiFlags::PentaCursor) && static_cast<size_t>(opts.cursorPosition) == text.size()) {
+		opts.cursorPosition = -1;
+	}
+
+	if (CanUseTextLayout(opts))
+		return DrawTextLayout(out, text, rect, size, color, opts);
+
 	int charactersInLine = 0;
 	int lineWidth = 0;
 	if (HasAnyOf(opts.flags, (UiFlags::AlignCenter | UiFlags::AlignRight | UiFlags::KerningFitSpacing)))
@@ -709,11 +1001,6 @@ uint32_t DrawString(const Surface &out, std::string_view text, const Rectangle &
 
 	const Surface clippedOut = ClipSurface(out, rect);
 
-	// Only draw the PentaCursor if the cursor is not at the end.
-	if (HasAnyOf(opts.flags, UiFlags::PentaCursor) && static_cast<size_t>(opts.cursorPosition) == text.size()) {
-		opts.cursorPosition = -1;
-	}
-
 	const uint32_t bytesDrawn = DoDrawString(clippedOut, text, rect, characterPosition,
 	    lineWidth, rightMargin, bottomMargin, size, color, outlined, opts);
 
@@ -728,6 +1015,7 @@ uint32_t DrawString(const Surface &out, std::string_view text, const Rectangle &
 
 void DrawStringWithColors(const Surface &out, std::string_view fmt, DrawStringFormatArg *args, std::size_t argsLen, const Rectangle &rect, TextRenderOptions opts)
 {
+	const RenderStatsScope renderStats { RenderStatsCategory::Text };
 	const GameFontTables size = GetFontSizeFromUiFlags(opts.flags);
 	const text_color color = GetColorFromFlags(opts.flags);
 
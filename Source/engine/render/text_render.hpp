@@ -201,7 +201,7 @@ int GetLineHeight(std::string_view text, GameFontTables fontIndex);
  * @param width Width in pixels of the output region
  * @param size Font size to use for the width calculation
  * @param spacing Any adjustment to apply between each character
- * @return A copy of the source text with newlines inserted where appropriate
+ * @return A copy of the source text with newlines inserted where appropriate, recent results are cached
  */
 [[nodiscard]] std::string WordWrapString(std::string_view text, unsigned width, GameFontTables size = GameFont12, int spacing = 1);
 
@@ -215,6 +215,8 @@ int GetLineHeight(std::string_view text, GameFontTables fontIndex);
  * the text was being rendered off screen). The text will not actually be drawn beyond the bounds of the output
  * buffer, this is purely to allow for clipping without wrapping.
  *
+ * The layout of strings drawn without a cursor or a highlight is cached until the fonts are unloaded.
+ *
  * @param out The screen buffer to draw on.
  * @param text String to be drawn.
  * @param rect Clipping region relative to the output buffer describing where to draw the text and when to wrap long lines.
@@ -0,0 +1,69 @@
+#include "engine/render/view_change_tracker.hpp"
+
+#include <algorithm>
+
+namespace devilution {
+
+void Fingerprint::addBytes(const void *data, size_t size)
+{
+	const auto *bytes = static_cast<const uint8_t *>(data);
+	for (size_t i = 0; i < size; ++i)
+		hash_ = (hash_ ^ bytes[i]) * 0x100000001B3ULL;
+}
+
+void ViewChangeTracker::beginFrame(uint64_t viewKey, int viewHeight)
+{
+	fullRedraw_ = !valid_ || viewKey != viewKey_ || viewHeight != viewHeight_;
+	viewKey_ = viewKey;
+	viewHeight_ = viewHeight;
+	numTiles_ = 0;
+	dirtySpans_.clear();
+}
+
+void ViewChangeTracker::addTile(uint64_t fingerprint, int y)
+{
+	if (numTiles_ == fingerprints_.size()) {
+		fingerprints_.push_back(fingerprint);
+		fullRedraw_ = true;
+	} else if (fingerprints_[numTiles_] != fingerprint) {
+		fingerprints_[numTiles_] = fingerprint;
+		if (!fullRedraw_)
+			markDirty(y);
+	}
+	++numTiles_;
+}
+
+bool ViewChangeTracker::endFrame()
+{
+	if (numTiles_ != fingerprints_.size()) {
+		fingerprints_.resize(numTiles_);
+		fullRedraw_ = true;
+	}
+	valid_ = true;
+	if (fullRedraw_) {
+		dirtySpans_.clear();
+		return true;
+	}
+
+	std::sort(dirtySpans_.begin(), dirtySpans_.end(), [](const RowSpan &a, const RowSpan &b) { return a.top < b.top; });
+	size_t numMerged = 0;
+	for (const RowSpan &span : dirtySpans_) {
+		if (numMerged > 0 && span.top <= dirtySpans_[numMerged - 1].bottom) {
+			dirtySpans_[numMerged - 1].bottom = std::max(dirtySpans_[numMerged - 1].bottom, span.bottom);
+		} else {
+			dirtySpans_[numMerged++] = span;
+		}
+	}
+	dirtySpans_.resize(numMerged);
+	return false;
+}
+
+void ViewChangeTracker::markDirty(int y)
+{
+	const int top = std::max(y - reachAbove_, 0);
+	const int bottom = std::min(y + reachBelow_, viewHeight_);
+	if (top < bottom)
+		dirtySpans_.push_back(RowSpan { top, bottom });
+}
+
+} // namespace devilution
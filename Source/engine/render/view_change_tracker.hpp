@@ -0,0 +1,120 @@
+/**
+ * @file view_change_tracker.hpp
+ *
+ * Detection of the parts of the game view that changed since the previous frame.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace devilution {
+
+/**
+ * @brief Accumulates the state that something is drawn from into a single value.
+ */
+class Fingerprint {
+public:
+	template <typename T>
+	void add(T value)
+	{
+		if constexpr (std::is_pointer_v<T>) {
+			mix(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+		} else {
+			mix(static_cast<uint64_t>(value));
+		}
+	}
+
+	template <typename T, typename... Ts>
+	void add(T value, Ts... values)
+	{
+		add(value);
+		add(values...);
+	}
+
+	void addBytes(const void *data, size_t size);
+
+	[[nodiscard]] uint64_t value() const
+	{
+		return hash_;
+	}
+
+private:
+	void mix(uint64_t value)
+	{
+		hash_ = (hash_ ^ value) * 0x100000001B3ULL;
+		hash_ ^= hash_ >> 29;
+	}
+
+	uint64_t hash_ = 0xCBF29CE484222325ULL;
+};
+
+/** @brief A range of rows `[top, bottom)`. */
+struct RowSpan {
+	int top;
+	int bottom;
+
+	bool operator==(const RowSpan &other) const
+	{
+		return top == other.top && bottom == other.bottom;
+	}
+};
+
+/**
+ * @brief Finds the rows of the view that have to be redrawn.
+ *
+ * Every frame, the renderer reports a fingerprint of each tile in drawing order, together with the tile's position
+ * on the screen. Tiles are matched with the previous frame by their order, which is only meaningful as long as the
+ * view itself (camera, size, level, ...) does not change; this is checked with the `viewKey` passed to `beginFrame`.
+ */
+class ViewChangeTracker {
+public:
+	/**
+	 * @param reachAbove How far above its screen position anything drawn for a tile can reach.
+	 * @param reachBelow How far below its screen position anything drawn for a tile can reach.
+	 */
+	ViewChangeTracker(int reachAbove, int reachBelow)
+	    : reachAbove_(reachAbove)
+	    , reachBelow_(reachBelow)
+	{
+	}
+
+	/** @brief Makes the next frame redraw everything. */
+	void invalidate()
+	{
+		valid_ = false;
+	}
+
+	void beginFrame(uint64_t viewKey, int viewHeight);
+
+	void addTile(uint64_t fingerprint, int y);
+
+	/**
+	 * @brief Finishes the frame.
+	 * @return Whether the whole view has to be redrawn, otherwise `dirtySpans()` lists the rows to redraw.
+	 */
+	bool endFrame();
+
+	/** @brief Sorted, non-overlapping rows that changed. Empty if nothing changed. */
+	[[nodiscard]] const std::vector<RowSpan> &dirtySpans() const
+	{
+		return dirtySpans_;
+	}
+
+private:
+	void markDirty(int y);
+
+	int reachAbove_;
+	int reachBelow_;
+	bool valid_ = false;
+	bool fullRedraw_ = true;
+	uint64_t viewKey_ = 0;
+	int viewHeight_ = 0;
+	size_t numTiles_ = 0;
+	std::vector<uint64_t> fingerprints_;
+	std::vector<RowSpan> dirtySpans_;
+};
+
+} // namespace devilution
@@ -335,8 +335,13 @@ void gamemenu_save_game(bool /*bActivate*/)
 	DrawAndBlit();
 	uint32_t currentTime = SDL_GetTicks();
 	SaveGame();
+	// The archive is written in the background, only tell the player it was saved once it is on disk.
+	const bool saved = pfile_wait_for_pending_saves();
 	ClrDiabloMsg();
-	InitDiabloMsg(EMSG_GAME_SAVED, currentTime + 1000 - SDL_GetTicks());
+	if (saved)
+		InitDiabloMsg(EMSG_GAME_SAVED, currentTime + 1000 - SDL_GetTicks());
+	else
+		InitDiabloMsg(_("Failed to save the game"));
 	RedrawEverything();
 	NewCursor(CURSOR_HAND);
 	if (CornerStone.activated) {
@@ -97,7 +97,11 @@ bool SetHardwareCursorFromSurface(SDL_Surface *surface, HotpointPosition hotpoin
 			Log("hwcursor: SetHardwareCursorFromSurface {}x{} scaled to {}x{} using nearest neighbour scaling",
 			    size.width, size.height, scaledSize.width, scaledSize.height);
 #endif
-			SDL_BlitScaled(converted.get(), nullptr, scaledSurface.get(), nullptr);
+			if (scaledSize.width % size.width == 0 && scaledSize.height % size.height == 0) {
+				IntegerScale32(converted.get(), scaledSurface.get());
+			} else {
+				SDL_BlitScaled(converted.get(), nullptr, scaledSurface.get(), nullptr);
+			}
 		}
 		const Point hotpoint = GetHotpointPosition(*scaledSurface, hotpointPosition);
 		newCursor = SDLCursorUniquePtr { SDL_CreateColorCursor(scaledSurface.get(), hotpoint.x, hotpoint.y) };
@@ -241,6 +241,7 @@ void init_cleanup()
 	lang_mpq = std::nullopt;
 	font_mpq = std::nullopt;
 	devilutionx_mpq = std::nullopt;
+	ClearAssetIndex();
 #endif
 
 	NetClose();
@@ -258,6 +259,7 @@ void LoadCoreArchives()
 	devilutionx_mpq = LoadMPQ(paths, "devilutionx.mpq");
 #endif
 	font_mpq = LoadMPQ(paths, "fonts.mpq"); // Extra fonts
+	RebuildAssetIndex();
 #endif
 }
 
@@ -279,6 +281,9 @@ void LoadLanguageArchive()
 		lang_mpq = LoadMPQ(GetMPQSearchPaths(), langMpqName);
 #endif
 	}
+#ifndef UNPACKED_MPQS
+	RebuildAssetIndex();
+#endif
 }
 
 void LoadGameArchives()
@@ -331,6 +336,7 @@ void LoadGameArchives()
 		if (spawn_mpq)
 			gbIsSpawn = true;
 	}
+	RebuildAssetIndex();
 	if (!HeadlessMode) {
 		AssetRef ref = FindAsset("ui_art\\title.pcx");
 		if (!ref.ok()) {
@@ -354,6 +360,7 @@ void LoadGameArchives()
 		gbBarbarian = true;
 	hfmusic_mpq = LoadMPQ(paths, "hfmusic.mpq");
 	hfvoice_mpq = LoadMPQ(paths, "hfvoice.mpq");
+	RebuildAssetIndex();
 
 	if (gbIsHellfire && (!hfmonk_mpq || !hfmusic_mpq || !hfvoice_mpq)) {
 		UiErrorOkDialog(_("Some Hellfire MPQs are missing"), _("Not all Hellfire MPQs were found.\nPlease copy all the hf*.mpq files."));
@@ -37,7 +37,7 @@ extern DVL_API_FOR_TEST std::optional<MpqArchive> spawn_mpq;
 /** A handle to the diabdat.mpq archive. */
 extern DVL_API_FOR_TEST std::optional<MpqArchive> diabdat_mpq;
 /** A handle to an hellfire.mpq archive. */
-extern std::optional<MpqArchive> hellfire_mpq;
+extern DVL_API_FOR_TEST std::optional<MpqArchive> hellfire_mpq;
 extern std::optional<MpqArchive> hfmonk_mpq;
 extern std::optional<MpqArchive> hfbard_mpq;
 extern std::optional<MpqArchive> hfbarb_mpq;
@@ -7,6 +7,7 @@
 #include "init.h"
 #include "levels/drlg_l1.h"
 #include "levels/trigs.h"
+#include "lighting.h"
 #include "player.h"
 #include "quests.h"
 
@@ -327,6 +328,7 @@ void TownOpenHive()
 	dPiece[86][61] = 0x17;
 	dPiece[85][62] = 0x12;
 	dPiece[84][64] = 0x117;
+	InvalidateVisionCache();
 }
 
 void TownOpenGrave()
@@ -344,6 +346,7 @@ void TownOpenGrave()
 	dPiece[37][24] = 0x539;
 	dPiece[35][21] = 0x53a;
 	dPiece[34][21] = 0x53b;
+	InvalidateVisionCache();
 }
 
 void CleanTownFountain()
@@ -351,6 +354,7 @@ void CleanTownFountain()
 	if (!pMegaTiles)
 		return;
 	FillTile(60, 70, 71);
+	InvalidateVisionCache();
 }
 
 void CreateTown(lvl_entry entry)
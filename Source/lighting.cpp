@@ -7,14 +7,18 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <numeric>
+#include <vector>
 
 #include "automap.h"
 #include "diablo.h"
 #include "engine/load_file.hpp"
 #include "engine/points_in_rectangle_range.hpp"
+#include "engine/render/prelit_tile_cache.hpp"
 #include "player.h"
 #include "utils/attributes.h"
+#include "utils/static_vector.hpp"
 
 namespace devilution {
 
@@ -71,11 +75,55 @@ constexpr size_t NumLightRadiuses = 16;
 /** Falloff tables for the light cone */
 uint8_t LightFalloffs[NumLightRadiuses][128];
 bool UpdateVision;
+/** Set when a light is added, moved or removed, ProcessLightList then only relights the areas around those lights. */
+bool LightsChanged;
+/** Lights added since the last ProcessLightList, they have not been drawn yet. */
+std::array<bool, MAXLIGHTS> NewLights;
 /** interpolations of a 32x32 (16x16 mirrored) light circle moving between tiles in steps of 1/8 of a tile */
 uint8_t LightConeInterpolations[8][8][16][16];
+/** How many tiles the light cone reaches from the light's tile. */
+constexpr int MaxLightReach = 14;
+/**
+ * @brief Light cones for each radius and sub-tile offset, drawn by MakeLightTable
+ *
+ * Each stamp is a `[x][y]` square like dLight that spans `LightStampReach[radius]` tiles around the light,
+ * with UINT8_MAX for tiles the cone doesn't touch. Light levels never exceed LightsMax, so the tiles the cone can
+ * only make as dark as LightsMax are left out.
+ */
+std::vector<uint8_t> LightStamps;
+uint8_t LightStampReach[NumLightRadiuses];
+size_t LightStampOffsets[NumLightRadiuses][8][8];
+/** The falloffs LightStamps were drawn with, only crypt and nest levels have different ones. */
+uint8_t LightStampFalloffs[NumLightRadiuses][128];
 
 /** RadiusAdj maps from VisionCrawlTable index to lighting vision radius adjustment. */
 const uint8_t RadiusAdj[23] = { 0, 0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 4, 3, 2, 2, 2, 1, 1, 1, 0, 0, 0, 0 };
+/** How many tiles VisionCrawlTable reaches from the viewer's tile. */
+constexpr int MaxVisionReach = 15;
+
+/** @brief A tile seen by a vision. */
+struct VisionTile {
+	WorldTilePosition position;
+	/** The crawl reaches the tile more than once, the visits after the first find it flagged. */
+	bool revisited;
+	/** A ray of the crawl goes through the tile, which shows its transparency group. */
+	bool seeThrough;
+};
+
+/**
+ * @brief The tiles a vision sees, in the order the crawl first reaches them.
+ *
+ * Only depends on the position, the radius and which tiles block light, so it is kept until one of them changes.
+ */
+struct VisionField {
+	Point position {};
+	uint8_t radius = 0;
+	bool isValid = false;
+	std::vector<VisionTile> tiles;
+};
+
+/** Fields of the entries in VisionList, see InvalidateVisionCache(). */
+VisionField VisionFields[MAXVISION];
 
 void RotateRadius(DisplacementOf<int8_t> &offset, DisplacementOf<int8_t> &dist, DisplacementOf<int8_t> &light, DisplacementOf<int8_t> &block)
 {
@@ -111,6 +159,148 @@ DVL_ALWAYS_INLINE uint8_t GetLight(Point position)
 	return dLight[position.x][position.y];
 }
 
+uint8_t LightCenterLevel(uint8_t radius)
+{
+	// Allow for dim lights in crypt and nest
+	if (IsAnyOf(leveltype, DTYPE_NEST, DTYPE_CRYPT))
+		return LightFalloffs[radius][0];
+	return 0;
+}
+
+/**
+ * @brief Calls `f(displacement, lightLevel)` for each tile around a light that its cone reaches
+ *
+ * The light's own tile is not included, see LightCenterLevel. The bounds limit how far each quadrant goes.
+ */
+template <typename F>
+DVL_ALWAYS_INLINE void ForEachLightConeTile(uint8_t radius, DisplacementOf<int8_t> offset, int minX, int maxX, int minY, int maxY, F &&f)
+{
+	DisplacementOf<int8_t> light = {};
+	DisplacementOf<int8_t> block = {};
+	DisplacementOf<int8_t> dist = offset;
+
+	for (int i = 0; i < 4; i++) {
+		int yBound = i > 0 && i < 3 ? maxY : minY;
+		int xBound = i < 2 ? maxX : minX;
+		for (int y = 0; y < yBound; y++) {
+			for (int x = 1; x < xBound; x++) {
+				int linearDistance = LightConeInterpolations[offset.deltaX][offset.deltaY][x + block.deltaX][y + block.deltaY];
+				if (linearDistance >= 128)
+					continue;
+				f((Displacement { x, y }).Rotate(-i), LightFalloffs[radius][linearDistance]);
+			}
+		}
+		RotateRadius(offset, dist, light, block);
+	}
+}
+
+void MakeLightStamps()
+{
+	// The cone interpolations never change, so the stamps only depend on the falloffs, including the center level.
+	if (!LightStamps.empty() && memcmp(LightStampFalloffs, LightFalloffs, sizeof(LightFalloffs)) == 0)
+		return;
+	memcpy(LightStampFalloffs, LightFalloffs, sizeof(LightFalloffs));
+
+	constexpr int ConeSize = 2 * MaxLightReach + 1;
+	uint8_t cone[ConeSize][ConeSize];
+	const auto drawCone = [&cone](uint8_t radius, DisplacementOf<int8_t> offset) {
+		memset(cone, UINT8_MAX, sizeof(cone));
+		cone[MaxLightReach][MaxLightReach] = LightCenterLevel(radius);
+		constexpr int Bound = MaxLightReach + 1;
+		ForEachLightConeTile(radius, offset, Bound, Bound, Bound, Bound, [&cone](Displacement displacement, uint8_t v) {
+			cone[MaxLightReach + displacement.deltaX][MaxLightReach + displacement.deltaY] = v;
+		});
+	};
+
+	LightStamps.clear();
+	for (uint8_t radius = 0; radius < NumLightRadiuses; radius++) {
+		int reach = 0;
+		for (int8_t offsetX = 0; offsetX < 8; offsetX++) {
+			for (int8_t offsetY = 0; offsetY < 8; offsetY++) {
+				drawCone(radius, { offsetX, offsetY });
+				for (int x = 0; x < ConeSize; x++) {
+					for (int y = 0; y < ConeSize; y++) {
+						if (cone[x][y] < LightsMax)
+							reach = std::max({ reach, std::abs(x - MaxLightReach), std::abs(y - MaxLightReach) });
+					}
+				}
+			}
+		}
+
+		LightStampReach[radius] = static_cast<uint8_t>(reach);
+		for (int8_t offsetX = 0; offsetX < 8; offsetX++) {
+			for (int8_t offsetY = 0; offsetY < 8; offsetY++) {
+				drawCone(radius, { offsetX, offsetY });
+				LightStampOffsets[radius][offsetX][offsetY] = LightStamps.size();
+				for (int x = MaxLightReach - reach; x <= MaxLightReach + reach; x++)
+					LightStamps.insert(LightStamps.end(), &cone[x][MaxLightReach - reach], &cone[x][MaxLightReach + reach + 1]);
+			}
+		}
+	}
+}
+
+/** @brief Darkens `lightMap` to a precomputed light cone, the light must be at least MaxLightReach tiles away from the edges. */
+DVL_ATTRIBUTE_HOT void ApplyLightStamp(uint8_t (&lightMap)[MAXDUNX][MAXDUNY], Point position, uint8_t radius, DisplacementOf<int8_t> offset)
+{
+	const int reach = LightStampReach[radius];
+	const int size = 2 * reach + 1;
+	const uint8_t *stamp = &LightStamps[LightStampOffsets[radius][offset.deltaX][offset.deltaY]];
+	for (int x = position.x - reach; x <= position.x + reach; x++, stamp += size) {
+		// A plain loop over a column, which the compiler turns into vector min instructions
+		uint8_t *DVL_RESTRICT dst = &lightMap[x][position.y - reach];
+		const uint8_t *DVL_RESTRICT src = stamp;
+		for (int y = 0; y < size; y++)
+			dst[y] = std::min(dst[y], src[y]);
+	}
+}
+
+/** @brief Moves negative offsets to the previous tile, like the light cone tables expect. */
+void NormalizeLightOffset(Point &position, DisplacementOf<int8_t> &offset)
+{
+	if (offset.deltaX < 0) {
+		offset.deltaX += 8;
+		position -= { 1, 0 };
+	}
+	if (offset.deltaY < 0) {
+		offset.deltaY += 8;
+		position -= { 0, 1 };
+	}
+}
+
+/** @brief Draws a light cone tile by tile, for lights too close to the edges for the stamps. */
+void DrawLightCone(Point position, uint8_t radius, DisplacementOf<int8_t> offset)
+{
+	// Close to the edges the quadrants are cut short, in a way the stamps don't reproduce
+	int minX = 15;
+	if (position.x - 15 < 0) {
+		minX = position.x + 1;
+	}
+	int maxX = 15;
+	if (position.x + 15 > MAXDUNX) {
+		maxX = MAXDUNX - position.x;
+	}
+	int minY = 15;
+	if (position.y - 15 < 0) {
+		minY = position.y + 1;
+	}
+	int maxY = 15;
+	if (position.y + 15 > MAXDUNY) {
+		maxY = MAXDUNY - position.y;
+	}
+
+	const uint8_t centerLevel = LightCenterLevel(radius);
+	if (GetLight(position) > centerLevel)
+		SetLight(position, centerLevel);
+
+	ForEachLightConeTile(radius, offset, minX, maxX, minY, maxY, [position](Displacement displacement, uint8_t v) {
+		Point temp = position + displacement;
+		if (!InDungeonBounds(temp))
+			return;
+		if (v < GetLight(temp))
+			SetLight(temp, v);
+	});
+}
+
 bool CrawlFlipsX(Displacement mirrored, tl::function_ref<bool(Displacement)> function)
 {
 	for (const Displacement displacement : { mirrored.flipX(), mirrored }) {
@@ -138,6 +328,23 @@ bool CrawlFlipsXY(Displacement mirrored, tl::function_ref<bool(Displacement)> fu
 	return true;
 }
 
+/** @brief An area reset by DoUnLight. */
+struct UnlitArea {
+	Point position;
+	uint8_t radius;
+};
+
+/**
+ * @brief Checks if a light at the given position can brighten any tile in the area.
+ *
+ * DoUnLight resets `radius + 2` tiles around a light, which covers everything DoLighting can brighten.
+ */
+bool LightReaches(Point position, uint8_t radius, const UnlitArea &area)
+{
+	const int reach = radius + area.radius + 4;
+	return std::abs(position.x - area.position.x) <= reach && std::abs(position.y - area.position.y) <= reach;
+}
+
 bool TileAllowsLight(Point position)
 {
 	if (!InDungeonBounds(position))
@@ -145,16 +352,80 @@ bool TileAllowsLight(Point position)
 	return !TileHasAny(dPiece[position.x][position.y], TileProperties::BlockLight);
 }
 
-void DoVisionFlags(Point position, MapExplorationType doAutomap, bool visible)
+void CrawlVision(Point position, uint8_t radius, VisionField &field)
 {
-	if (doAutomap != MAP_EXP_NONE) {
-		if (dFlags[position.x][position.y] != DungeonFlag::None)
-			SetAutomapView(position, doAutomap);
-		dFlags[position.x][position.y] |= DungeonFlag::Explored;
+	field.position = position;
+	field.radius = radius;
+	field.isValid = true;
+	field.tiles.clear();
+
+	// The rays cross each other, so the index of each tile in `field.tiles` is kept to merge the visits
+	std::array<std::array<int16_t, 2 * MaxVisionReach + 1>, 2 * MaxVisionReach + 1> tileIndices;
+	for (auto &column : tileIndices)
+		column.fill(-1);
+	const auto visit = [&](Point tile, bool seeThrough) {
+		int16_t &index = tileIndices[tile.x - position.x + MaxVisionReach][tile.y - position.y + MaxVisionReach];
+		if (index == -1) {
+			index = static_cast<int16_t>(field.tiles.size());
+			field.tiles.push_back({ tile, false, seeThrough });
+			return;
+		}
+		VisionTile &visionTile = field.tiles[index];
+		visionTile.revisited = true;
+		visionTile.seeThrough = visionTile.seeThrough || seeThrough;
+	};
+
+	visit(position, false);
+
+	static const Displacement factors[] = { { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
+	for (auto factor : factors) {
+		for (int j = 0; j < 23; j++) {
+			int lineLen = radius - RadiusAdj[j];
+			for (int k = 0; k < lineLen; k++) {
+				Point crawl = position + VisionCrawlTable[j][k] * factor;
+				if (!InDungeonBounds(crawl))
+					break;
+				bool blockerFlag = TileHasAny(dPiece[crawl.x][crawl.y], TileProperties::BlockLight);
+				bool tileOK = !blockerFlag;
+
+				if (VisionCrawlTable[j][k].deltaX > 0 && VisionCrawlTable[j][k].deltaY > 0) {
+					tileOK = tileOK || TileAllowsLight(crawl + Displacement { -factor.deltaX, 0 });
+					tileOK = tileOK || TileAllowsLight(crawl + Displacement { 0, -factor.deltaY });
+				}
+
+				if (!tileOK)
+					break;
+
+				visit(crawl, !blockerFlag);
+
+				if (blockerFlag)
+					break;
+			}
+		}
+	}
+}
+
+void ApplyVision(const VisionField &field, MapExplorationType doAutomap, bool visible)
+{
+	for (const VisionTile &tile : field.tiles) {
+		const Point position = tile.position;
+		DungeonFlag &flags = dFlags[position.x][position.y];
+		if (doAutomap != MAP_EXP_NONE) {
+			// SetAutomapView only ever raises the exploration, so a single call stands for all the visits
+			if (tile.revisited || flags != DungeonFlag::None)
+				SetAutomapView(position, doAutomap);
+			flags |= DungeonFlag::Explored;
+		}
+		if (visible)
+			flags |= DungeonFlag::Lit;
+		flags |= DungeonFlag::Visible;
+
+		if (tile.seeThrough) {
+			int8_t trans = dTransVal[position.x][position.y];
+			if (trans != 0)
+				TransList[trans] = true;
+		}
 	}
-	if (visible)
-		dFlags[position.x][position.y] |= DungeonFlag::Lit;
-	dFlags[position.x][position.y] |= DungeonFlag::Visible;
 }
 
 } // namespace
@@ -210,63 +481,26 @@ void DoLighting(Point position, uint8_t radius, DisplacementOf<int8_t> offset)
 	assert(radius >= 0 && radius <= NumLightRadiuses);
 	assert(InDungeonBounds(position));
 
-	DisplacementOf<int8_t> light = {};
-	DisplacementOf<int8_t> block = {};
+	NormalizeLightOffset(position, offset);
 
-	if (offset.deltaX < 0) {
-		offset.deltaX += 8;
-		position -= { 1, 0 };
-	}
-	if (offset.deltaY < 0) {
-		offset.deltaY += 8;
-		position -= { 0, 1 };
+	// The stamps are missing when levels are generated without loading them, e.g. in tests
+	if (!LightStamps.empty()
+	    && position.x > MaxLightReach && position.x + MaxLightReach < MAXDUNX
+	    && position.y > MaxLightReach && position.y + MaxLightReach < MAXDUNY) {
+		ApplyLightStamp(LoadingMapObjects ? dPreLight : dLight, position, radius, offset);
+		return;
 	}
 
-	DisplacementOf<int8_t> dist = offset;
-
-	int minX = 15;
-	if (position.x - 15 < 0) {
-		minX = position.x + 1;
-	}
-	int maxX = 15;
-	if (position.x + 15 > MAXDUNX) {
-		maxX = MAXDUNX - position.x;
-	}
-	int minY = 15;
-	if (position.y - 15 < 0) {
-		minY = position.y + 1;
-	}
-	int maxY = 15;
-	if (position.y + 15 > MAXDUNY) {
-		maxY = MAXDUNY - position.y;
-	}
+	DrawLightCone(position, radius, offset);
+}
 
-	// Allow for dim lights in crypt and nest
-	if (IsAnyOf(leveltype, DTYPE_NEST, DTYPE_CRYPT)) {
-		if (GetLight(position) > LightFalloffs[radius][0])
-			SetLight(position, LightFalloffs[radius][0]);
-	} else {
-		SetLight(position, 0);
-	}
+void DoLightingWithoutStamps(Point position, uint8_t radius, DisplacementOf<int8_t> offset)
+{
+	assert(radius >= 0 && radius <= NumLightRadiuses);
+	assert(InDungeonBounds(position));
 
-	for (int i = 0; i < 4; i++) {
-		int yBound = i > 0 && i < 3 ? maxY : minY;
-		int xBound = i < 2 ? maxX : minX;
-		for (int y = 0; y < yBound; y++) {
-			for (int x = 1; x < xBound; x++) {
-				int linearDistance = LightConeInterpolations[offset.deltaX][offset.deltaY][x + block.deltaX][y + block.deltaY];
-				if (linearDistance >= 128)
-					continue;
-				Point temp = position + (Displacement { x, y }).Rotate(-i);
-				uint8_t v = LightFalloffs[radius][linearDistance];
-				if (!InDungeonBounds(temp))
-					continue;
-				if (v < GetLight(temp))
-					SetLight(temp, v);
-			}
-		}
-		RotateRadius(offset, dist, light, block);
-	}
+	NormalizeLightOffset(position, offset);
+	DrawLightCone(position, radius, offset);
 }
 
 void DoUnVision(Point position, uint8_t radius)
@@ -284,38 +518,9 @@ void DoUnVision(Point position, uint8_t radius)
 
 void DoVision(Point position, uint8_t radius, MapExplorationType doAutomap, bool visible)
 {
-	DoVisionFlags(position, doAutomap, visible);
-
-	static const Displacement factors[] = { { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
-	for (auto factor : factors) {
-		for (int j = 0; j < 23; j++) {
-			int lineLen = radius - RadiusAdj[j];
-			for (int k = 0; k < lineLen; k++) {
-				Point crawl = position + VisionCrawlTable[j][k] * factor;
-				if (!InDungeonBounds(crawl))
-					break;
-				bool blockerFlag = TileHasAny(dPiece[crawl.x][crawl.y], TileProperties::BlockLight);
-				bool tileOK = !blockerFlag;
-
-				if (VisionCrawlTable[j][k].deltaX > 0 && VisionCrawlTable[j][k].deltaY > 0) {
-					tileOK = tileOK || TileAllowsLight(crawl + Displacement { -factor.deltaX, 0 });
-					tileOK = tileOK || TileAllowsLight(crawl + Displacement { 0, -factor.deltaY });
-				}
-
-				if (!tileOK)
-					break;
-
-				DoVisionFlags(crawl, doAutomap, visible);
-
-				if (blockerFlag)
-					break;
-
-				int8_t trans = dTransVal[crawl.x][crawl.y];
-				if (trans != 0)
-					TransList[trans] = true;
-			}
-		}
-	}
+	VisionField field;
+	CrawlVision(position, radius, field);
+	ApplyVision(field, doAutomap, visible);
 }
 
 void MakeLightTable()
@@ -367,6 +572,8 @@ void MakeLightTable()
 		std::fill_n(LightTables[15].begin() + 1, 15, 1);
 	}
 
+	InvalidatePreLitTiles();
+
 	LoadFileInMem("plrgfx\\infra.trn", InfravisionTable);
 	LoadFileInMem("plrgfx\\stone.trn", StoneTable);
 	LoadFileInMem("gendata\\pause.trn", PauseTable);
@@ -408,6 +615,8 @@ void MakeLightTable()
 			}
 		}
 	}
+
+	MakeLightStamps();
 }
 
 #ifdef _DEBUG
@@ -426,6 +635,7 @@ void ToggleLighting()
 			DoLighting(player.position.tile, player._pLightRad, {});
 		}
 	}
+	UpdateLighting = true;
 }
 #endif
 
@@ -433,6 +643,8 @@ void InitLighting()
 {
 	ActiveLightCount = 0;
 	UpdateLighting = false;
+	LightsChanged = false;
+	NewLights = {};
 	UpdateVision = false;
 #ifdef _DEBUG
 	DisableLighting = false;
@@ -440,6 +652,7 @@ void InitLighting()
 
 	std::iota(ActiveLights.begin(), ActiveLights.end(), uint8_t { 0 });
 	VisionActive = {};
+	InvalidateVisionCache();
 	TransList = {};
 }
 
@@ -459,8 +672,9 @@ int AddLight(Point position, uint8_t radius)
 	light.position.offset = { 0, 0 };
 	light.isInvalid = false;
 	light.hasChanged = false;
+	NewLights[lid] = true;
 
-	UpdateLighting = true;
+	LightsChanged = true;
 
 	return lid;
 }
@@ -476,7 +690,7 @@ void AddUnLight(int i)
 
 	Lights[i].isInvalid = true;
 
-	UpdateLighting = true;
+	LightsChanged = true;
 }
 
 void ChangeLightRadius(int i, uint8_t radius)
@@ -494,7 +708,7 @@ void ChangeLightRadius(int i, uint8_t radius)
 	light.oldRadius = light.radius;
 	light.radius = radius;
 
-	UpdateLighting = true;
+	LightsChanged = true;
 }
 
 void ChangeLightXY(int i, Point position)
@@ -512,7 +726,7 @@ void ChangeLightXY(int i, Point position)
 	light.oldRadius = light.radius;
 	light.position.tile = position;
 
-	UpdateLighting = true;
+	LightsChanged = true;
 }
 
 void ChangeLightOffset(int i, DisplacementOf<int8_t> offset)
@@ -533,7 +747,7 @@ void ChangeLightOffset(int i, DisplacementOf<int8_t> offset)
 	light.oldRadius = light.radius;
 	light.position.offset = offset;
 
-	UpdateLighting = true;
+	LightsChanged = true;
 }
 
 void ChangeLight(int i, Point position, uint8_t radius)
@@ -552,7 +766,7 @@ void ChangeLight(int i, Point position, uint8_t radius)
 	light.position.tile = position;
 	light.radius = radius;
 
-	UpdateLighting = true;
+	LightsChanged = true;
 }
 
 void ProcessLightList()
@@ -561,20 +775,29 @@ void ProcessLightList()
 	if (DisableLighting)
 		return;
 #endif
-	if (!UpdateLighting)
+	if (!UpdateLighting && !LightsChanged)
 		return;
+
+	// Lights that have to be drawn again, the others are still in dLight unless they reach into an unlit area
+	std::array<bool, MAXLIGHTS> redraw = NewLights;
+	StaticVector<UnlitArea, MAXLIGHTS * 2> unlitAreas;
 	for (int i = 0; i < ActiveLightCount; i++) {
-		Light &light = Lights[ActiveLights[i]];
+		const int lid = ActiveLights[i];
+		Light &light = Lights[lid];
 		if (light.isInvalid) {
 			DoUnLight(light.position.tile, light.radius);
+			unlitAreas.emplace_back(UnlitArea { light.position.tile, light.radius });
 		}
 		if (light.hasChanged) {
 			DoUnLight(light.position.old, light.oldRadius);
+			unlitAreas.emplace_back(UnlitArea { light.position.old, light.oldRadius });
 			light.hasChanged = false;
+			redraw[lid] = true;
 		}
 	}
 	for (int i = 0; i < ActiveLightCount; i++) {
-		const Light &light = Lights[ActiveLights[i]];
+		const int lid = ActiveLights[i];
+		const Light &light = Lights[lid];
 		if (light.isInvalid) {
 			ActiveLightCount--;
 			std::swap(ActiveLights[ActiveLightCount], ActiveLights[i]);
@@ -583,10 +806,16 @@ void ProcessLightList()
 		}
 		if (TileHasAny(dPiece[light.position.tile.x][light.position.tile.y], TileProperties::Solid))
 			continue; // Monster hidden in a wall, don't spoil the surprise
+		if (!UpdateLighting && !redraw[lid]
+		    && std::none_of(unlitAreas.begin(), unlitAreas.end(), [&light](const UnlitArea &area) { return LightReaches(light.position.tile, light.radius, area); })) {
+			continue;
+		}
 		DoLighting(light.position.tile, light.radius, light.position.offset);
 	}
 
 	UpdateLighting = false;
+	LightsChanged = false;
+	NewLights = {};
 }
 
 void SavePreLighting()
@@ -626,6 +855,12 @@ void ChangeVisionXY(size_t id, Point position)
 	UpdateVision = true;
 }
 
+void InvalidateVisionCache()
+{
+	for (VisionField &field : VisionFields)
+		field.isValid = false;
+}
+
 void ProcessVisionList()
 {
 	if (!UpdateVision)
@@ -656,11 +891,10 @@ void ProcessVisionList()
 		MapExplorationType doautomap = MAP_EXP_SELF;
 		if (&player != MyPlayer)
 			doautomap = player.friendlyMode ? MAP_EXP_OTHERS : MAP_EXP_NONE;
-		DoVision(
-		    vision.position.tile,
-		    vision.radius,
-		    doautomap,
-		    &player == MyPlayer);
+		VisionField &field = VisionFields[id];
+		if (!field.isValid || field.position != vision.position.tile || field.radius != vision.radius)
+			CrawlVision(vision.position.tile, vision.radius, field);
+		ApplyVision(field, doautomap, &player == MyPlayer);
 	}
 
 	UpdateVision = false;
@@ -672,6 +906,7 @@ void lighting_color_cycling()
 		// shift elements between indexes 1-31 to left
 		std::rotate(lightTable.begin() + 1, lightTable.begin() + 2, lightTable.begin() + 32);
 	}
+	InvalidateColorCycledPreLitTiles();
 }
 
 } // namespace devilution
@@ -55,10 +55,17 @@ extern std::array<uint8_t, 256> PauseTable;
 #ifdef _DEBUG
 extern bool DisableLighting;
 #endif
-extern bool UpdateLighting;
+/**
+ * @brief Makes the next ProcessLightList draw every light again.
+ *
+ * Needed after dLight has been reset from dPreLight, otherwise only the areas around lights that changed are redrawn.
+ */
+extern DVL_API_FOR_TEST bool UpdateLighting;
 
 void DoUnLight(Point position, uint8_t radius);
 void DoLighting(Point position, uint8_t radius, DisplacementOf<int8_t> offset);
+/** @brief Same as DoLighting, but always draws the light tile by tile instead of using the precomputed light cones. */
+void DoLightingWithoutStamps(Point position, uint8_t radius, DisplacementOf<int8_t> offset);
 void DoUnVision(Point position, uint8_t radius);
 void DoVision(Point position, uint8_t radius, MapExplorationType doAutomap, bool visible);
 void MakeLightTable();
@@ -77,6 +84,12 @@ void SavePreLighting();
 void ActivateVision(Point position, int r, size_t id);
 void ChangeVisionRadius(size_t id, int r);
 void ChangeVisionXY(size_t id, Point position);
+/**
+ * @brief Makes ProcessVisionList crawl the visions again.
+ *
+ * The tiles a vision sees are kept while the viewer stands still, call this after changing tiles that block light.
+ */
+void InvalidateVisionCache();
 void ProcessVisionList();
 void lighting_color_cycling();
 
@@ -38,6 +38,10 @@
 #include "utils/endian.hpp"
 #include "utils/language.h"
 
+#ifndef UNPACKED_SAVES
+#include "mpq/mpq_sdl_rwops.hpp"
+#endif
+
 namespace devilution {
 
 bool gbIsHellfireSaveGame;
@@ -83,7 +87,108 @@ T SwapBE(T in)
 class LoadHelper {
 	std::unique_ptr<std::byte[]> m_buffer_;
 	size_t m_cur_ = 0;
-	size_t m_size_;
+	size_t m_size_ = 0;
+	// Offsets in the file of the data held in `m_buffer_`.
+	size_t m_bufferBegin_ = 0;
+	size_t m_bufferEnd_ = 0;
+
+#ifndef UNPACKED_SAVES
+	// Size of `m_buffer_` when streaming.
+	static constexpr size_t StreamWindowSize = 4096;
+
+	// Only used when streaming, see the constructor.
+	std::optional<SaveReader> m_archive_;
+	SDL_RWops *m_stream_ = nullptr;
+	std::unique_ptr<CodecDecoder> m_decoder_;
+	std::byte m_signature_[CodecSignatureSize];
+	// Encoded bytes that are yet to be decoded, not counting the signature.
+	size_t m_encodedRemaining_ = 0;
+
+	bool OpenStream(const char *szFileName)
+	{
+		uint32_t fileNumber;
+		if (!m_archive_->GetFileNumber(CalculateMpqFileHash(szFileName), fileNumber))
+			return false;
+		m_stream_ = SDL_RWops_FromMpqFile(*m_archive_, fileNumber, szFileName, /*threadsafe=*/false);
+		if (m_stream_ == nullptr)
+			return false;
+
+		// The signature at the end tells how much of the last chunk is used.
+		const Sint64 encodedSize = SDL_RWsize(m_stream_);
+		if (encodedSize <= static_cast<Sint64>(CodecSignatureSize)
+		    || SDL_RWseek(m_stream_, encodedSize - CodecSignatureSize, RW_SEEK_SET) < 0
+		    || SDL_RWread(m_stream_, m_signature_, CodecSignatureSize, 1) != 1
+		    || SDL_RWseek(m_stream_, 0, RW_SEEK_SET) != 0) {
+			SDL_RWclose(m_stream_);
+			m_stream_ = nullptr;
+			return false;
+		}
+		m_size_ = CodecDecoder::DecodedSize(static_cast<size_t>(encodedSize), m_signature_);
+		if (m_size_ == 0) {
+			SDL_RWclose(m_stream_);
+			m_stream_ = nullptr;
+			return false;
+		}
+		m_encodedRemaining_ = static_cast<size_t>(encodedSize) - CodecSignatureSize;
+		m_decoder_ = std::make_unique<CodecDecoder>(pfile_get_password());
+		m_buffer_.reset(new std::byte[StreamWindowSize]);
+		return true;
+	}
+
+	// Decodes the whole file once and discards the output, so that nothing is loaded from a file whose checksum does not match.
+	bool VerifyStream()
+	{
+		CodecDecoder decoder(pfile_get_password());
+		for (size_t remaining = m_encodedRemaining_; remaining > 0;) {
+			const size_t numChunks = std::min(StreamWindowSize, remaining) / CodecChunkSize;
+			if (SDL_RWread(m_stream_, &m_buffer_[0], CodecChunkSize, numChunks) != numChunks)
+				return false;
+			for (size_t i = 0; i < numChunks; i++)
+				decoder.DecodeChunk(&m_buffer_[i * CodecChunkSize]);
+			remaining -= numChunks * CodecChunkSize;
+		}
+		return decoder.Verify(m_signature_) && SDL_RWseek(m_stream_, 0, RW_SEEK_SET) == 0;
+	}
+
+	void CloseStream()
+	{
+		SDL_RWclose(m_stream_);
+		m_stream_ = nullptr;
+		m_archive_ = std::nullopt;
+	}
+#endif
+
+	// Decodes more of the file so that the `size` bytes at `m_cur_` are in `m_buffer_`.
+	bool Refill(size_t size)
+	{
+#ifdef UNPACKED_SAVES
+		return false;
+#else
+		if (m_stream_ == nullptr || size > StreamWindowSize - CodecChunkSize)
+			return false;
+		while (m_bufferEnd_ < m_cur_ + size) {
+			// Drop the data that has already been read or skipped.
+			const size_t dropUntil = std::min(m_cur_, m_bufferEnd_);
+			const size_t kept = m_bufferEnd_ - dropUntil;
+			memmove(&m_buffer_[0], &m_buffer_[dropUntil - m_bufferBegin_], kept);
+			m_bufferBegin_ = dropUntil;
+
+			const size_t numChunks = std::min(StreamWindowSize - kept, m_encodedRemaining_) / CodecChunkSize;
+			if (numChunks == 0)
+				return false;
+			std::byte *chunks = &m_buffer_[kept];
+			if (SDL_RWread(m_stream_, chunks, CodecChunkSize, numChunks) != numChunks) {
+				m_encodedRemaining_ = 0;
+				return false;
+			}
+			for (size_t i = 0; i < numChunks; i++)
+				m_decoder_->DecodeChunk(&chunks[i * CodecChunkSize]);
+			m_bufferEnd_ += numChunks * CodecChunkSize;
+			m_encodedRemaining_ -= numChunks * CodecChunkSize;
+		}
+		return true;
+#endif
+	}
 
 	template <class T>
 	T Next()
@@ -93,25 +198,71 @@ class LoadHelper {
 			return 0;
 
 		T value;
-		memcpy(&value, &m_buffer_[m_cur_], size);
+		memcpy(&value, &m_buffer_[m_cur_ - m_bufferBegin_], size);
 		m_cur_ += size;
 
 		return value;
 	}
 
+	template <class TSource, class T, size_t Width, size_t Height, class Convert>
+	void NextGrid(T (&grid)[Width][Height], Convert convert)
+	{
+		for (size_t j = 0; j < Height; j++) {
+			TSource row[Width] {};
+			NextBytes(row, sizeof(row));
+			for (size_t i = 0; i < Width; i++)
+				grid[i][j] = convert(row[i]);
+		}
+	}
+
 public:
-	LoadHelper(std::optional<SaveReader> archive, const char *szFileName)
+	/**
+	 * @param stream Decode the file a few KiB at a time instead of reading all of it up front.
+	 *
+	 * The file is decoded twice, once up front to verify its checksum. The archive is kept open until the helper
+	 * is destroyed, so the archive must not be written to while a streaming helper is alive.
+	 */
+	LoadHelper(std::optional<SaveReader> archive, const char *szFileName, [[maybe_unused]] bool stream = false)
 	{
-		if (archive)
+#ifndef UNPACKED_SAVES
+		if (stream && archive) {
+			m_archive_ = std::move(archive);
+			if (OpenStream(szFileName)) {
+				if (!VerifyStream()) {
+					// Leaves the helper without a buffer, i.e. invalid.
+					CloseStream();
+					m_buffer_ = nullptr;
+					m_size_ = 0;
+				}
+				return;
+			}
+			archive = std::move(m_archive_);
+		}
+#endif
+		if (archive) {
 			m_buffer_ = ReadArchive(*archive, szFileName, &m_size_);
-		else
+			m_bufferEnd_ = m_size_;
+		} else {
 			m_buffer_ = nullptr;
+		}
 	}
 
+	~LoadHelper()
+	{
+#ifndef UNPACKED_SAVES
+		if (m_stream_ != nullptr)
+			CloseStream();
+#endif
+	}
+
+	LoadHelper(const LoadHelper &) = delete;
+	LoadHelper &operator=(const LoadHelper &) = delete;
+
 	bool IsValid(size_t size = 1)
 	{
 		return m_buffer_ != nullptr
-		    && m_size_ >= (m_cur_ + size);
+		    && m_size_ >= (m_cur_ + size)
+		    && (m_bufferEnd_ >= (m_cur_ + size) || Refill(size));
 	}
 
 	template <typename T>
@@ -130,10 +281,30 @@ public:
 		if (!IsValid(size))
 			return;
 
-		memcpy(bytes, &m_buffer_[m_cur_], size);
+		memcpy(bytes, &m_buffer_[m_cur_ - m_bufferBegin_], size);
 		m_cur_ += size;
 	}
 
+	/** @brief Reads a little-endian `[x][y]` grid, stored row by row. */
+	template <class TSource, class T, size_t Width, size_t Height>
+	void NextGridLE(T (&grid)[Width][Height])
+	{
+		NextGrid<TSource>(grid, [](TSource value) { return static_cast<T>(SwapLE(value)); });
+	}
+
+	template <class TSource, class T, size_t Width, size_t Height, class Convert>
+	void NextGridLE(T (&grid)[Width][Height], Convert convert)
+	{
+		NextGrid<TSource>(grid, [&convert](TSource value) { return convert(SwapLE(value)); });
+	}
+
+	/** @brief Reads a big-endian `[x][y]` grid, stored row by row. */
+	template <class TSource, class T, size_t Width, size_t Height>
+	void NextGridBE(T (&grid)[Width][Height])
+	{
+		NextGrid<TSource>(grid, [](TSource value) { return static_cast<T>(SwapBE(value)); });
+	}
+
 	template <class T>
 	T NextLE()
 	{
@@ -224,13 +395,22 @@ public:
 
 	~SaveHelper()
 	{
-		const auto encodedLen = codec_get_encoded_len(m_cur_);
-		const char *const password = pfile_get_password();
-		codec_encode(m_buffer_.get(), m_cur_, encodedLen, password);
-		m_mpqWriter.WriteFile(m_szFileName_, m_buffer_.get(), encodedLen);
+		// Encoding is deferred until the archive is written, which may happen on a worker thread.
+		m_mpqWriter.WriteEncodedFile(m_szFileName_, std::move(m_buffer_), m_cur_, pfile_get_password());
 	}
 };
 
+DungeonFlag LoadDungeonFlag(uint8_t flags)
+{
+	return static_cast<DungeonFlag>(flags) & DungeonFlag::LoadedFlags;
+}
+
+uint8_t LoadAutomapView(uint8_t value)
+{
+	const auto automapView = static_cast<MapExplorationType>(value);
+	return automapView == MAP_EXP_OLD ? MAP_EXP_SELF : automapView;
+}
+
 void LoadItemData(LoadHelper &file, Item &item)
 {
 	item._iSeed = file.NextLE<uint32_t>();
@@ -1731,7 +1911,7 @@ void SaveAdditionalMissiles(SaveWriter &saveWriter)
 
 	if (missileCountAdditional > 0) {
 		auto it = Missiles.cbegin();
-		// std::list::const_iterator doesn't provide operator+() :/ using std::advance to get past the missiles we've already saved
+		// Missiles only provides forward iterators, using std::advance to get past the missiles we've already saved
 		std::advance(it, MaxMissilesForSaveGame);
 		for (; it != Missiles.cend(); it++) {
 			SaveMissile(&file, *it);
@@ -2124,6 +2304,7 @@ void LoadGame(bool firstflag)
 {
 	FreeGameMem();
 
+	// Not streamed: loading converts the levels and saves the game, which must not happen while the archive is open.
 	LoadHelper file(OpenSaveArchive(gSaveNumber), "game");
 	if (!file.IsValid())
 		app_fatal(_("Unable to open save file archive"));
@@ -2249,47 +2430,25 @@ void LoadGame(bool firstflag)
 		uniqueItemFlag = file.NextBool8();
 
 	file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
-	for (int j = 0; j < MAXDUNY; j++) {
-		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			dFlags[i][j] = static_cast<DungeonFlag>(file.NextLE<uint8_t>()) & DungeonFlag::LoadedFlags;
-	}
-	for (int j = 0; j < MAXDUNY; j++) {
-		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			dPlayer[i][j] = file.NextLE<int8_t>();
-	}
+	file.NextGridLE<uint8_t>(dFlags, LoadDungeonFlag);
+	file.NextGridLE<int8_t>(dPlayer);
 
 	// skip dItem indexes, this gets populated in LoadDroppedItems
 	file.Skip<uint8_t>(MAXDUNX * MAXDUNY);
 
 	if (leveltype != DTYPE_TOWN) {
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dMonster[i][j] = file.NextBE<int32_t>();
-		}
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dCorpse[i][j] = file.NextLE<int8_t>();
-		}
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dObject[i][j] = file.NextLE<int8_t>();
-		}
+		file.NextGridBE<int32_t>(dMonster);
+		file.NextGridLE<int8_t>(dCorpse);
+		file.NextGridLE<int8_t>(dObject);
 		file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dPreLight[i][j] = file.NextLE<uint8_t>();
-		}
-		for (int j = 0; j < DMAXY; j++) {
-			for (int i = 0; i < DMAXX; i++) { // NOLINT(modernize-loop-convert)
-				const auto automapView = static_cast<MapExplorationType>(file.NextLE<uint8_t>());
-				AutomapView[i][j] = automapView == MAP_EXP_OLD ? MAP_EXP_SELF : automapView;
-			}
-		}
+		file.NextGridLE<uint8_t>(dPreLight);
+		file.NextGridLE<uint8_t>(AutomapView, LoadAutomapView);
 		file.Skip(MAXDUNX * MAXDUNY); // dMissile
 
 		// No need to load dLight, we can recreate it accurately from LightList
 		memcpy(dLight, dPreLight, sizeof(dLight));               // resets the light on entering a level to get rid of incorrect light
 		ChangeLightXY(myPlayer.lightId, myPlayer.position.tile); // forces player light refresh
+		UpdateLighting = true;
 	} else {
 		memset(dLight, 0, sizeof(dLight));
 	}
@@ -2659,15 +2818,12 @@ void LoadLevel()
 	GetTempLevelNames(szName);
 	if (!archive || !archive->HasFile(szName))
 		GetPermLevelNames(szName);
-	LoadHelper file(std::move(archive), szName);
+	LoadHelper file(std::move(archive), szName, /*stream=*/true);
 	if (!file.IsValid())
 		app_fatal(_("Unable to open save file archive"));
 
 	if (leveltype != DTYPE_TOWN) {
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dCorpse[i][j] = file.NextLE<int8_t>();
-		}
+		file.NextGridLE<int8_t>(dCorpse);
 		MoveLightsToCorpses();
 	}
 
@@ -2702,38 +2858,22 @@ void LoadLevel()
 
 	LoadDroppedItems(file, savedItemCount);
 
-	for (int j = 0; j < MAXDUNY; j++) {
-		for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-			dFlags[i][j] = static_cast<DungeonFlag>(file.NextLE<uint8_t>()) & DungeonFlag::LoadedFlags;
-	}
+	file.NextGridLE<uint8_t>(dFlags, LoadDungeonFlag);
 
 	// skip dItem indexes, this gets populated in LoadDroppedItems
 	file.Skip<uint8_t>(MAXDUNX * MAXDUNY);
 
 	if (leveltype != DTYPE_TOWN) {
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dMonster[i][j] = file.NextBE<int32_t>();
-		}
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dObject[i][j] = file.NextLE<int8_t>();
-		}
+		file.NextGridBE<int32_t>(dMonster);
+		file.NextGridLE<int8_t>(dObject);
 		file.Skip<uint8_t>(MAXDUNY * MAXDUNX); // dLight
-		for (int j = 0; j < MAXDUNY; j++) {
-			for (int i = 0; i < MAXDUNX; i++) // NOLINT(modernize-loop-convert)
-				dPreLight[i][j] = file.NextLE<uint8_t>();
-		}
-		for (int j = 0; j < DMAXY; j++) {
-			for (int i = 0; i < DMAXX; i++) { // NOLINT(modernize-loop-convert)
-				const auto automapView = static_cast<MapExplorationType>(file.NextLE<uint8_t>());
-				AutomapView[i][j] = automapView == MAP_EXP_OLD ? MAP_EXP_SELF : automapView;
-			}
-		}
+		file.NextGridLE<uint8_t>(dPreLight);
+		file.NextGridLE<uint8_t>(AutomapView, LoadAutomapView);
 
 		// No need to load dLight, we can recreate it accurately from LightList
 		memcpy(dLight, dPreLight, sizeof(dLight));                                     // resets the light on entering a level to get rid of incorrect light
 		ChangeLightXY(Players[MyPlayerId].lightId, Players[MyPlayerId].position.tile); // forces player light refresh
+		UpdateLighting = true;
 	} else {
 		memset(dLight, 0, sizeof(dLight));
 	}
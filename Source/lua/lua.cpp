@@ -10,6 +10,7 @@
 
 #include "appfat.h"
 #include "engine/assets.hpp"
+#include "lua/modules/assets.hpp"
 #include "lua/modules/audio.hpp"
 #include "lua/modules/log.hpp"
 #include "lua/modules/render.hpp"
@@ -221,6 +222,7 @@ void LuaInitialize()
 #endif
 	    "devilutionx.version", PROJECT_VERSION,
 	    "devilutionx.log", LuaLogModule(lua),
+	    "devilutionx.assets", LuaAssetsModule(lua),
 	    "devilutionx.audio", LuaAudioModule(lua),
 	    "devilutionx.render", LuaRenderModule(lua),
 	    "devilutionx.message", [](std::string_view text) { EventPlrMsg(text, UiFlags::ColorRed); },
@@ -0,0 +1,50 @@
+#include "lua/modules/assets.hpp"
+
+#include <optional>
+#include <string>
+
+#include <sol/sol.hpp>
+
+#include "engine/asset_stats.hpp"
+#include "lua/metadoc.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
+
+#ifndef UNPACKED_MPQS
+#include "mpq/mpq_sdl_rwops.hpp"
+#endif
+
+namespace devilution {
+
+namespace {
+
+std::string ToggleAssetStats(std::optional<bool> on)
+{
+	SetAssetStatsEnabled(on.value_or(!IsAssetStatsEnabled()));
+	return StrCat("Asset stats: ", IsAssetStatsEnabled() ? "On" : "Off");
+}
+
+std::string ExportAssetStats(std::optional<std::string> path)
+{
+	const std::string csvPath = path.value_or(paths::PrefPath() + "asset_stats.csv");
+	if (!ExportAssetStatsCsv(csvPath))
+		return StrCat("Failed to write ", csvPath);
+	std::string result = StrCat("Wrote ", static_cast<unsigned>(GetAssetStatsRecordCount()), " records to ", csvPath);
+#ifndef UNPACKED_MPQS
+	const MpqBlockCacheStats cacheStats = GetMpqBlockCacheStats();
+	StrAppend(result, "\nMPQ block cache: ", cacheStats.hits, " hits, ", cacheStats.misses, " misses");
+#endif
+	return result;
+}
+
+} // namespace
+
+sol::table LuaAssetsModule(sol::state_view &lua)
+{
+	sol::table table = lua.create_table();
+	SetDocumented(table, "stats", "(on: boolean = nil)", "Toggle asset loading stats collection.", &ToggleAssetStats);
+	SetDocumented(table, "exportStats", "(path: string = nil)", "Write the collected asset loading stats as CSV, to asset_stats.csv in the config folder by default.", &ExportAssetStats);
+	return table;
+}
+
+} // namespace devilution
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <sol/sol.hpp>
+
+namespace devilution {
+
+sol::table LuaAssetsModule(sol::state_view &lua);
+
+} // namespace devilution
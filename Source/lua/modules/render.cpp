@@ -1,16 +1,44 @@
 #include "lua/modules/render.hpp"
 
+#include <optional>
+#include <string>
+
 #include <sol/sol.hpp>
 
 #include "engine/dx.h"
+#include "engine/render/render_stats.hpp"
 #include "engine/render/text_render.hpp"
+#include "lua/metadoc.hpp"
+#include "utils/paths.h"
+#include "utils/str_cat.hpp"
 
 namespace devilution {
 
+namespace {
+
+std::string ToggleRenderStats(std::optional<bool> on)
+{
+	SetRenderStatsEnabled(on.value_or(!RenderStatsEnabled));
+	return StrCat("Render stats: ", RenderStatsEnabled ? "On" : "Off");
+}
+
+std::string ExportRenderStats(std::optional<std::string> path)
+{
+	const std::string csvPath = path.value_or(paths::PrefPath() + "render_stats.csv");
+	if (!ExportRenderStatsCsv(csvPath))
+		return StrCat("Failed to write ", csvPath);
+	return StrCat("Wrote ", static_cast<unsigned>(GetRenderStatsFrameCount()), " frames to ", csvPath);
+}
+
+} // namespace
+
 sol::table LuaRenderModule(sol::state_view &lua)
 {
-	return lua.create_table_with(
+	sol::table table = lua.create_table_with(
 	    "string", [](std::string_view text, int x, int y) { DrawString(GlobalBackBuffer(), text, { x, y }); });
+	SetDocumented(table, "stats", "(on: boolean = nil)", "Toggle the render stats overlay.", &ToggleRenderStats);
+	SetDocumented(table, "exportStats", "(path: string = nil)", "Write the recent render stats as CSV, to render_stats.csv in the config folder by default.", &ExportRenderStats);
+	return table;
 }
 
 } // namespace devilution
@@ -30,7 +30,7 @@
 
 namespace devilution {
 
-std::list<Missile> Missiles;
+PooledList<Missile> Missiles;
 bool MissilePreFlag;
 
 namespace {
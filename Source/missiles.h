@@ -6,7 +6,6 @@
 #pragma once
 
 #include <cstdint>
-#include <list>
 #include <optional>
 
 #include "engine.h"
@@ -16,6 +15,7 @@
 #include "monster.h"
 #include "player.h"
 #include "spelldat.h"
+#include "utils/pooled_list.hpp"
 
 namespace devilution {
 
@@ -175,7 +175,7 @@ struct Missile {
 	}
 };
 
-extern std::list<Missile> Missiles;
+extern PooledList<Missile> Missiles;
 extern bool MissilePreFlag;
 
 struct DamageRange {
@@ -20,11 +20,14 @@
 #include "control.h"
 #include "cursor.h"
 #include "dead.h"
+#include "engine/assets.hpp"
+#include "engine/clx_cache.hpp"
 #include "engine/load_cl2.hpp"
 #include "engine/load_file.hpp"
 #include "engine/points_in_rectangle_range.hpp"
 #include "engine/random.hpp"
 #include "engine/render/clx_render.hpp"
+#include "engine/render/clx_spans.hpp"
 #include "engine/sound_position.hpp"
 #include "engine/world_tile.hpp"
 #include "init.h"
@@ -3098,10 +3101,49 @@ bool UpdateModeStance(Monster &monster)
 	}
 }
 
+#ifndef UNPACKED_MPQS
+/** @brief Loads the converted sprites of all the monster's animations from the CLX cache, if they are all there. */
+std::optional<MonsterSpritesData> LoadCachedMonsterSpritesData(const MonsterData &monsterData)
+{
+	const size_t numAnims = GetNumAnims(monsterData);
+	const FileNameWithCharAffixGenerator pathFn({ "monsters\\", monsterData.spritePath() }, DEVILUTIONX_CL2_EXT, Animletter);
+	std::vector<std::unique_ptr<uint8_t[]>> anims;
+	std::vector<size_t> animSizes;
+	for (size_t i = 0; i < numAnims; ++i) {
+		if (!monsterData.hasAnim(i))
+			continue;
+		size_t size;
+		uint16_t numLists;
+		anims.emplace_back(LoadCachedClx(pathFn(i), monsterData.width, size, numLists));
+		if (anims.back() == nullptr)
+			return std::nullopt;
+		animSizes.push_back(size);
+	}
+
+	MonsterSpritesData result;
+	size_t accumulatedSize = 0;
+	for (size_t j = 0; j < anims.size(); ++j) {
+		result.offsets[j] = static_cast<uint32_t>(accumulatedSize);
+		accumulatedSize += animSizes[j];
+	}
+	result.offsets[anims.size()] = static_cast<uint32_t>(accumulatedSize);
+	result.data = std::unique_ptr<std::byte[]>(new std::byte[accumulatedSize]);
+	for (size_t j = 0; j < anims.size(); ++j) {
+		memcpy(&result.data[result.offsets[j]], anims[j].get(), animSizes[j]);
+	}
+	return result;
+}
+#endif
+
 MonsterSpritesData LoadMonsterSpritesData(const MonsterData &monsterData)
 {
 	const size_t numAnims = GetNumAnims(monsterData);
 
+#ifndef UNPACKED_MPQS
+	if (std::optional<MonsterSpritesData> cached = LoadCachedMonsterSpritesData(monsterData))
+		return std::move(*cached);
+#endif
+
 	MonsterSpritesData result;
 	result.data = MultiFileLoader<MonsterSpritesData::MaxAnims> {}(
 	    numAnims,
@@ -3111,6 +3153,7 @@ MonsterSpritesData LoadMonsterSpritesData(const MonsterData &monsterData)
 
 #ifndef UNPACKED_MPQS
 	// Convert CL2 to CLX:
+	const FileNameWithCharAffixGenerator pathFn({ "monsters\\", monsterData.spritePath() }, DEVILUTIONX_CL2_EXT, Animletter);
 	std::vector<std::vector<uint8_t>> clxData;
 	size_t accumulatedSize = 0;
 	for (size_t i = 0, j = 0; i < numAnims; ++i) {
@@ -3119,8 +3162,9 @@ MonsterSpritesData LoadMonsterSpritesData(const MonsterData &monsterData)
 		const uint32_t begin = result.offsets[j];
 		const uint32_t end = result.offsets[j + 1];
 		clxData.emplace_back();
-		Cl2ToClx(reinterpret_cast<uint8_t *>(&result.data[begin]), end - begin,
+		const uint16_t numLists = Cl2ToClx(reinterpret_cast<uint8_t *>(&result.data[begin]), end - begin,
 		    PointerOrValue<uint16_t> { monsterData.width }, clxData.back());
+		StoreCachedClx(pathFn(i), monsterData.width, clxData.back().data(), clxData.back().size(), numLists);
 		result.offsets[j] = static_cast<uint32_t>(accumulatedSize);
 		accumulatedSize += clxData.back().size();
 		++j;
@@ -3136,6 +3180,31 @@ MonsterSpritesData LoadMonsterSpritesData(const MonsterData &monsterData)
 	return result;
 }
 
+/**
+ * @brief Copies the sprites of all the animations, followed by their span tables.
+ */
+std::unique_ptr<std::byte[]> CopyMonsterSpritesWithSpanTables(const MonsterSpritesData &spritesData, size_t numAnims)
+{
+	const auto *data = reinterpret_cast<const uint8_t *>(spritesData.data.get());
+	const uint32_t dataSize = spritesData.offsets[numAnims];
+	std::array<size_t, MonsterSpritesData::MaxAnims> tablesSizes;
+	size_t totalSize = GetClxSpanTablesOffset(dataSize);
+	for (size_t i = 0; i < numAnims; ++i) {
+		tablesSizes[i] = MeasureClxSpanTables(&data[spritesData.offsets[i]], spritesData.offsets[i + 1] - spritesData.offsets[i]);
+		totalSize += tablesSizes[i];
+	}
+
+	std::unique_ptr<std::byte[]> result { new std::byte[totalSize] };
+	auto *resultData = reinterpret_cast<uint8_t *>(result.get());
+	memcpy(resultData, data, dataSize);
+	uint8_t *tables = &resultData[GetClxSpanTablesOffset(dataSize)];
+	for (size_t i = 0; i < numAnims; ++i) {
+		WriteClxSpanTables(&resultData[spritesData.offsets[i]], spritesData.offsets[i + 1] - spritesData.offsets[i], tables);
+		tables += tablesSizes[i];
+	}
+	return result;
+}
+
 void EnsureMonsterIndexIsActive(size_t monsterId)
 {
 	assert(monsterId < MaxMonsters);
@@ -3419,7 +3488,7 @@ void InitMonsterGFX(CMonster &monsterType, MonsterSpritesData &&spritesData)
 	const MonsterData &monsterData = MonstersData[mtype];
 	if (spritesData.data == nullptr)
 		spritesData = LoadMonsterSpritesData(monsterData);
-	monsterType.animData = std::move(spritesData.data);
+	monsterType.animData = CopyMonsterSpritesWithSpanTables(spritesData, GetNumAnimsWithGraphics(monsterData));
 
 	const size_t numAnims = GetNumAnims(monsterData);
 	for (size_t i = 0, j = 0; i < numAnims; ++i) {
@@ -3482,6 +3551,27 @@ void InitMonsterGFX(CMonster &monsterType, MonsterSpritesData &&spritesData)
 		GetMissileSpriteData(MissileGraphicID::DiabloApocalypseBoom).LoadGFX();
 }
 
+void PrefetchMonsterGFX()
+{
+	if (HeadlessMode)
+		return;
+
+	std::vector<std::string> paths;
+	for (size_t i = 0; i < LevelMonsterTypeCount; ++i) {
+		const CMonster &monsterType = LevelMonsterTypes[i];
+		if (monsterType.animData != nullptr)
+			continue;
+		const MonsterData &monsterData = monsterType.data();
+		const FileNameWithCharAffixGenerator pathFn({ "monsters\\", monsterData.spritePath() }, DEVILUTIONX_CL2_EXT, Animletter);
+		const size_t numAnims = GetNumAnims(monsterData);
+		for (size_t j = 0; j < numAnims; ++j) {
+			if (monsterData.hasAnim(j) && !HasCachedClx(pathFn(j), monsterData.width))
+				paths.emplace_back(pathFn(j));
+		}
+	}
+	PrefetchAssets(paths);
+}
+
 void InitAllMonsterGFX()
 {
 	if (HeadlessMode)
@@ -489,6 +489,12 @@ inline size_t AddMonsterType(UniqueMonsterType uniqueType, placeflag placeflag)
 }
 void InitMonsterSND(CMonster &monsterType);
 void InitMonsterGFX(CMonster &monsterType, MonsterSpritesData &&spritesData = {});
+/**
+ * @brief Starts reading the graphics of the level's monster types in the background.
+ *
+ * Call right after `GetLevelMTypes`, `InitAllMonsterGFX` then picks up the data.
+ */
+void PrefetchMonsterGFX();
 void InitAllMonsterGFX();
 void WeakenNaKrul();
 void InitGolems();
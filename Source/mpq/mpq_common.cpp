@@ -1,5 +1,7 @@
 #include "mpq/mpq_common.hpp"
 
+#include <array>
+#include <cstdint>
 #include <string_view>
 
 #include <libmpq/mpq.h>
@@ -7,12 +9,53 @@
 namespace devilution {
 
 #if !defined(UNPACKED_MPQS) || !defined(UNPACKED_SAVES)
+namespace {
+
+constexpr uint32_t MpqHashFileKey = 3;
+
+std::array<uint32_t, 0x500> GenerateCryptTable()
+{
+	std::array<uint32_t, 0x500> table {};
+	uint32_t seed = 0x00100001;
+	for (uint32_t index1 = 0; index1 < 0x100; ++index1) {
+		for (uint32_t i = 0, index2 = index1; i < 5; ++i, index2 += 0x100) {
+			seed = (seed * 125 + 3) % 0x2AAAAB;
+			const uint32_t high = (seed & 0xFFFF) << 16;
+			seed = (seed * 125 + 3) % 0x2AAAAB;
+			table[index2] = high | (seed & 0xFFFF);
+		}
+	}
+	return table;
+}
+
+} // namespace
+
 MpqFileHash CalculateMpqFileHash(std::string_view filename)
 {
 	MpqFileHash fileHash;
 	libmpq__file_hash_s(filename.data(), filename.size(), &fileHash[0], &fileHash[1], &fileHash[2]);
 	return fileHash;
 }
+
+uint32_t CalculateMpqFileKey(std::string_view filename)
+{
+	static const std::array<uint32_t, 0x500> CryptTable = GenerateCryptTable();
+
+	const size_t separator = filename.find_last_of("\\/");
+	if (separator != std::string_view::npos)
+		filename.remove_prefix(separator + 1);
+
+	uint32_t seed1 = 0x7FED7FED;
+	uint32_t seed2 = 0xEEEEEEEE;
+	for (const char c : filename) {
+		uint32_t ch = static_cast<uint8_t>(c);
+		if (ch >= 'a' && ch <= 'z')
+			ch -= 'a' - 'A';
+		seed1 = CryptTable[(MpqHashFileKey << 8) + ch] ^ (seed1 + seed2);
+		seed2 = ch + seed1 + seed2 + (seed2 << 5) + 3;
+	}
+	return seed1;
+}
 #endif
 
 } // namespace devilution
@@ -73,7 +73,12 @@ struct MpqHashEntry {
 
 struct MpqBlockEntry {
 	static constexpr uint32_t FlagExists = 0x80000000;
+	static constexpr uint32_t FlagEncrypted = 0x00010000;
+	static constexpr uint32_t FlagFixKey = 0x00020000;
+	static constexpr uint32_t FlagSingleUnit = 0x01000000;
+	static constexpr uint32_t FlagSectorCrc = 0x04000000;
 	static constexpr uint32_t CompressPkZip = 0x00000100;
+	static constexpr uint32_t CompressMulti = 0x00000200;
 
 	// Offset to the start of this block.
 	uint32_t offset;
@@ -93,6 +98,9 @@ using MpqFileHash = std::array<std::uint32_t, 3>;
 
 #if !defined(UNPACKED_MPQS) || !defined(UNPACKED_SAVES)
 MpqFileHash CalculateMpqFileHash(std::string_view filename);
+
+// The base encryption key of a file, derived from its name without the directory.
+uint32_t CalculateMpqFileKey(std::string_view filename);
 #endif
 
 } // namespace devilution
@@ -1,13 +1,92 @@
 #include "mpq/mpq_reader.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
 #include <optional>
 #include <string_view>
+#include <utility>
 
 #include <libmpq/mpq.h>
+#include <pkware.h>
+
+#include "utils/endian.hpp"
+#include "utils/file_util.h"
+#include "utils/log.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace devilution {
 
+struct MpqArchive::MappedArchive {
+	explicit MappedArchive(MappedFile &&file)
+	    : file(std::move(file))
+	{
+	}
+
+	MappedFile file;
+	size_t blockSize = 0;
+	uint32_t hashEntriesCount = 0;
+	std::unique_ptr<MpqHashEntry[]> hashTable;
+	uint32_t blockEntriesCount = 0;
+	std::unique_ptr<MpqBlockEntry[]> blockTable;
+	// Block table index of each libmpq file number, or `MpqHashEntry::NullBlock`.
+	std::vector<uint32_t> fileBlocks;
+};
+
+namespace {
+
+// Decrypts a copy of an MPQ table from the mapping.
+// Returns nullptr if the table does not fit in the file.
+template <typename Entry>
+std::unique_ptr<Entry[]> ReadMappedTable(const MappedFile &file, uint32_t offset, uint32_t count, uint32_t key)
+{
+	const size_t tableSize = static_cast<size_t>(count) * sizeof(Entry);
+	if (offset > file.size() || tableSize > file.size() - offset)
+		return nullptr;
+	auto table = std::make_unique<Entry[]>(count);
+	std::memcpy(table.get(), file.data() + offset, tableSize);
+	libmpq__decrypt_block(reinterpret_cast<uint32_t *>(table.get()), static_cast<uint32_t>(tableSize), key);
+	return table;
+}
+
+struct ExplodeState {
+	const uint8_t *in;
+	size_t inSize;
+	uint8_t *out;
+	size_t outSize;
+	bool overflow;
+};
+
+unsigned int ExplodeRead(char *buf, unsigned int *size, void *param) // NOLINT(readability-non-const-parameter)
+{
+	auto &state = *static_cast<ExplodeState *>(param);
+	const size_t n = std::min<size_t>(*size, state.inSize);
+	std::memcpy(buf, state.in, n);
+	state.in += n;
+	state.inSize -= n;
+	return static_cast<unsigned int>(n);
+}
+
+void ExplodeWrite(char *buf, unsigned int *size, void *param) // NOLINT(readability-non-const-parameter)
+{
+	auto &state = *static_cast<ExplodeState *>(param);
+	if (*size > state.outSize) {
+		state.overflow = true;
+		return;
+	}
+	std::memcpy(state.out, buf, *size);
+	state.out += *size;
+	state.outSize -= *size;
+}
+
+std::atomic<uint32_t> NextArchiveId;
+
+} // namespace
+
 std::optional<MpqArchive> MpqArchive::Open(const char *path, int32_t &error)
 {
 	mpq_archive_s *archive;
@@ -17,7 +96,9 @@ std::optional<MpqArchive> MpqArchive::Open(const char *path, int32_t &error)
 			error = 0;
 		return std::nullopt;
 	}
-	return MpqArchive { std::string(path), archive };
+	MpqArchive result { std::string(path), NextArchiveId++, archive };
+	result.MapArchive();
+	return result;
 }
 
 std::optional<MpqArchive> MpqArchive::Clone(int32_t &error)
@@ -26,7 +107,53 @@ std::optional<MpqArchive> MpqArchive::Clone(int32_t &error)
 	error = libmpq__archive_dup(archive_, path_.c_str(), &copy);
 	if (error != 0)
 		return std::nullopt;
-	return MpqArchive { path_, copy };
+	MpqArchive result { path_, id_, copy };
+	result.mapped_ = mapped_;
+	return result;
+}
+
+void MpqArchive::MapArchive()
+{
+#ifdef DEVILUTIONX_MMAP_MPQS
+	// The mapped reader interprets the tables in place, which only works on little-endian CPUs.
+	if (SDL_BYTEORDER != SDL_LIL_ENDIAN)
+		return;
+	std::optional<MappedFile> file = MappedFile::Open(path_.c_str());
+	if (!file)
+		return;
+
+	// Only archives that start at offset 0 are supported (all Diablo MPQs do).
+	MpqFileHeader header;
+	if (file->size() < sizeof(header))
+		return;
+	std::memcpy(&header, file->data(), sizeof(header));
+	if (header.signature != MpqFileHeader::DiabloSignature || header.blockSizeFactor > 16)
+		return;
+
+	auto mapped = std::make_shared<MappedArchive>(std::move(*file));
+	mapped->blockSize = static_cast<size_t>(512) << header.blockSizeFactor;
+	mapped->hashEntriesCount = header.hashEntriesCount;
+	mapped->hashTable = ReadMappedTable<MpqHashEntry>(mapped->file, header.hashEntriesOffset, header.hashEntriesCount, LIBMPQ_HASH_TABLE_HASH_KEY);
+	mapped->blockEntriesCount = header.blockEntriesCount;
+	mapped->blockTable = ReadMappedTable<MpqBlockEntry>(mapped->file, header.blockEntriesOffset, header.blockEntriesCount, LIBMPQ_BLOCK_TABLE_HASH_KEY);
+	if (mapped->hashTable == nullptr || mapped->blockTable == nullptr)
+		return;
+
+	// libmpq file numbers do not necessarily match block indices, so we map them here.
+	for (uint32_t i = 0; i < mapped->hashEntriesCount; ++i) {
+		const MpqHashEntry &entry = mapped->hashTable[i];
+		if (entry.block >= mapped->blockEntriesCount)
+			continue;
+		uint32_t fileNumber;
+		if (!GetFileNumber({ i, entry.hashA, entry.hashB }, fileNumber))
+			continue;
+		if (fileNumber >= mapped->fileBlocks.size())
+			mapped->fileBlocks.resize(fileNumber + 1, MpqHashEntry::NullBlock);
+		mapped->fileBlocks[fileNumber] = entry.block;
+	}
+	LogVerbose("Memory-mapped {}", path_);
+	mapped_ = std::move(mapped);
+#endif
 }
 
 const char *MpqArchive::ErrorMessage(int32_t errorCode)
@@ -37,10 +164,15 @@ const char *MpqArchive::ErrorMessage(int32_t errorCode)
 MpqArchive &MpqArchive::operator=(MpqArchive &&other) noexcept
 {
 	path_ = std::move(other.path_);
+	id_ = other.id_;
 	if (archive_ != nullptr)
 		libmpq__archive_close(archive_);
 	archive_ = other.archive_;
+	other.archive_ = nullptr;
 	tmp_buf_ = std::move(other.tmp_buf_);
+	mapped_ = std::move(other.mapped_);
+	mappedFiles_ = std::move(other.mappedFiles_);
+	mappedScratch_ = std::move(other.mappedScratch_);
 	return *this;
 }
 
@@ -74,6 +206,16 @@ std::unique_ptr<std::byte[]> MpqArchive::ReadFile(std::string_view filename, std
 
 	result = std::make_unique<std::byte[]>(static_cast<size_t>(unpackedSize));
 
+	if (const MappedFileState *mappedFile = GetMappedFile(fileNumber); mappedFile != nullptr) {
+		const auto numBlocks = static_cast<uint32_t>(mappedFile->blockOffsets.size() - 1);
+		error = ReadBlocks(fileNumber, 0, numBlocks, reinterpret_cast<uint8_t *>(result.get()), static_cast<size_t>(unpackedSize));
+		CloseBlockOffsetTable(fileNumber);
+		if (error != 0)
+			return nullptr;
+		fileSize = static_cast<size_t>(unpackedSize);
+		return result;
+	}
+
 	const std::size_t blockSize = GetBlockSize(fileNumber, 0, error);
 	if (error != 0)
 		return result;
@@ -98,6 +240,10 @@ std::unique_ptr<std::byte[]> MpqArchive::ReadFile(std::string_view filename, std
 
 int32_t MpqArchive::ReadBlock(uint32_t fileNumber, uint32_t blockNumber, uint8_t *out, size_t outSize)
 {
+	if (const MappedFileState *mappedFile = GetMappedFile(fileNumber); mappedFile != nullptr
+	    && ReadMappedBlock(*mappedFile, blockNumber, out, outSize, mappedScratch_)) {
+		return 0;
+	}
 	std::vector<std::uint8_t> &tmpBuf = GetTemporaryBuffer(outSize);
 	return libmpq__block_read_with_temporary_buffer(
 	    archive_, fileNumber, blockNumber, out, static_cast<libmpq__off_t>(outSize),
@@ -105,6 +251,34 @@ int32_t MpqArchive::ReadBlock(uint32_t fileNumber, uint32_t blockNumber, uint8_t
 	    /*transferred=*/nullptr);
 }
 
+int32_t MpqArchive::ReadBlocks(uint32_t fileNumber, uint32_t firstBlock, uint32_t numBlocks, uint8_t *out, size_t outSize)
+{
+	// Which blocks still have to be read one by one, e.g. via libmpq.
+	std::vector<uint8_t> failed(numBlocks, 1);
+	const MappedFileState *mappedFile = GetMappedFile(fileNumber);
+	if (mappedFile != nullptr && numBlocks > 1 && outSize >= ParallelReadThreshold) {
+		if (!ReadMappedBlocksParallel(*mappedFile, firstBlock, numBlocks, out, failed))
+			return LIBMPQ_ERROR_READ;
+	}
+
+	size_t offset = 0;
+	for (uint32_t i = 0; i < numBlocks; ++i) {
+		int32_t error;
+		const size_t blockSize = GetBlockSize(fileNumber, firstBlock + i, error);
+		if (error != 0)
+			return error;
+		if (blockSize > outSize - offset)
+			return LIBMPQ_ERROR_READ;
+		if (failed[i] != 0) {
+			error = ReadBlock(fileNumber, firstBlock + i, out + offset, blockSize);
+			if (error != 0)
+				return error;
+		}
+		offset += blockSize;
+	}
+	return offset == outSize ? 0 : LIBMPQ_ERROR_READ;
+}
+
 std::size_t MpqArchive::GetUnpackedFileSize(uint32_t fileNumber, int32_t &error)
 {
 	libmpq__off_t unpackedSize;
@@ -119,16 +293,173 @@ uint32_t MpqArchive::GetNumBlocks(uint32_t fileNumber, int32_t &error)
 	return numBlocks;
 }
 
+const uint8_t *MpqArchive::GetBlockView(uint32_t fileNumber, uint32_t blockNumber, size_t blockSize)
+{
+	const MappedFileState *file = GetMappedFile(fileNumber);
+	if (file == nullptr || (file->flags & MpqBlockEntry::FlagEncrypted) != 0 || blockNumber + 1 >= file->blockOffsets.size())
+		return nullptr;
+	const uint32_t begin = file->blockOffsets[blockNumber];
+	if (file->blockOffsets[blockNumber + 1] - begin != blockSize)
+		return nullptr;
+	return reinterpret_cast<const uint8_t *>(mapped_->file.data()) + file->offset + begin;
+}
+
 int32_t MpqArchive::OpenBlockOffsetTable(uint32_t fileNumber, std::string_view filename)
 {
-	return libmpq__block_open_offset_with_filename_s(archive_, fileNumber, filename.data(), filename.size());
+	int32_t error = libmpq__block_open_offset_with_filename_s(archive_, fileNumber, filename.data(), filename.size());
+	if (error == 0 && mapped_ != nullptr) {
+		error = OpenMappedFile(fileNumber, filename);
+		if (error != 0)
+			CloseBlockOffsetTable(fileNumber);
+	}
+	return error;
 }
 
 int32_t MpqArchive::CloseBlockOffsetTable(uint32_t fileNumber)
 {
+	if (mapped_ != nullptr) {
+		const auto it = mappedFiles_.find(fileNumber);
+		if (it != mappedFiles_.end() && --it->second.refCount == 0)
+			mappedFiles_.erase(it);
+	}
 	return libmpq__block_close_offset(archive_, fileNumber);
 }
 
+int32_t MpqArchive::OpenMappedFile(uint32_t fileNumber, std::string_view filename)
+{
+	auto [it, inserted] = mappedFiles_.try_emplace(fileNumber);
+	MappedFileState &state = it->second;
+	++state.refCount;
+	if (!inserted)
+		return 0;
+
+	if (fileNumber >= mapped_->fileBlocks.size() || mapped_->fileBlocks[fileNumber] == MpqHashEntry::NullBlock)
+		return 0;
+	const MpqBlockEntry &block = mapped_->blockTable[mapped_->fileBlocks[fileNumber]];
+	// Single-unit files and sector checksums do not occur in Diablo MPQs, leave them to libmpq.
+	if ((block.flags & (MpqBlockEntry::FlagSingleUnit | MpqBlockEntry::FlagSectorCrc)) != 0)
+		return 0;
+	// The blocks are read straight from the mapping, so a truncated or malformed archive must not point past its end.
+	const size_t mappedSize = mapped_->file.size();
+	if (block.offset > mappedSize || block.packedSize > mappedSize - block.offset)
+		return LIBMPQ_ERROR_FORMAT;
+
+	state.flags = block.flags;
+	state.offset = block.offset;
+	state.unpackedSize = block.unpackedSize;
+	if ((block.flags & MpqBlockEntry::FlagEncrypted) != 0) {
+		state.key = CalculateMpqFileKey(filename);
+		if ((block.flags & MpqBlockEntry::FlagFixKey) != 0)
+			state.key = (state.key + block.offset) ^ block.unpackedSize;
+	}
+
+	const size_t numBlocks = (state.unpackedSize + mapped_->blockSize - 1) / mapped_->blockSize;
+	state.blockOffsets.resize(numBlocks + 1);
+	if ((block.flags & (MpqBlockEntry::CompressPkZip | MpqBlockEntry::CompressMulti)) == 0) {
+		// Stored files are served as-is, and must be as large as they claim to be.
+		if (state.unpackedSize > block.packedSize)
+			return LIBMPQ_ERROR_FORMAT;
+		for (size_t i = 0; i <= numBlocks; ++i)
+			state.blockOffsets[i] = static_cast<uint32_t>(std::min(i * mapped_->blockSize, state.unpackedSize));
+	} else {
+		const size_t tableSize = state.blockOffsets.size() * sizeof(uint32_t);
+		if (tableSize > block.packedSize)
+			return LIBMPQ_ERROR_FORMAT;
+		std::memcpy(state.blockOffsets.data(), mapped_->file.data() + block.offset, tableSize);
+		if ((block.flags & MpqBlockEntry::FlagEncrypted) != 0)
+			libmpq__decrypt_block(state.blockOffsets.data(), static_cast<uint32_t>(tableSize), state.key - 1);
+		if (state.blockOffsets[0] != tableSize)
+			return LIBMPQ_ERROR_FORMAT;
+		for (size_t i = 0; i < numBlocks; ++i) {
+			if (state.blockOffsets[i] > state.blockOffsets[i + 1])
+				return LIBMPQ_ERROR_FORMAT;
+		}
+		if (state.blockOffsets[numBlocks] > block.packedSize)
+			return LIBMPQ_ERROR_FORMAT;
+	}
+	state.usable = true;
+	return 0;
+}
+
+const MpqArchive::MappedFileState *MpqArchive::GetMappedFile(uint32_t fileNumber) const
+{
+	if (mapped_ == nullptr)
+		return nullptr;
+	const auto it = mappedFiles_.find(fileNumber);
+	if (it == mappedFiles_.end() || !it->second.usable)
+		return nullptr;
+	return &it->second;
+}
+
+bool MpqArchive::ReadMappedBlocksParallel(const MappedFileState &file, uint32_t firstBlock, uint32_t numBlocks, uint8_t *out, std::vector<uint8_t> &failed) const
+{
+	const size_t blockSize = mapped_->blockSize;
+	if (firstBlock + static_cast<size_t>(numBlocks) >= file.blockOffsets.size())
+		return false;
+
+	// Each job decompresses a contiguous run of blocks, so that it needs to allocate its scratch space only once.
+	ThreadPool &pool = GetWorkerThreadPool();
+	const unsigned numJobs = std::min(numBlocks, pool.numWorkers() + 1);
+	pool.parallelFor(numJobs, [&](unsigned job) {
+		MappedBlockScratch scratch;
+		const uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(numBlocks) * job / numJobs);
+		const uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(numBlocks) * (job + 1) / numJobs);
+		for (uint32_t i = begin; i < end; ++i) {
+			const uint32_t blockNumber = firstBlock + i;
+			const size_t unpackedSize = std::min(blockSize, file.unpackedSize - blockNumber * blockSize);
+			if (ReadMappedBlock(file, blockNumber, out + static_cast<size_t>(i) * blockSize, unpackedSize, scratch))
+				failed[i] = 0;
+		}
+	});
+	return true;
+}
+
+bool MpqArchive::ReadMappedBlock(const MappedFileState &file, uint32_t blockNumber, uint8_t *out, size_t outSize, MappedBlockScratch &scratch) const
+{
+	if (blockNumber + 1 >= file.blockOffsets.size())
+		return false;
+	const uint32_t begin = file.blockOffsets[blockNumber];
+	const size_t packedSize = file.blockOffsets[blockNumber + 1] - begin;
+	const size_t unpackedSize = std::min(mapped_->blockSize, file.unpackedSize - blockNumber * mapped_->blockSize);
+	if (outSize != unpackedSize)
+		return false;
+
+	const uint8_t *in = reinterpret_cast<const uint8_t *>(mapped_->file.data()) + file.offset + begin;
+	if ((file.flags & MpqBlockEntry::FlagEncrypted) != 0) {
+		// Decryption cannot happen in place in a read-only mapping.
+		if (scratch.decrypted.size() < packedSize)
+			scratch.decrypted.resize(packedSize);
+		std::memcpy(scratch.decrypted.data(), in, packedSize);
+		libmpq__decrypt_block(reinterpret_cast<uint32_t *>(scratch.decrypted.data()), static_cast<uint32_t>(packedSize), file.key + blockNumber);
+		in = scratch.decrypted.data();
+	}
+
+	// Blocks that do not compress are stored as-is.
+	if (packedSize == unpackedSize) {
+		std::memcpy(out, in, unpackedSize);
+		return true;
+	}
+
+	size_t implodedSize = packedSize;
+	if ((file.flags & MpqBlockEntry::CompressMulti) != 0) {
+		// The first byte is a mask of compression methods, of which we only handle PKWARE (0x08).
+		// Anything else, e.g. the ADPCM/Huffman combinations used for sounds, is left to libmpq.
+		constexpr uint8_t CompressionPkWare = 0x08;
+		if (packedSize == 0 || in[0] != CompressionPkWare)
+			return false;
+		++in;
+		--implodedSize;
+	} else if ((file.flags & MpqBlockEntry::CompressPkZip) == 0) {
+		return false;
+	}
+
+	if (scratch.explodeBuf == nullptr)
+		scratch.explodeBuf = std::make_unique<char[]>(EXP_BUFFER_SIZE);
+	ExplodeState state { in, implodedSize, out, outSize, /*overflow=*/false };
+	const unsigned int result = explode(ExplodeRead, ExplodeWrite, scratch.explodeBuf.get(), &state);
+	return result == CMP_NO_ERROR && !state.overflow && state.outSize == 0;
+}
+
 // Requires the block offset table to be open
 std::size_t MpqArchive::GetBlockSize(uint32_t fileNumber, uint32_t blockNumber, int32_t &error)
 {
@@ -144,4 +475,83 @@ bool MpqArchive::HasFile(std::string_view filename) const
 	return error == 0;
 }
 
+bool MpqArchive::ComputeTablesChecksum(uint64_t &checksum) const
+{
+	// Only archives that start at offset 0 are supported (all Diablo MPQs do).
+	FILE *file = OpenFile(path_.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+	MpqFileHeader header;
+	bool ok = std::fread(&header, sizeof(header), 1, file) == 1
+	    && SDL_SwapLE32(header.signature) == MpqFileHeader::DiabloSignature;
+
+	// 64-bit FNV-1a of the header and the raw (encrypted) tables.
+	checksum = 0xCBF29CE484222325;
+	const auto update = [&checksum](const uint8_t *data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			checksum ^= data[i];
+			checksum *= 0x100000001B3;
+		}
+	};
+	if (ok) {
+		update(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+		const std::array<std::pair<uint32_t, uint32_t>, 2> tables { {
+		    { SDL_SwapLE32(header.hashEntriesOffset), SDL_SwapLE32(header.hashEntriesCount) * static_cast<uint32_t>(sizeof(MpqHashEntry)) },
+		    { SDL_SwapLE32(header.blockEntriesOffset), SDL_SwapLE32(header.blockEntriesCount) * static_cast<uint32_t>(sizeof(MpqBlockEntry)) },
+		} };
+		std::vector<uint8_t> buf;
+		for (const auto &[offset, size] : tables) {
+			buf.resize(size);
+			ok = ok && (size == 0 || (std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0 && std::fread(buf.data(), size, 1, file) == 1));
+			if (ok)
+				update(buf.data(), size);
+		}
+	}
+	std::fclose(file);
+	return ok;
+}
+
+bool MpqArchive::ForEachFile(tl::function_ref<void(uint32_t hashA, uint32_t hashB, uint32_t fileNumber)> fn)
+{
+	std::unique_ptr<MpqHashEntry[]> ownedHashTable;
+	const MpqHashEntry *hashTable;
+	uint32_t hashEntriesCount;
+	if (mapped_ != nullptr) {
+		hashTable = mapped_->hashTable.get();
+		hashEntriesCount = mapped_->hashEntriesCount;
+	} else {
+		// libmpq does not expose its hash table, so we read it ourselves.
+		// Only archives that start at offset 0 are supported (all Diablo MPQs do).
+		FILE *file = OpenFile(path_.c_str(), "rb");
+		if (file == nullptr)
+			return false;
+		MpqFileHeader header;
+		bool ok = std::fread(&header, sizeof(header), 1, file) == 1
+		    && SDL_SwapLE32(header.signature) == MpqFileHeader::DiabloSignature;
+		hashEntriesCount = SDL_SwapLE32(header.hashEntriesCount);
+		if (ok) {
+			ownedHashTable = std::make_unique<MpqHashEntry[]>(hashEntriesCount);
+			ok = std::fseek(file, static_cast<long>(SDL_SwapLE32(header.hashEntriesOffset)), SEEK_SET) == 0
+			    && std::fread(ownedHashTable.get(), sizeof(MpqHashEntry), hashEntriesCount, file) == hashEntriesCount;
+		}
+		std::fclose(file);
+		if (!ok)
+			return false;
+		libmpq__decrypt_block(reinterpret_cast<uint32_t *>(ownedHashTable.get()), hashEntriesCount * sizeof(MpqHashEntry), LIBMPQ_HASH_TABLE_HASH_KEY);
+		hashTable = ownedHashTable.get();
+	}
+
+	for (uint32_t i = 0; i < hashEntriesCount; ++i) {
+		const MpqHashEntry &entry = hashTable[i];
+		if (entry.block == MpqHashEntry::NullBlock || entry.block == MpqHashEntry::DeletedBlock)
+			continue;
+		// Probing from the entry's own slot resolves to exactly this entry.
+		uint32_t fileNumber;
+		if (!GetFileNumber({ i, entry.hashA, entry.hashB }, fileNumber))
+			continue;
+		fn(entry.hashA, entry.hashB, fileNumber);
+	}
+	return true;
+}
+
 } // namespace devilution
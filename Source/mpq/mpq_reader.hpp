@@ -7,8 +7,11 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include <function_ref.hpp>
+
 #include "mpq/mpq_common.hpp"
 
 // Forward-declare so that we can avoid exposing libmpq.
@@ -28,8 +31,12 @@ public:
 
 	MpqArchive(MpqArchive &&other) noexcept
 	    : path_(std::move(other.path_))
+	    , id_(other.id_)
 	    , archive_(other.archive_)
 	    , tmp_buf_(std::move(other.tmp_buf_))
+	    , mapped_(std::move(other.mapped_))
+	    , mappedFiles_(std::move(other.mappedFiles_))
+	    , mappedScratch_(std::move(other.mappedScratch_))
 	{
 		other.archive_ = nullptr;
 	}
@@ -38,6 +45,12 @@ public:
 
 	~MpqArchive();
 
+	// Identifies the opened archive file. Clones share the same ID.
+	[[nodiscard]] uint32_t GetId() const
+	{
+		return id_;
+	}
+
 	// Returns false if the file does not exit.
 	bool GetFileNumber(MpqFileHash fileHash, uint32_t &fileNumber);
 
@@ -46,6 +59,21 @@ public:
 	// Returns error code.
 	int32_t ReadBlock(uint32_t fileNumber, uint32_t blockNumber, uint8_t *out, size_t outSize);
 
+	// Spans of at least this many bytes are decompressed on the worker threads by `ReadBlocks`.
+	static constexpr size_t ParallelReadThreshold = 128 * 1024;
+
+	// Reads `numBlocks` consecutive blocks starting at `firstBlock` into `out`,
+	// which must be exactly as large as these blocks unpacked.
+	// If the archive is memory-mapped and the span is at least `ParallelReadThreshold` bytes,
+	// the blocks are decompressed in parallel.
+	// Requires the block offset table to be open. Returns error code.
+	int32_t ReadBlocks(uint32_t fileNumber, uint32_t firstBlock, uint32_t numBlocks, uint8_t *out, size_t outSize);
+
+	// If the archive is memory-mapped and the block is stored as-is, returns a pointer to its data
+	// in the mapping, which stays valid for the lifetime of the archive. Returns nullptr otherwise.
+	// Requires the block offset table to be open.
+	const uint8_t *GetBlockView(uint32_t fileNumber, uint32_t blockNumber, size_t blockSize);
+
 	std::size_t GetUnpackedFileSize(uint32_t fileNumber, int32_t &error);
 
 	uint32_t GetNumBlocks(uint32_t fileNumber, int32_t &error);
@@ -59,13 +87,52 @@ public:
 
 	bool HasFile(std::string_view filename) const;
 
+	// Calls `fn(hashA, hashB, fileNumber)` for every file in the archive.
+	// Returns false if the hash table could not be read.
+	bool ForEachFile(tl::function_ref<void(uint32_t hashA, uint32_t hashB, uint32_t fileNumber)> fn);
+
+	// Computes a checksum of the archive's header, hash table and block table.
+	// Any change to the archive's files changes their positions or sizes, and thus the checksum.
+	// Returns false if the archive could not be read.
+	bool ComputeTablesChecksum(uint64_t &checksum) const;
+
 private:
-	MpqArchive(std::string path, mpq_archive_s *archive)
+	// The memory mapping and the decrypted tables, shared by all the clones of an archive.
+	struct MappedArchive;
+
+	// A file that has its block offset table open, see `OpenBlockOffsetTable`.
+	struct MappedFileState {
+		int refCount = 0;
+		// False if the file has to be read via libmpq.
+		bool usable = false;
+		uint32_t flags;
+		uint32_t key;
+		size_t offset;
+		size_t unpackedSize;
+		// Offsets of the blocks relative to `offset`, plus the end of the last block.
+		std::vector<uint32_t> blockOffsets;
+	};
+
+	// Working memory for decompressing a block of a memory-mapped archive, one per thread.
+	struct MappedBlockScratch {
+		std::vector<std::uint8_t> decrypted;
+		std::unique_ptr<char[]> explodeBuf;
+	};
+
+	MpqArchive(std::string path, uint32_t id, mpq_archive_s *archive)
 	    : path_(std::move(path))
+	    , id_(id)
 	    , archive_(archive)
 	{
 	}
 
+	void MapArchive();
+	// Returns an error if the file's blocks do not fit inside the mapping.
+	int32_t OpenMappedFile(uint32_t fileNumber, std::string_view filename);
+	[[nodiscard]] const MappedFileState *GetMappedFile(uint32_t fileNumber) const;
+	bool ReadMappedBlock(const MappedFileState &file, uint32_t blockNumber, uint8_t *out, size_t outSize, MappedBlockScratch &scratch) const;
+	bool ReadMappedBlocksParallel(const MappedFileState &file, uint32_t firstBlock, uint32_t numBlocks, uint8_t *out, std::vector<uint8_t> &failed) const;
+
 	std::vector<std::uint8_t> &GetTemporaryBuffer(std::size_t size)
 	{
 		if (tmp_buf_.size() < size)
@@ -74,8 +141,14 @@ private:
 	}
 
 	std::string path_;
+	uint32_t id_;
 	mpq_archive_s *archive_;
 	std::vector<std::uint8_t> tmp_buf_;
+
+	// Only set if built with `DEVILUTIONX_MMAP_MPQS` and the archive could be mapped.
+	std::shared_ptr<const MappedArchive> mapped_;
+	std::unordered_map<uint32_t, MappedFileState> mappedFiles_;
+	MappedBlockScratch mappedScratch_;
 };
 
 } // namespace devilution
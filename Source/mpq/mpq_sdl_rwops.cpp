@@ -2,14 +2,105 @@
 
 #include <cstdint>
 #include <cstring>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include "utils/sdl_mutex.h"
+
 namespace devilution {
 
 namespace {
 
+/**
+ * @brief A size-bounded LRU cache of decompressed blocks, shared by all the MPQ file handles.
+ *
+ * Audio decoders and SDL_image seek back to blocks they have already read,
+ * which would otherwise be decompressed again every time.
+ */
+class BlockCache {
+public:
+	// Large enough for the leading blocks of all the sounds that play at once.
+	static constexpr size_t MaxBytes = 2 * 1024 * 1024;
+
+	using Block = std::shared_ptr<uint8_t[]>;
+
+	struct Key {
+		uint32_t archiveId;
+		uint32_t fileNumber;
+		uint32_t blockNumber;
+
+		bool operator==(const Key &other) const
+		{
+			return archiveId == other.archiveId && fileNumber == other.fileNumber && blockNumber == other.blockNumber;
+		}
+	};
+
+	Block Get(const Key &key)
+	{
+		const std::lock_guard<SdlMutex> lock(mutex_);
+		const auto it = index_.find(key);
+		if (it == index_.end()) {
+			++stats_.misses;
+			return nullptr;
+		}
+		++stats_.hits;
+		entries_.splice(entries_.begin(), entries_, it->second);
+		return it->second->block;
+	}
+
+	void Put(const Key &key, Block block, size_t size)
+	{
+		const std::lock_guard<SdlMutex> lock(mutex_);
+		if (index_.find(key) != index_.end())
+			return;
+		entries_.push_front(Entry { key, std::move(block), size });
+		index_.emplace(key, entries_.begin());
+		stats_.bytes += size;
+		while (stats_.bytes > MaxBytes) {
+			const Entry &last = entries_.back();
+			stats_.bytes -= last.size;
+			index_.erase(last.key);
+			entries_.pop_back();
+		}
+	}
+
+	MpqBlockCacheStats GetStats()
+	{
+		const std::lock_guard<SdlMutex> lock(mutex_);
+		return stats_;
+	}
+
+private:
+	struct KeyHash {
+		size_t operator()(const Key &key) const
+		{
+			return std::hash<uint64_t> {}((static_cast<uint64_t>(key.archiveId) << 56) ^ (static_cast<uint64_t>(key.fileNumber) << 24) ^ key.blockNumber);
+		}
+	};
+
+	struct Entry {
+		Key key;
+		Block block;
+		size_t size;
+	};
+
+	SdlMutex mutex_;
+	// Most recently used first.
+	std::list<Entry> entries_;
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+	MpqBlockCacheStats stats_ {};
+};
+
+BlockCache &GetBlockCache()
+{
+	static BlockCache cache;
+	return cache;
+}
+
 struct Data {
 	// File information:
 	std::optional<MpqArchive> ownedArchive;
@@ -23,7 +114,10 @@ struct Data {
 	// State:
 	size_t position;
 	bool blockRead;
-	std::unique_ptr<uint8_t[]> blockData;
+	// Either `blockData` or a view into a memory-mapped archive.
+	const uint8_t *block;
+	// The current block if it was decompressed, also held by the block cache.
+	BlockCache::Block blockData;
 };
 
 Data *GetData(struct SDL_RWops *context)
@@ -100,23 +194,52 @@ static SizeType MpqFileRwRead(struct SDL_RWops *context, void *ptr, SizeType siz
 
 	auto *out = static_cast<uint8_t *>(ptr);
 
-	if (data.blockData == nullptr) {
-		data.blockData = std::unique_ptr<uint8_t[]> { new uint8_t[data.blockSize] };
-	}
-
 	uint32_t blockNumber = static_cast<uint32_t>(data.position / data.blockSize);
 	while (remainingSize > 0) {
 		if (data.position == data.size) {
 			break;
 		}
 
+		// Large reads of whole blocks bypass the block cache and are decompressed straight into the output.
+		if (data.position == static_cast<size_t>(blockNumber) * data.blockSize) {
+			const bool toEnd = remainingSize >= data.size - data.position;
+			const auto numWholeBlocks = static_cast<uint32_t>(toEnd ? data.numBlocks - blockNumber : remainingSize / data.blockSize);
+			const size_t wholeBlocksSize = toEnd ? data.size - data.position : numWholeBlocks * data.blockSize;
+			if (wholeBlocksSize >= MpqArchive::ParallelReadThreshold) {
+				const int32_t error = data.mpqArchive->ReadBlocks(data.fileNumber, blockNumber, numWholeBlocks, out, wholeBlocksSize);
+				if (error != 0) {
+					SDL_SetError("MpqFileRwRead ReadBlocks: %s", MpqArchive::ErrorMessage(error));
+					return 0;
+				}
+				out += wholeBlocksSize;
+				data.position += wholeBlocksSize;
+				remainingSize -= wholeBlocksSize;
+				blockNumber += numWholeBlocks;
+				data.blockRead = false;
+				continue;
+			}
+		}
+
 		const size_t currentBlockSize = blockNumber + 1 == data.numBlocks ? data.lastBlockSize : data.blockSize;
 
 		if (!data.blockRead) {
-			const int32_t error = data.mpqArchive->ReadBlock(data.fileNumber, blockNumber, data.blockData.get(), currentBlockSize);
-			if (error != 0) {
-				SDL_SetError("MpqFileRwRead ReadBlock: %s", MpqArchive::ErrorMessage(error));
-				return 0;
+			// Blocks stored as-is in a memory-mapped archive are copied straight from the mapping.
+			data.block = data.mpqArchive->GetBlockView(data.fileNumber, blockNumber, currentBlockSize);
+			if (data.block == nullptr) {
+				const BlockCache::Key key { data.mpqArchive->GetId(), data.fileNumber, blockNumber };
+				data.blockData = GetBlockCache().Get(key);
+				if (data.blockData == nullptr) {
+					// Cached blocks are shared, so we always decompress into a new buffer.
+					data.blockData = BlockCache::Block { new uint8_t[currentBlockSize] };
+					const int32_t error = data.mpqArchive->ReadBlock(data.fileNumber, blockNumber, data.blockData.get(), currentBlockSize);
+					if (error != 0) {
+						data.blockData = nullptr;
+						SDL_SetError("MpqFileRwRead ReadBlock: %s", MpqArchive::ErrorMessage(error));
+						return 0;
+					}
+					GetBlockCache().Put(key, data.blockData, currentBlockSize);
+				}
+				data.block = data.blockData.get();
 			}
 			data.blockRead = true;
 		}
@@ -125,12 +248,12 @@ static SizeType MpqFileRwRead(struct SDL_RWops *context, void *ptr, SizeType siz
 		const size_t remainingBlockSize = currentBlockSize - blockPosition;
 
 		if (remainingSize < remainingBlockSize) {
-			std::memcpy(out, data.blockData.get() + blockPosition, remainingSize);
+			std::memcpy(out, data.block + blockPosition, remainingSize);
 			data.position += remainingSize;
 			return maxnum;
 		}
 
-		std::memcpy(out, data.blockData.get() + blockPosition, remainingBlockSize);
+		std::memcpy(out, data.block + blockPosition, remainingBlockSize);
 		out += remainingBlockSize;
 		data.position += remainingBlockSize;
 		remainingSize -= remainingBlockSize;
@@ -154,6 +277,11 @@ static int MpqFileRwClose(struct SDL_RWops *context)
 
 } // namespace
 
+MpqBlockCacheStats GetMpqBlockCacheStats()
+{
+	return GetBlockCache().GetStats();
+}
+
 SDL_RWops *SDL_RWops_FromMpqFile(MpqArchive &mpqArchive, uint32_t fileNumber, std::string_view filename, bool threadsafe)
 {
 	auto result = std::make_unique<SDL_RWops>();
@@ -225,6 +353,7 @@ SDL_RWops *SDL_RWops_FromMpqFile(MpqArchive &mpqArchive, uint32_t fileNumber, st
 
 	data->position = 0;
 	data->blockRead = false;
+	data->block = nullptr;
 
 	SetData(result.get(), data.release());
 	return result.release();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string_view>
 
@@ -11,4 +12,14 @@ namespace devilution {
 
 SDL_RWops *SDL_RWops_FromMpqFile(MpqArchive &mpqArchive, uint32_t fileNumber, std::string_view filename, bool threadsafe);
 
+struct MpqBlockCacheStats {
+	uint64_t hits;
+	uint64_t misses;
+	// Total size of the cached blocks.
+	size_t bytes;
+};
+
+// Statistics of the decompressed block cache shared by all the MPQ file handles.
+MpqBlockCacheStats GetMpqBlockCacheStats();
+
 } // namespace devilution
@@ -1,14 +1,18 @@
 #include "mpq/mpq_writer.hpp"
 
+#include <cerrno>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 #include <libmpq/mpq.h>
 
 #include "appfat.h"
+#include "codec.h"
 #include "encrypt.h"
 #include "engine.h"
 #include "utils/endian.hpp"
@@ -59,9 +63,6 @@ constexpr uint32_t HashEntryNotFound = -1;
 constexpr uint16_t BlockSizeFactor = 3;
 constexpr uint32_t BlockSize = 512 << BlockSizeFactor; // 4096
 
-// Sometimes we can end up with smaller blocks.
-constexpr uint32_t MinBlockSize = 1024;
-
 void ByteSwapHdr(MpqFileHeader *hdr)
 {
 	hdr->signature = SDL_SwapLE32(hdr->signature);
@@ -75,14 +76,44 @@ void ByteSwapHdr(MpqFileHeader *hdr)
 	hdr->blockEntriesCount = SDL_SwapLE32(hdr->blockEntriesCount);
 }
 
-bool IsAllocatedUnusedBlock(const MpqBlockEntry *block)
+bool IsUnallocatedBlock(const MpqBlockEntry *block)
 {
-	return block->offset != 0 && block->flags == 0 && block->unpackedSize == 0;
+	return block->offset == 0 && block->packedSize == 0 && block->unpackedSize == 0 && block->flags == 0;
 }
 
-bool IsUnallocatedBlock(const MpqBlockEntry *block)
+// Compresses a file into its stored form: the table of sector offsets followed by the compressed sectors.
+std::vector<std::byte> PackFile(const std::byte *fileData, uint32_t fileSize)
 {
-	return block->offset == 0 && block->packedSize == 0 && block->unpackedSize == 0 && block->flags == 0;
+	const uint32_t numSectors = (fileSize + (BlockSize - 1)) / BlockSize;
+	const uint32_t offsetTableByteSize = sizeof(uint32_t) * (numSectors + 1);
+
+	// Sectors that do not compress are stored as is, so this is an upper bound.
+	std::vector<std::byte> packed(offsetTableByteSize + fileSize);
+
+	// First offset is the start of the first sector, last offset is the end of the last sector.
+	std::unique_ptr<uint32_t[]> offsetTable { new uint32_t[numSectors + 1] };
+
+	uint32_t destSize = offsetTableByteSize;
+	std::byte mpqBuf[BlockSize];
+	size_t curSector = 0;
+	while (true) {
+		uint32_t len = std::min<uint32_t>(fileSize, BlockSize);
+		memcpy(mpqBuf, fileData, len);
+		fileData += len;
+		len = PkwareCompress(mpqBuf, len);
+		memcpy(&packed[destSize], mpqBuf, len);
+		offsetTable[curSector++] = SDL_SwapLE32(destSize);
+		destSize += len; // compressed length
+		if (fileSize <= BlockSize)
+			break;
+
+		fileSize -= BlockSize;
+	}
+
+	offsetTable[numSectors] = SDL_SwapLE32(destSize);
+	memcpy(packed.data(), offsetTable.get(), offsetTableByteSize);
+	packed.resize(destSize);
+	return packed;
 }
 
 } // namespace
@@ -94,9 +125,7 @@ MpqWriter::MpqWriter(const char *path)
 	LogVerbose("Opening {}", path);
 	std::string error;
 	bool exists = FileExists(path);
-	const char *mode = "wb";
 	if (exists) {
-		mode = "r+b";
 		std::uintmax_t fileSize;
 		if (!GetFileSize(path, &fileSize)) {
 			error = R"(GetFileSize failed: "{}")";
@@ -105,11 +134,14 @@ MpqWriter::MpqWriter(const char *path)
 		}
 		size_ = static_cast<uint32_t>(fileSize);
 		LogVerbose("GetFileSize(\"{}\") = {}", path, size_);
-	}
-	if (!stream_.Open(path, mode)) {
-		stream_.Close();
-		error = "Failed to open file";
-		goto on_error;
+		if (!stream_.Open(path, "rb")) {
+			stream_.Close();
+			error = "Failed to open file";
+			goto on_error;
+		}
+	} else {
+		// A new archive is written even if no files are added to it.
+		modified_ = true;
 	}
 
 	name_ = path;
@@ -143,20 +175,6 @@ MpqWriter::MpqWriter(const char *path)
 			}
 			libmpq__decrypt_block(reinterpret_cast<uint32_t *>(hashTable_.get()), fhdr.hashEntriesCount * sizeof(MpqHashEntry), LIBMPQ_HASH_TABLE_HASH_KEY);
 		}
-
-#ifndef CAN_SEEKP_BEYOND_EOF
-		if (!stream_.Seekp(0, SEEK_SET))
-			goto on_error;
-
-		// Memorize stream begin, we'll need it for calculations later.
-		if (!stream_.Tellp(&streamBegin_))
-			goto on_error;
-
-		// Write garbage header and tables because some platforms cannot `Seekp` beyond EOF.
-		// The data is incorrect at this point, it will be overwritten on Close.
-		if (!exists)
-			WriteHeaderAndTables();
-#endif
 	}
 	return;
 on_error:
@@ -165,20 +183,27 @@ on_error:
 
 MpqWriter::~MpqWriter()
 {
-	if (!stream_.IsOpen())
-		return;
+	Commit();
+}
+
+bool MpqWriter::Commit()
+{
+	// Moved from or already committed.
+	if (hashTable_ == nullptr)
+		return true;
 	LogVerbose("Closing {}", name_);
 
 	bool result = true;
-	if (!(stream_.Seekp(0, SEEK_SET) && WriteHeaderAndTables()))
+	if (!modified_) {
+		stream_.Close();
+	} else if (!WriteArchive()) {
+		LogError("Failed to write {}", name_);
 		result = false;
-	stream_.Close();
-	if (result && size_ != 0) {
-		LogVerbose("ResizeFile(\"{}\", {})", name_, size_);
-		result = ResizeFile(name_.c_str(), size_);
 	}
-	if (!result)
-		LogVerbose("Closing failed {}", name_);
+	hashTable_ = nullptr;
+	blockTable_ = nullptr;
+	stagedFiles_.clear();
+	return result;
 }
 
 uint32_t MpqWriter::FetchHandle(std::string_view filename) const
@@ -219,6 +244,7 @@ bool MpqWriter::ReadMPQHeader(MpqFileHeader *hdr)
 	}
 	if (!hasHdr || !IsValidMpqHeader(hdr)) {
 		InitDefaultMpqHeader(hdr);
+		modified_ = true;
 	}
 	return true;
 }
@@ -240,73 +266,6 @@ MpqBlockEntry *MpqWriter::NewBlock(uint32_t *blockIndex)
 	app_fatal("Out of free block entries");
 }
 
-void MpqWriter::AllocBlock(uint32_t blockOffset, uint32_t blockSize)
-{
-	MpqBlockEntry *block;
-	bool expand;
-	do {
-		block = blockTable_.get();
-		expand = false;
-		for (unsigned i = BlockEntriesCount; i-- != 0; ++block) {
-			// Expand to adjacent blocks.
-			if (!IsAllocatedUnusedBlock(block))
-				continue;
-			if (block->offset + block->packedSize == blockOffset) {
-				blockOffset = block->offset;
-				blockSize += block->packedSize;
-				memset(block, 0, sizeof(MpqBlockEntry));
-				expand = true;
-				break;
-			}
-			if (blockOffset + blockSize == block->offset) {
-				blockSize += block->packedSize;
-				memset(block, 0, sizeof(MpqBlockEntry));
-				expand = true;
-				break;
-			}
-		}
-	} while (expand);
-	if (blockOffset + blockSize > size_) {
-		// Expanded beyond EOF, this should never happen.
-		app_fatal("MPQ free list error");
-	}
-	if (blockOffset + blockSize == size_) {
-		size_ = blockOffset;
-	} else {
-		block = NewBlock();
-		block->offset = blockOffset;
-		block->packedSize = blockSize;
-		block->unpackedSize = 0;
-		block->flags = 0;
-	}
-}
-
-uint32_t MpqWriter::FindFreeBlock(uint32_t size)
-{
-	uint32_t result;
-
-	MpqBlockEntry *block = blockTable_.get();
-	for (unsigned i = 0; i < BlockEntriesCount; ++i, ++block) {
-		// Find a block entry to use space from.
-		if (!IsAllocatedUnusedBlock(block) || block->packedSize < size)
-			continue;
-
-		result = block->offset;
-		block->offset += size;
-		block->packedSize -= size;
-
-		// Clear the block entry if we used its entire capacity.
-		if (block->packedSize == 0)
-			memset(block, 0, sizeof(*block));
-
-		return result;
-	}
-
-	result = size_;
-	size_ += size;
-	return result;
-}
-
 uint32_t MpqWriter::GetHashIndex(MpqFileHash fileHash) const // NOLINT(bugprone-easily-swappable-parameters)
 {
 	uint32_t i = HashEntriesCount;
@@ -326,9 +285,72 @@ uint32_t MpqWriter::GetHashIndex(MpqFileHash fileHash) const // NOLINT(bugprone-
 	return HashEntryNotFound;
 }
 
-bool MpqWriter::WriteHeaderAndTables()
+bool MpqWriter::WriteArchive()
 {
-	return WriteHeader() && WriteBlockTable() && WriteHashTable();
+	// Compress the staged files and lay out all the files after the tables, in block order,
+	// so that the archive can be written front to back.
+	std::unordered_map<uint32_t, std::vector<std::byte>> packedFiles;
+	std::unique_ptr<uint32_t[]> oldOffsets { new uint32_t[BlockEntriesCount] };
+	uint32_t offset = MpqHashEntryOffset + HashEntrySize;
+	for (uint32_t i = 0; i < BlockEntriesCount; ++i) {
+		MpqBlockEntry &block = blockTable_[i];
+		if ((block.flags & MpqBlockEntry::FlagExists) == 0) {
+			// Free space entries left by older versions, which edited archives in place.
+			memset(&block, 0, sizeof(block));
+			continue;
+		}
+		const auto staged = stagedFiles_.find(i);
+		if (staged != stagedFiles_.end()) {
+			StagedFile &file = staged->second;
+			if (file.password != nullptr)
+				codec_encode(file.data.get(), file.unencodedSize, block.unpackedSize, file.password);
+			std::vector<std::byte> &packed = packedFiles[i];
+			packed = PackFile(file.data.get(), block.unpackedSize);
+			block.packedSize = static_cast<uint32_t>(packed.size());
+		}
+		oldOffsets[i] = block.offset;
+		block.offset = offset;
+		offset += block.packedSize;
+	}
+	size_ = offset;
+
+	const std::string tempPath = name_ + ".tmp";
+	LoggedFStream out;
+	bool result = out.Open(tempPath.c_str(), "wb")
+	    && WriteHeader(out) && WriteBlockTable(out) && WriteHashTable(out);
+	std::unique_ptr<char[]> buffer;
+	uint32_t bufferSize = 0;
+	for (uint32_t i = 0; result && i < BlockEntriesCount; ++i) {
+		const MpqBlockEntry &block = blockTable_[i];
+		if ((block.flags & MpqBlockEntry::FlagExists) == 0)
+			continue;
+		const auto packed = packedFiles.find(i);
+		if (packed != packedFiles.end()) {
+			result = out.Write(reinterpret_cast<const char *>(packed->second.data()), packed->second.size());
+			continue;
+		}
+		if (block.packedSize > bufferSize) {
+			bufferSize = block.packedSize;
+			buffer.reset(new char[bufferSize]);
+		}
+		result = stream_.Seekp(oldOffsets[i], SEEK_SET)
+		    && stream_.Read(buffer.get(), block.packedSize)
+		    && out.Write(buffer.get(), block.packedSize);
+	}
+	result = result && out.Sync();
+	out.Close();
+	stream_.Close();
+
+	if (result) {
+		LogVerbose("MoveFileOverwrite(\"{}\", \"{}\")", tempPath, name_);
+		result = MoveFileOverwrite(tempPath.c_str(), name_.c_str());
+		// The rename itself only survives a crash once the directory is synced as well.
+		if (result && !SyncDirectory(std::string(Dirname(name_)).c_str()))
+			LogError("Failed to sync the directory of {}: {}", name_, std::strerror(errno));
+	}
+	if (!result)
+		RemoveFile(tempPath.c_str());
+	return result;
 }
 
 MpqBlockEntry *MpqWriter::AddFile(std::string_view filename, MpqBlockEntry *block, uint32_t blockIndex)
@@ -362,82 +384,7 @@ MpqBlockEntry *MpqWriter::AddFile(std::string_view filename, MpqBlockEntry *bloc
 	return block;
 }
 
-bool MpqWriter::WriteFileContents(const std::byte *fileData, uint32_t fileSize, MpqBlockEntry *block)
-{
-	const uint32_t numSectors = (fileSize + (BlockSize - 1)) / BlockSize;
-	const uint32_t offsetTableByteSize = sizeof(uint32_t) * (numSectors + 1);
-	block->offset = FindFreeBlock(fileSize + offsetTableByteSize);
-	// `packedSize` is reduced at the end of the function if it turns out to be smaller.
-	block->packedSize = fileSize + offsetTableByteSize;
-	block->unpackedSize = fileSize;
-	block->flags = MpqBlockEntry::FlagExists | MpqBlockEntry::CompressPkZip;
-
-	// We populate the table of sector offsets while we write the data.
-	// We can't pre-populate it because we don't know the compressed sector sizes yet.
-	// First offset is the start of the first sector, last offset is the end of the last sector.
-	std::unique_ptr<uint32_t[]> offsetTable { new uint32_t[numSectors + 1] };
-
-#ifdef CAN_SEEKP_BEYOND_EOF
-	if (!stream_.Seekp(block->offset + offsetTableByteSize, SEEK_SET))
-		return false;
-#else
-	// Ensure we do not Seekp beyond EOF by filling the missing space.
-	long stream_end;
-	if (!stream_.Seekp(0, SEEK_END) || !stream_.Tellp(&stream_end))
-		return false;
-	const std::uintmax_t cur_size = stream_end - streamBegin_;
-	if (cur_size < block->offset + offsetTableByteSize) {
-		if (cur_size < block->offset) {
-			std::unique_ptr<char[]> filler { new char[block->offset - cur_size] };
-			if (!stream_.Write(filler.get(), block->offset - cur_size))
-				return false;
-		}
-		if (!stream_.Write(reinterpret_cast<const char *>(offsetTable.get()), offsetTableByteSize))
-			return false;
-	} else {
-		if (!stream_.Seekp(block->offset + offsetTableByteSize, SEEK_SET))
-			return false;
-	}
-#endif
-
-	uint32_t destSize = offsetTableByteSize;
-	std::byte mpqBuf[BlockSize];
-	size_t curSector = 0;
-	while (true) {
-		uint32_t len = std::min<uint32_t>(fileSize, BlockSize);
-		memcpy(mpqBuf, fileData, len);
-		fileData += len;
-		len = PkwareCompress(mpqBuf, len);
-		if (!stream_.Write(reinterpret_cast<const char *>(&mpqBuf[0]), len))
-			return false;
-		offsetTable[curSector++] = SDL_SwapLE32(destSize);
-		destSize += len; // compressed length
-		if (fileSize <= BlockSize)
-			break;
-
-		fileSize -= BlockSize;
-	}
-
-	offsetTable[numSectors] = SDL_SwapLE32(destSize);
-	if (!stream_.Seekp(block->offset, SEEK_SET))
-		return false;
-	if (!stream_.Write(reinterpret_cast<const char *>(offsetTable.get()), offsetTableByteSize))
-		return false;
-	if (!stream_.Seekp(destSize - offsetTableByteSize, SEEK_CUR))
-		return false;
-
-	if (destSize < block->packedSize) {
-		const uint32_t remainingBlockSize = block->packedSize - destSize;
-		if (remainingBlockSize >= MinBlockSize) {
-			// Allocate another block if we didn't use all of this one.
-			block->packedSize = destSize;
-			AllocBlock(block->packedSize + block->offset, remainingBlockSize);
-		}
-	}
-	return true;
-}
-
-bool MpqWriter::WriteHeader()
+bool MpqWriter::WriteHeader(LoggedFStream &out)
 {
 	MpqFileHeader fhdr;
 
@@ -453,21 +400,21 @@ bool MpqWriter::WriteHeader()
 	fhdr.blockEntriesCount = BlockEntriesCount;
 	ByteSwapHdr(&fhdr);
 
-	return stream_.Write(reinterpret_cast<const char *>(&fhdr), sizeof(fhdr));
+	return out.Write(reinterpret_cast<const char *>(&fhdr), sizeof(fhdr));
 }
 
-bool MpqWriter::WriteBlockTable()
+bool MpqWriter::WriteBlockTable(LoggedFStream &out)
 {
 	libmpq__encrypt_block(reinterpret_cast<uint32_t *>(blockTable_.get()), BlockEntrySize, LIBMPQ_BLOCK_TABLE_HASH_KEY);
-	const bool success = stream_.Write(reinterpret_cast<const char *>(blockTable_.get()), BlockEntrySize);
+	const bool success = out.Write(reinterpret_cast<const char *>(blockTable_.get()), BlockEntrySize);
 	libmpq__decrypt_block(reinterpret_cast<uint32_t *>(blockTable_.get()), BlockEntrySize, LIBMPQ_BLOCK_TABLE_HASH_KEY);
 	return success;
 }
 
-bool MpqWriter::WriteHashTable()
+bool MpqWriter::WriteHashTable(LoggedFStream &out)
 {
 	libmpq__encrypt_block(reinterpret_cast<uint32_t *>(hashTable_.get()), HashEntrySize, LIBMPQ_HASH_TABLE_HASH_KEY);
-	const bool success = stream_.Write(reinterpret_cast<const char *>(hashTable_.get()), HashEntrySize);
+	const bool success = out.Write(reinterpret_cast<const char *>(hashTable_.get()), HashEntrySize);
 	libmpq__decrypt_block(reinterpret_cast<uint32_t *>(hashTable_.get()), HashEntrySize, LIBMPQ_HASH_TABLE_HASH_KEY);
 	return success;
 }
@@ -480,12 +427,10 @@ void MpqWriter::RemoveHashEntry(std::string_view filename)
 	}
 
 	MpqHashEntry *hashEntry = &hashTable_[hIdx];
-	MpqBlockEntry *block = &blockTable_[hashEntry->block];
+	stagedFiles_.erase(hashEntry->block);
+	memset(&blockTable_[hashEntry->block], 0, sizeof(MpqBlockEntry));
 	hashEntry->block = MpqHashEntry::DeletedBlock;
-	const uint32_t blockOffset = block->offset;
-	const uint32_t blockSize = block->packedSize;
-	memset(block, 0, sizeof(*block));
-	AllocBlock(blockOffset, blockSize);
+	modified_ = true;
 }
 
 void MpqWriter::RemoveHashEntries(bool (*fnGetName)(uint8_t, char *))
@@ -497,16 +442,33 @@ void MpqWriter::RemoveHashEntries(bool (*fnGetName)(uint8_t, char *))
 	}
 }
 
+uint32_t MpqWriter::AddStagedFile(std::string_view filename, size_t size)
+{
+	RemoveHashEntry(filename);
+
+	uint32_t blockIndex;
+	MpqBlockEntry *blockEntry = NewBlock(&blockIndex);
+	AddFile(filename, blockEntry, blockIndex);
+	// The offset and the packed size are only known once the archive is written.
+	blockEntry->unpackedSize = static_cast<uint32_t>(size);
+	blockEntry->flags = MpqBlockEntry::FlagExists | MpqBlockEntry::CompressPkZip;
+	modified_ = true;
+	return blockIndex;
+}
+
 bool MpqWriter::WriteFile(std::string_view filename, const std::byte *data, size_t size)
 {
-	MpqBlockEntry *blockEntry;
+	std::unique_ptr<std::byte[]> contents { new std::byte[size] };
+	memcpy(contents.get(), data, size);
+	const uint32_t blockIndex = AddStagedFile(filename, size);
+	stagedFiles_[blockIndex] = StagedFile { std::move(contents), nullptr, size };
+	return true;
+}
 
-	RemoveHashEntry(filename);
-	blockEntry = AddFile(filename, nullptr, 0);
-	if (!WriteFileContents(data, static_cast<uint32_t>(size), blockEntry)) {
-		RemoveHashEntry(filename);
-		return false;
-	}
+bool MpqWriter::WriteEncodedFile(std::string_view filename, std::unique_ptr<std::byte[]> data, size_t size, const char *password)
+{
+	const uint32_t blockIndex = AddStagedFile(filename, codec_get_encoded_len(size));
+	stagedFiles_[blockIndex] = StagedFile { std::move(data), password, size };
 	return true;
 }
 
@@ -522,6 +484,7 @@ void MpqWriter::RenameFile(std::string_view name, std::string_view newName) // N
 	MpqBlockEntry *blockEntry = &blockTable_[block];
 	hashEntry->block = MpqHashEntry::DeletedBlock;
 	AddFile(newName, blockEntry, block);
+	modified_ = true;
 }
 
 bool MpqWriter::HasFile(std::string_view name) const
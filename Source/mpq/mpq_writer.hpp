@@ -7,12 +7,23 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <string_view>
+#include <unordered_map>
 
 #include "mpq/mpq_common.hpp"
 #include "utils/logged_fstream.hpp"
 
 namespace devilution {
+
+/**
+ * @brief Edits an MPQ archive as a single transaction.
+ *
+ * All the changes are staged in memory. When the writer is committed or destroyed, the whole archive is written
+ * in one sequential pass to a temporary file, which is synced and then renamed over the original.
+ * The archive on disk is thus always either the old or the new version.
+ */
 class MpqWriter {
 public:
 	explicit MpqWriter(const char *path);
@@ -24,11 +35,27 @@ public:
 	MpqWriter &operator=(MpqWriter &&other) = default;
 	~MpqWriter();
 
+	/**
+	 * @brief Writes the archive if it was modified. The destructor does this if it was not called.
+	 *
+	 * Any other readers of the archive must be closed by then, and the writer must not be used afterwards.
+	 * @return false if the archive could not be written, in which case the archive on disk is unchanged.
+	 */
+	bool Commit();
+
 	bool HasFile(std::string_view name) const;
 
 	void RemoveHashEntry(std::string_view filename);
 	void RemoveHashEntries(bool (*fnGetName)(uint8_t, char *));
 	bool WriteFile(std::string_view filename, const std::byte *data, size_t size);
+
+	/**
+	 * @brief Adds a file that is encoded with `codec_encode` when the archive is written.
+	 *
+	 * @param data The unencoded contents, in a buffer of `codec_get_encoded_len(size)` bytes.
+	 * @param password Must outlive the writer.
+	 */
+	bool WriteEncodedFile(std::string_view filename, std::unique_ptr<std::byte[]> data, size_t size, const char *password);
 	void RenameFile(std::string_view name, std::string_view newName);
 
 private:
@@ -38,38 +65,38 @@ private:
 
 	bool ReadMPQHeader(MpqFileHeader *hdr);
 	MpqBlockEntry *AddFile(std::string_view filename, MpqBlockEntry *block, uint32_t blockIndex);
-	bool WriteFileContents(const std::byte *fileData, uint32_t fileSize, MpqBlockEntry *block);
 
 	// Returns an unused entry in the block entry table.
 	MpqBlockEntry *NewBlock(uint32_t *blockIndex = nullptr);
 
-	// Marks space at `blockOffset` of size `blockSize` as free (unused) space.
-	void AllocBlock(uint32_t blockOffset, uint32_t blockSize);
-
-	// Returns the file offset that is followed by empty space of at least the given size.
-	uint32_t FindFreeBlock(uint32_t size);
+	// Replaces `filename` with a new file of `size` bytes whose contents are staged by the caller.
+	uint32_t AddStagedFile(std::string_view filename, size_t size);
 
-	bool WriteHeaderAndTables();
-	bool WriteHeader();
-	bool WriteBlockTable();
-	bool WriteHashTable();
+	// Lays out and writes the whole archive to a temporary file, then replaces the original with it.
+	bool WriteArchive();
+	bool WriteHeader(LoggedFStream &out);
+	bool WriteBlockTable(LoggedFStream &out);
+	bool WriteHashTable(LoggedFStream &out);
 	void InitDefaultMpqHeader(MpqFileHeader *hdr);
 
+	// The archive as it was when opened, if it existed. Unchanged files are copied from it.
 	LoggedFStream stream_;
 	std::string name_;
 	uint32_t size_ {};
+	bool modified_ = false;
 	std::unique_ptr<MpqHashEntry[]> hashTable_;
 	std::unique_ptr<MpqBlockEntry[]> blockTable_;
 
-// Amiga cannot Seekp beyond EOF.
-// See https://github.com/bebbo/libnix/issues/30
-#ifndef __AMIGA__
-#define CAN_SEEKP_BEYOND_EOF
-#endif
+	struct StagedFile {
+		std::unique_ptr<std::byte[]> data;
+		// If not null, `data` is encoded with this password before it is compressed.
+		const char *password;
+		size_t unencodedSize;
+	};
 
-#ifndef CAN_SEEKP_BEYOND_EOF
-	long streamBegin_;
-#endif
+	// Uncompressed contents of the files written since the archive was opened, by block index.
+	// They are encoded and compressed when the archive is written.
+	std::unordered_map<uint32_t, StagedFile> stagedFiles_;
 };
 
 } // namespace devilution
@@ -942,6 +942,7 @@ void AddChest(Object &chest)
 void ObjSetMicro(Point position, int pn)
 {
 	dPiece[position.x][position.y] = pn;
+	InvalidateVisionCache();
 }
 
 void DoorSet(Point position, bool isLeftDoor)
@@ -4895,6 +4896,7 @@ void SyncNakrulRoom()
 	dPiece[UberRow][UberCol - 1] = 300;
 	dPiece[UberRow][UberCol - 2] = 299;
 	dPiece[UberRow][UberCol + 1] = 298;
+	InvalidateVisionCache();
 }
 
 } // namespace devilution
@@ -19,6 +19,7 @@
 #include "controls/plrctrls.h"
 #include "discord/discord.h"
 #include "engine/demomode.h"
+#include "engine/render/render_stats.hpp"
 #include "engine/sound_defs.hpp"
 #include "hwcursor.hpp"
 #include "options.h"
@@ -308,6 +309,11 @@ void OptionShowFPSChanged()
 		frameflag = false;
 }
 
+void OptionShowRenderStatsChanged()
+{
+	SetRenderStatsEnabled(*sgOptions.Graphics.showRenderStats);
+}
+
 void OptionLanguageCodeChanged()
 {
 	UnloadFonts();
@@ -993,6 +999,9 @@ GraphicsOptions::GraphicsOptions()
 #endif
     , limitFPS("FPS Limiter", OptionEntryFlags::None, N_("FPS Limiter"), N_("FPS is limited to avoid high CPU load. Limit considers refresh rate."), true)
     , showFPS("Show FPS", OptionEntryFlags::None, N_("Show FPS"), N_("Displays the FPS in the upper left corner of the screen."), false)
+    , showRenderStats("Show Render Stats", OptionEntryFlags::None, N_("Show Render Stats"), N_("Displays the time spent drawing tiles, sprites, text, the automap and blits below the FPS."), false)
+    , multithreadedRendering("Multithreaded Rendering", OptionEntryFlags::None, N_("Multithreaded Rendering"), N_("Draws the game view on all CPU cores. Helps at high resolutions."), false)
+    , incrementalRendering("Incremental Rendering", OptionEntryFlags::None, N_("Incremental Rendering"), N_("Only redraws the parts of the game view that changed. Saves power when little is moving on screen."), false)
 {
 	resolution.SetValueChangedCallback(ResizeWindow);
 	fullscreen.SetValueChangedCallback(SetFullscreenMode);
@@ -1006,6 +1015,7 @@ GraphicsOptions::GraphicsOptions()
 	vSync.SetValueChangedCallback(ReinitializeRenderer);
 #endif
 	showFPS.SetValueChangedCallback(OptionShowFPSChanged);
+	showRenderStats.SetValueChangedCallback(OptionShowRenderStatsChanged);
 }
 std::vector<OptionEntryBase *> GraphicsOptions::GetEntries()
 {
@@ -1028,6 +1038,9 @@ std::vector<OptionEntryBase *> GraphicsOptions::GetEntries()
 		&zoom,
 		&limitFPS,
 		&showFPS,
+		&showRenderStats,
+		&multithreadedRendering,
+		&incrementalRendering,
 		&colorCycling,
 		&alternateNestArt,
 #if SDL_VERSION_ATLEAST(2, 0, 0)
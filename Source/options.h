@@ -516,6 +516,12 @@ struct GraphicsOptions : OptionCategoryBase {
 	OptionEntryBoolean limitFPS;
 	/** @brief Show FPS, even without the -f command line flag. */
 	OptionEntryBoolean showFPS;
+	/** @brief Show the per-frame render counts and timings. */
+	OptionEntryBoolean showRenderStats;
+	/** @brief Draw the game view in horizontal bands on multiple threads. */
+	OptionEntryBoolean multithreadedRendering;
+	/** @brief Only redraw the parts of the game view that changed since the last frame. */
+	OptionEntryBoolean incrementalRendering;
 };
 
 struct GameplayOptions : OptionCategoryBase {
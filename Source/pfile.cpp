@@ -6,9 +6,11 @@
 #include "pfile.h"
 
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 
 #include <fmt/core.h>
 
@@ -27,9 +29,12 @@
 #include "utils/language.h"
 #include "utils/parse_int.hpp"
 #include "utils/paths.h"
+#include "utils/sdl_cond.h"
+#include "utils/sdl_mutex.h"
 #include "utils/stdcompat/filesystem.hpp"
 #include "utils/str_cat.hpp"
 #include "utils/str_split.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/utf8.hpp"
 
 #ifdef UNPACKED_SAVES
@@ -52,6 +57,54 @@ namespace {
 /** List of character names for the character selection screen. */
 char hero_names[MAX_CHARACTERS][PlayerNameLength];
 
+/** @brief Guards `PendingSaves` and `SaveFailed`. */
+SdlMutex PendingSavesMutex;
+SdlCond PendingSavesDone;
+/** @brief Number of save archives that are being written on worker threads. */
+unsigned PendingSaves;
+/** @brief Whether a save archive written on a worker thread could not be written, see `pfile_wait_for_pending_saves`. */
+bool SaveFailed;
+
+/**
+ * @brief Waits for the save archives that are being written on worker threads.
+ *
+ * Must be called before any save archive is opened, so that it is never read or written while incomplete.
+ */
+void WaitForPendingSaves()
+{
+	std::lock_guard<SdlMutex> lock(PendingSavesMutex);
+	PendingSavesDone.wait(PendingSavesMutex, []() { return PendingSaves == 0; });
+}
+
+/**
+ * @brief Moves the encoding, compression and writing of the archive to a worker thread.
+ *
+ * With `UNPACKED_SAVES`, the files have already been written and this does nothing.
+ * The worker pool always has a worker and finishes its queued tasks before shutting down.
+ */
+void WriteInBackground([[maybe_unused]] SaveWriter &&saveWriter)
+{
+#ifndef UNPACKED_SAVES
+	ThreadPool &pool = GetWorkerThreadPool();
+	{
+		std::lock_guard<SdlMutex> lock(PendingSavesMutex);
+		++PendingSaves;
+	}
+	SaveWriter *writer = new SaveWriter(std::move(saveWriter));
+	pool.submit([writer]() {
+		const bool saved = writer->Commit();
+		delete writer;
+		{
+			std::lock_guard<SdlMutex> lock(PendingSavesMutex);
+			--PendingSaves;
+			if (!saved)
+				SaveFailed = true;
+		}
+		PendingSavesDone.notify_all();
+	});
+#endif
+}
+
 std::string GetSavePath(uint32_t saveNum, std::string_view savePrefix = {})
 {
 	return StrCat(paths::PrefPath(), savePrefix,
@@ -147,23 +200,25 @@ void EncodeHero(SaveWriter &saveWriter, const PlayerPack *pack)
 	std::unique_ptr<std::byte[]> packed { new std::byte[packedLen] };
 
 	memcpy(packed.get(), pack, sizeof(*pack));
-	codec_encode(packed.get(), sizeof(*pack), packedLen, pfile_get_password());
-	saveWriter.WriteFile("hero", packed.get(), packedLen);
+	saveWriter.WriteEncodedFile("hero", std::move(packed), sizeof(*pack), pfile_get_password());
 }
 
 SaveWriter GetSaveWriter(uint32_t saveNum)
 {
+	WaitForPendingSaves();
 	return SaveWriter(GetSavePath(saveNum));
 }
 
 SaveWriter GetStashWriter()
 {
+	WaitForPendingSaves();
 	return SaveWriter(GetStashSavePath());
 }
 
 #ifndef DISABLE_DEMOMODE
 void CopySaveFile(uint32_t saveNum, std::string targetPath)
 {
+	WaitForPendingSaves();
 	const std::string savePath = GetSavePath(saveNum);
 #if defined(UNPACKED_SAVES)
 #ifdef DVL_NO_FILESYSTEM
@@ -231,6 +286,7 @@ bool ArchiveContainsGame(SaveReader &hsArchive)
 
 std::optional<SaveReader> CreateSaveReader(std::string &&path)
 {
+	WaitForPendingSaves();
 #ifdef UNPACKED_SAVES
 	if (!FileExists(path))
 		return std::nullopt;
@@ -570,6 +626,13 @@ bool SaveWriter::WriteFile(const char *filename, const std::byte *data, size_t s
 	return true;
 }
 
+bool SaveWriter::WriteEncodedFile(const char *filename, std::unique_ptr<std::byte[]> data, size_t size, const char *password)
+{
+	const size_t encodedLen = codec_get_encoded_len(size);
+	codec_encode(data.get(), size, encodedLen, password);
+	return WriteFile(filename, data.get(), encodedLen);
+}
+
 void SaveWriter::RemoveHashEntries(bool (*fnGetName)(uint8_t, char *))
 {
 	char pszFileName[MaxMpqPathSize];
@@ -616,10 +679,18 @@ const char *pfile_get_password()
 	return gbIsMultiplayer ? PASSWORD_MULTI : PASSWORD_SINGLE;
 }
 
+bool pfile_wait_for_pending_saves()
+{
+	WaitForPendingSaves();
+	std::lock_guard<SdlMutex> lock(PendingSavesMutex);
+	return !std::exchange(SaveFailed, false);
+}
+
 void pfile_write_hero(bool writeGameData)
 {
 	SaveWriter saveWriter = GetSaveWriter(gSaveNumber);
 	pfile_write_hero(saveWriter, writeGameData);
+	WriteInBackground(std::move(saveWriter));
 }
 
 #ifndef DISABLE_DEMOMODE
@@ -657,6 +728,7 @@ void sfile_write_stash()
 	SaveWriter stashWriter = GetStashWriter();
 
 	SaveStash(stashWriter);
+	WriteInBackground(std::move(stashWriter));
 
 	Stash.dirty = false;
 }
@@ -746,6 +818,7 @@ bool pfile_delete_save(_uiheroinfo *heroInfo)
 	uint32_t saveNum = heroInfo->saveNumber;
 	if (saveNum < MAX_CHARACTERS) {
 		hero_names[saveNum][0] = '\0';
+		WaitForPendingSaves();
 		RemoveFile(GetSavePath(saveNum).c_str());
 	}
 	return true;
@@ -776,6 +849,7 @@ void pfile_save_level()
 {
 	SaveWriter saveWriter = GetSaveWriter(gSaveNumber);
 	SaveLevel(saveWriter);
+	WriteInBackground(std::move(saveWriter));
 }
 
 void pfile_convert_levels()
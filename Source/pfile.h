@@ -53,6 +53,7 @@ struct SaveWriter {
 	}
 
 	bool WriteFile(const char *filename, const std::byte *data, size_t size);
+	bool WriteEncodedFile(const char *filename, std::unique_ptr<std::byte[]> data, size_t size, const char *password);
 
 	bool HasFile(const char *path)
 	{
@@ -97,6 +98,12 @@ std::optional<SaveReader> OpenSaveArchive(uint32_t saveNum);
 std::optional<SaveReader> OpenStashArchive();
 const char *pfile_get_password();
 std::unique_ptr<std::byte[]> ReadArchive(SaveReader &archive, const char *pszName, size_t *pdwLen = nullptr);
+/**
+ * @brief Waits until the saves that are written in the background are on disk.
+ *
+ * @return false if a save could not be written since the last call, the archive on disk then still has its previous contents.
+ */
+bool pfile_wait_for_pending_saves();
 void pfile_write_hero(bool writeGameData = false);
 
 #ifndef DISABLE_DEMOMODE
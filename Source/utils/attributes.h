@@ -32,6 +32,15 @@
 #define DVL_ATTRIBUTE_HOT
 #endif
 
+// Compiles a single function for the given instruction set extension,
+// e.g. `DVL_ATTRIBUTE_TARGET("avx2")`. Callers must check `GetCpuFeatures()` first.
+// MSVC does not need this: intrinsics are available regardless of `/arch`.
+#if DVL_HAVE_ATTRIBUTE(target)
+#define DVL_ATTRIBUTE_TARGET(x) __attribute__((target(x)))
+#else
+#define DVL_ATTRIBUTE_TARGET(x)
+#endif
+
 // Any global data used by tests must be marked with `DVL_API_FOR_TEST`.
 #if defined(_MSC_VER) && defined(BUILD_TESTING)
 #ifdef _DVL_EXPORTING
@@ -0,0 +1,49 @@
+#include "utils/cpu_features.hpp"
+
+#if defined(DVL_SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace devilution {
+
+namespace {
+
+CpuFeatures DetectCpuFeatures()
+{
+	CpuFeatures features;
+#if defined(DVL_SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+	__cpuid(info, 1);
+	features.sse2 = (info[3] & (1 << 26)) != 0;
+	features.ssse3 = (info[2] & (1 << 9)) != 0;
+	features.sse41 = (info[2] & (1 << 19)) != 0;
+	const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+	if (maxLeaf >= 7 && osSavesYmm) {
+		__cpuidex(info, 7, 0);
+		features.avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#elif defined(DVL_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+	__builtin_cpu_init();
+	features.sse2 = __builtin_cpu_supports("sse2") != 0;
+	features.ssse3 = __builtin_cpu_supports("ssse3") != 0;
+	features.sse41 = __builtin_cpu_supports("sse4.1") != 0;
+	features.avx2 = __builtin_cpu_supports("avx2") != 0;
+#elif defined(DVL_SIMD_NEON)
+	// Advanced SIMD is a mandatory part of AArch64.
+	features.neon = true;
+#endif
+	return features;
+}
+
+} // namespace
+
+const CpuFeatures &GetCpuFeatures()
+{
+	static const CpuFeatures Features = DetectCpuFeatures();
+	return Features;
+}
+
+} // namespace devilution
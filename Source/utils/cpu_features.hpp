@@ -0,0 +1,31 @@
+/**
+ * @file cpu_features.hpp
+ *
+ * Runtime detection of the vector instruction sets supported by the host CPU.
+ */
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DVL_SIMD_X86
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define DVL_SIMD_NEON
+#endif
+
+namespace devilution {
+
+struct CpuFeatures {
+	bool sse2 = false;
+	bool ssse3 = false;
+	bool sse41 = false;
+	bool avx2 = false;
+	bool neon = false;
+};
+
+/**
+ * @brief Returns the instruction set extensions available on this machine.
+ *
+ * Detection happens once, on first use.
+ */
+const CpuFeatures &GetCpuFeatures();
+
+} // namespace devilution
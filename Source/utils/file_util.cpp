@@ -29,9 +29,14 @@
 #ifndef DEVILUTIONX_WINDOWS_NO_WCHAR
 #include <shlwapi.h>
 #endif
+
+#ifndef NXDK
+#include <io.h>
+#endif
 #endif
 
 #if (_POSIX_C_SOURCE >= 200112L || defined(_BSD_SOURCE) || defined(__APPLE__)) && !defined(DEVILUTIONX_WINDOWS_NO_WCHAR)
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
@@ -379,6 +384,46 @@ void RenameFile(const char *from, const char *to)
 #endif
 }
 
+bool MoveFileOverwrite(const char *from, const char *to)
+{
+#ifdef _WIN32
+#ifdef DEVILUTIONX_WINDOWS_NO_WCHAR
+	// `MoveFileEx` and `ReplaceFile` are not available on Windows 9x.
+	// `to` is kept as a backup until `from` has taken its place, so that one of them is always on disk.
+	const std::string backup = std::string(to) + ".bak";
+	::DeleteFile(backup.c_str());
+	const bool hasBackup = ::MoveFile(to, backup.c_str()) != 0;
+	if (::MoveFile(from, to) == 0) {
+		if (hasBackup)
+			::MoveFile(backup.c_str(), to);
+		return false;
+	}
+	if (hasBackup)
+		::DeleteFile(backup.c_str());
+	return true;
+#else
+	const auto fromUtf16 = ToWideChar(from);
+	const auto toUtf16 = ToWideChar(to);
+	if (fromUtf16 == nullptr || toUtf16 == nullptr) {
+		LogError("UTF-8 -> UTF-16 conversion error code {}", ::GetLastError());
+		return false;
+	}
+	if (::ReplaceFileW(&toUtf16[0], &fromUtf16[0], /*lpBackupFileName=*/nullptr, REPLACEFILE_IGNORE_MERGE_ERRORS, nullptr, nullptr) != 0)
+		return true;
+	// `ReplaceFile` requires `to` to exist.
+	if (::GetLastError() != ERROR_FILE_NOT_FOUND)
+		return false;
+	return ::MoveFileExW(&fromUtf16[0], &toUtf16[0], MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#endif // _WIN32
+#elif defined(DVL_HAS_FILESYSTEM)
+	std::error_code ec;
+	std::filesystem::rename(std::filesystem::u8path(from), std::filesystem::u8path(to), ec);
+	return !ec;
+#else
+	return ::rename(from, to) == 0;
+#endif
+}
+
 void CopyFileOverwrite(const char *from, const char *to)
 {
 #ifdef _WIN32
@@ -472,4 +517,33 @@ FILE *OpenFile(const char *path, const char *mode)
 #endif
 }
 
+bool SyncFile(FILE *file)
+{
+	if (std::fflush(file) != 0)
+		return false;
+#if defined(_WIN32) && !defined(NXDK)
+	return ::FlushFileBuffers(reinterpret_cast<HANDLE>(::_get_osfhandle(::_fileno(file)))) != 0;
+#elif _POSIX_C_SOURCE >= 200112L || defined(_BSD_SOURCE) || defined(__APPLE__)
+	return ::fsync(::fileno(file)) == 0;
+#else
+	return true;
+#endif
+}
+
+bool SyncDirectory(const char *path)
+{
+#if !defined(_WIN32) && (_POSIX_C_SOURCE >= 200112L || defined(_BSD_SOURCE) || defined(__APPLE__))
+	const int fd = ::open(path, O_RDONLY);
+	if (fd == -1)
+		return false;
+	const bool ok = ::fsync(fd) == 0;
+	::close(fd);
+	return ok;
+#else
+	// Renames on Windows are made durable by `MOVEFILE_WRITE_THROUGH`.
+	(void)path;
+	return true;
+#endif
+}
+
 } // namespace devilution
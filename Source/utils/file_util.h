@@ -38,10 +38,30 @@ bool CreateDir(const char *path);
 void RecursivelyCreateDir(const char *path);
 bool ResizeFile(const char *path, std::uintmax_t size);
 void RenameFile(const char *from, const char *to);
+
+/**
+ * @brief Renames `from` to `to`, replacing `to` if it exists.
+ *
+ * Where the platform supports it, `to` is replaced atomically.
+ * On Windows 9x, `to` is renamed to `to.bak` first, which is left behind if `from` can't be moved.
+ * On Windows, this fails while another handle to `to` is open, so all the readers of `to` must be closed first.
+ */
+bool MoveFileOverwrite(const char *from, const char *to);
+
 void CopyFileOverwrite(const char *from, const char *to);
 void RemoveFile(const char *path);
 FILE *OpenFile(const char *path, const char *mode);
 
+/** @brief Flushes the buffered writes to `file` and waits for the OS to write them to the disk. */
+bool SyncFile(FILE *file);
+
+/**
+ * @brief Waits for the OS to write the entries of the directory at `path` to the disk.
+ *
+ * Makes files created or renamed in it durable. Does nothing where this is not needed or supported.
+ */
+bool SyncDirectory(const char *path);
+
 #if defined(_WIN32) && !defined(DEVILUTIONX_WINDOWS_NO_WCHAR)
 std::unique_ptr<wchar_t[]> ToWideChar(std::string_view path);
 #endif
@@ -57,6 +57,11 @@ public:
 		    "fread(out, {})", size);
 	}
 
+	bool Sync()
+	{
+		return CheckError(SyncFile(s_), "SyncFile()");
+	}
+
 private:
 	static const char *DirToString(int dir);
 
@@ -0,0 +1,110 @@
+#include "utils/mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#ifdef DEVILUTIONX_MMAP_MPQS
+#ifdef _WIN32
+#include <memory>
+
+// Suppress definitions of `min` and `max` macros by <windows.h>:
+#define NOMINMAX 1
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include "utils/file_util.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace devilution {
+
+std::optional<MappedFile> MappedFile::Open(const char *path)
+{
+#ifdef DEVILUTIONX_MMAP_MPQS
+#ifdef _WIN32
+#ifdef DEVILUTIONX_WINDOWS_NO_WCHAR
+	HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#else
+	const std::unique_ptr<wchar_t[]> pathUtf16 = ToWideChar(path);
+	if (pathUtf16 == nullptr)
+		return std::nullopt;
+	HANDLE file = ::CreateFileW(pathUtf16.get(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+	if (file == INVALID_HANDLE_VALUE)
+		return std::nullopt;
+	LARGE_INTEGER fileSize;
+	if (::GetFileSizeEx(file, &fileSize) == 0 || fileSize.QuadPart == 0
+	    || static_cast<unsigned long long>(fileSize.QuadPart) > SIZE_MAX) {
+		::CloseHandle(file);
+		return std::nullopt;
+	}
+	HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	::CloseHandle(file);
+	if (mapping == nullptr)
+		return std::nullopt;
+	const void *data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	// The view keeps the mapping alive.
+	::CloseHandle(mapping);
+	if (data == nullptr)
+		return std::nullopt;
+	return MappedFile { static_cast<const std::byte *>(data), static_cast<size_t>(fileSize.QuadPart) };
+#else
+	const int fd = ::open(path, O_RDONLY);
+	if (fd == -1)
+		return std::nullopt;
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || st.st_size <= 0
+	    || static_cast<unsigned long long>(st.st_size) > SIZE_MAX) {
+		::close(fd);
+		return std::nullopt;
+	}
+	const size_t size = static_cast<size_t>(st.st_size);
+	void *data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+	// The mapping stays valid after the file descriptor is closed.
+	::close(fd);
+	if (data == MAP_FAILED)
+		return std::nullopt;
+	return MappedFile { static_cast<const std::byte *>(data), size };
+#endif
+#else
+	return std::nullopt;
+#endif
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+	Unmap();
+	data_ = other.data_;
+	size_ = other.size_;
+	other.data_ = nullptr;
+	other.size_ = 0;
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	Unmap();
+}
+
+void MappedFile::Unmap()
+{
+	if (data_ == nullptr)
+		return;
+#ifdef DEVILUTIONX_MMAP_MPQS
+#ifdef _WIN32
+	::UnmapViewOfFile(data_);
+#else
+	::munmap(const_cast<std::byte *>(data_), size_);
+#endif
+#endif
+	data_ = nullptr;
+	size_ = 0;
+}
+
+} // namespace devilution
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+namespace devilution {
+
+/**
+ * @brief A read-only memory mapping of a whole file.
+ *
+ * Only available when built with `DEVILUTIONX_MMAP_MPQS`, `Open` always fails otherwise.
+ */
+class MappedFile {
+public:
+	// Returns nullopt if the file does not exist or cannot be mapped.
+	static std::optional<MappedFile> Open(const char *path);
+
+	MappedFile(MappedFile &&other) noexcept
+	    : data_(other.data_)
+	    , size_(other.size_)
+	{
+		other.data_ = nullptr;
+		other.size_ = 0;
+	}
+
+	MappedFile &operator=(MappedFile &&other) noexcept;
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	~MappedFile();
+
+	[[nodiscard]] const std::byte *data() const
+	{
+		return data_;
+	}
+
+	[[nodiscard]] size_t size() const
+	{
+		return size_;
+	}
+
+private:
+	MappedFile(const std::byte *data, size_t size)
+	    : data_(data)
+	    , size_(size)
+	{
+	}
+
+	void Unmap();
+
+	const std::byte *data_;
+	size_t size_;
+};
+
+} // namespace devilution
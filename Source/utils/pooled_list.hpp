@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace devilution {
+
+/**
+ * @brief A list of objects stored in pooled, contiguous chunks.
+ *
+ * A drop-in replacement for the subset of `std::list` used by the game:
+ * elements keep their address until they are removed, iteration follows insertion order, and elements that are
+ * added while iterating are visited by the same loop. Removed slots are reused, so adding elements does not
+ * allocate once the pool has grown to the peak element count.
+ *
+ * @tparam T element type, must be default constructible and move assignable.
+ * @tparam ChunkSize number of elements allocated at a time.
+ */
+template <class T, size_t ChunkSize = 128>
+class PooledList {
+	template <bool IsConst>
+	class Iterator {
+		using List = std::conditional_t<IsConst, const PooledList, PooledList>;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<IsConst, const T *, T *>;
+		using reference = std::conditional_t<IsConst, const T &, T &>;
+
+		Iterator() = default;
+
+		Iterator(List *list, size_t pos)
+		    : list_(list)
+		    , pos_(pos)
+		{
+		}
+
+		reference operator*() const
+		{
+			return list_->slot(list_->order_[pos_]);
+		}
+
+		pointer operator->() const
+		{
+			return &**this;
+		}
+
+		Iterator &operator++()
+		{
+			++pos_;
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator copy = *this;
+			++pos_;
+			return copy;
+		}
+
+		bool operator==(const Iterator &other) const
+		{
+			// `end()` is checked against the current size so that a loop also visits the elements added while it runs.
+			if (atEnd() || other.atEnd())
+				return atEnd() && other.atEnd();
+			return pos_ == other.pos_;
+		}
+
+		bool operator!=(const Iterator &other) const
+		{
+			return !(*this == other);
+		}
+
+	private:
+		[[nodiscard]] bool atEnd() const
+		{
+			return list_ == nullptr || pos_ >= list_->order_.size();
+		}
+
+		List *list_ = nullptr;
+		size_t pos_ = 0;
+	};
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	PooledList() = default;
+	PooledList(const PooledList &) = delete;
+	PooledList &operator=(const PooledList &) = delete;
+
+	[[nodiscard]] iterator begin()
+	{
+		return { this, 0 };
+	}
+
+	[[nodiscard]] iterator end()
+	{
+		return { this, std::numeric_limits<size_t>::max() };
+	}
+
+	[[nodiscard]] const_iterator begin() const
+	{
+		return { this, 0 };
+	}
+
+	[[nodiscard]] const_iterator end() const
+	{
+		return { this, std::numeric_limits<size_t>::max() };
+	}
+
+	[[nodiscard]] const_iterator cbegin() const
+	{
+		return begin();
+	}
+
+	[[nodiscard]] const_iterator cend() const
+	{
+		return end();
+	}
+
+	[[nodiscard]] size_t size() const
+	{
+		return order_.size();
+	}
+
+	[[nodiscard]] bool empty() const
+	{
+		return order_.empty();
+	}
+
+	[[nodiscard]] size_t max_size() const // NOLINT(readability-identifier-naming)
+	{
+		return std::numeric_limits<uint32_t>::max();
+	}
+
+	[[nodiscard]] T &back()
+	{
+		return slot(order_.back());
+	}
+
+	[[nodiscard]] const T &back() const
+	{
+		return slot(order_.back());
+	}
+
+	template <typename... Args>
+	T &emplace_back(Args &&...args) // NOLINT(readability-identifier-naming)
+	{
+		const uint32_t index = acquireSlot();
+		T &element = slot(index);
+		element = T(std::forward<Args>(args)...);
+		order_.push_back(index);
+		return element;
+	}
+
+	void push_back(const T &element) // NOLINT(readability-identifier-naming)
+	{
+		emplace_back(element);
+	}
+
+	/**
+	 * @brief Removes the elements matching the predicate, keeping the order of the others.
+	 * @return The number of removed elements.
+	 */
+	template <typename Predicate>
+	size_t remove_if(Predicate pred) // NOLINT(readability-identifier-naming)
+	{
+		size_t kept = 0;
+		for (const uint32_t index : order_) {
+			if (pred(slot(index)))
+				freeSlots_.push_back(index);
+			else
+				order_[kept++] = index;
+		}
+		const size_t removed = order_.size() - kept;
+		order_.resize(kept);
+		return removed;
+	}
+
+	/** @brief Removes all the elements, the pool keeps its memory for reuse. */
+	void clear()
+	{
+		order_.clear();
+		freeSlots_.clear();
+		usedSlots_ = 0;
+	}
+
+private:
+	T &slot(uint32_t index)
+	{
+		return chunks_[index / ChunkSize][index % ChunkSize];
+	}
+
+	const T &slot(uint32_t index) const
+	{
+		return chunks_[index / ChunkSize][index % ChunkSize];
+	}
+
+	uint32_t acquireSlot()
+	{
+		if (!freeSlots_.empty()) {
+			const uint32_t index = freeSlots_.back();
+			freeSlots_.pop_back();
+			return index;
+		}
+		if (usedSlots_ == chunks_.size() * ChunkSize)
+			chunks_.push_back(std::make_unique<T[]>(ChunkSize));
+		return usedSlots_++;
+	}
+
+	/** Storage, never moved so that elements keep their address. */
+	std::vector<std::unique_ptr<T[]>> chunks_;
+	/** Slots of the elements in insertion order. */
+	std::vector<uint32_t> order_;
+	/** Removed slots, reused before new ones are taken from the chunks. */
+	std::vector<uint32_t> freeSlots_;
+	/** Number of slots that have been handed out from the chunks. */
+	uint32_t usedSlots_ = 0;
+};
+
+} // namespace devilution
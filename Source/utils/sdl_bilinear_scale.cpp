@@ -1,8 +1,20 @@
 #include "utils/sdl_bilinear_scale.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 
+#include "utils/attributes.h"
+#include "utils/cpu_features.hpp"
+#include "utils/thread_pool.hpp"
+
+#if defined(DVL_SIMD_X86)
+#include <immintrin.h>
+#elif defined(DVL_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
 // Performs bilinear scaling using fixed-width integer math.
 
 namespace devilution {
@@ -62,94 +74,294 @@ uint8_t MixColorsWithAlpha(uint8_t first, uint8_t firstAlpha,
 	return ToInt((secondWithAlpha - firstWithAlpha) * ((ratio + (mixedAlpha - 1)) / mixedAlpha)) + (firstWithAlpha + (mixedAlpha - 1)) / mixedAlpha;
 }
 
+/**
+ * @brief Offsets of the source pixels that each destination pixel is mixed from.
+ *
+ * @param inclusiveLimit Whether the offset may advance up to `srcSize` rather than `srcSize - 1`.
+ */
+std::unique_ptr<unsigned[]> CreateSourceOffsets(const int *mixFactors, unsigned dstSize, unsigned srcSize, bool inclusiveLimit)
+{
+	std::unique_ptr<unsigned[]> result { new unsigned[dstSize] };
+	unsigned offset = 0;
+	unsigned position = 0;
+	for (unsigned i = 0; i < dstSize; ++i) {
+		result[i] = offset;
+		const auto step = static_cast<unsigned>(ToInt(mixFactors[i + 1]));
+		position += step;
+		if (inclusiveLimit ? position <= srcSize : position < srcSize)
+			offset += step;
+	}
+	return result;
+}
+
+struct BilinearScale32Row {
+	const uint8_t *src;
+	int srcPitch;
+	uint8_t *dst;
+	unsigned width;
+	const int *mixXs;
+	const unsigned *srcXs;
+	int mixY;
+};
+
+/** @brief Mixes the 4 source pixels that surround a destination pixel. */
+DVL_ALWAYS_INLINE void ScalePixel(const uint8_t *const s[4], int mixX, int mixY, uint8_t *dstPixels)
+{
+	const uint8_t alpha0 = MixColors(s[0][3], s[1][3], mixX);
+	const uint8_t alpha1 = MixColors(s[2][3], s[3][3], mixX);
+	const uint8_t finalAlpha = MixColors(alpha0, alpha1, mixY);
+
+	if (finalAlpha == 0) {
+		dstPixels[0] = 0;
+		dstPixels[1] = 0;
+		dstPixels[2] = 0;
+		dstPixels[3] = 0;
+	} else if (finalAlpha == 255) {
+		for (unsigned channel = 0; channel < 3; ++channel) {
+			dstPixels[channel] = MixColors(
+			    MixColors(s[0][channel], s[1][channel], mixX),
+			    MixColors(s[2][channel], s[3][channel], mixX),
+			    mixY);
+		}
+		dstPixels[3] = 255;
+	} else {
+		for (unsigned channel = 0; channel < 3; ++channel) {
+			dstPixels[channel] = MixColorsWithAlpha(
+			    MixColorsWithAlpha(s[0][channel], s[0][3], s[1][channel], s[1][3], alpha0, mixX),
+			    alpha0,
+			    MixColorsWithAlpha(s[2][channel], s[2][3], s[3][channel], s[3][3], alpha1, mixX),
+			    alpha1,
+			    finalAlpha,
+			    mixY);
+		}
+		dstPixels[3] = finalAlpha;
+	}
+}
+
+DVL_ALWAYS_INLINE void GetSourcePixels(const BilinearScale32Row &row, unsigned x, const uint8_t *s[4])
+{
+	s[0] = row.src + 4 * row.srcXs[x]; // Self
+	s[1] = s[0] + 4;                   // Right
+	s[2] = s[0] + row.srcPitch;        // Bottom
+	s[3] = s[2] + 4;                   // Bottom right
+}
+
+void ScaleRowScalar(const BilinearScale32Row &row)
+{
+	uint8_t *dstPixels = row.dst;
+	for (unsigned x = 0; x < row.width; ++x, dstPixels += 4) {
+		const uint8_t *s[4];
+		GetSourcePixels(row, x, s);
+		ScalePixel(s, Frac(row.mixXs[x]), row.mixY, dstPixels);
+	}
+}
+
+// Where the result is opaque, mixing is the same computation for all 4 channels, so it is done with one 32-bit lane per channel.
+// This gives exactly the same result as `MixColors`: the products fit in 32 bits and the shifts are arithmetic.
+// The alpha lane is the final alpha, the other pixels are redone with `ScalePixel`.
+
+DVL_ALWAYS_INLINE bool IsOpaque(uint32_t mixedPixel)
+{
+	uint8_t bytes[4];
+	std::memcpy(bytes, &mixedPixel, sizeof(bytes));
+	return bytes[3] == 255;
+}
+
+#if defined(DVL_SIMD_X86)
+
+DVL_ATTRIBUTE_TARGET("sse4.1") __m128i LoadPixelSse41(const uint8_t *pixel)
+{
+	int32_t value;
+	std::memcpy(&value, pixel, sizeof(value));
+	return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(value));
+}
+
+DVL_ATTRIBUTE_TARGET("sse4.1") __m128i MixSse41(__m128i first, __m128i second, __m128i ratio)
+{
+	return _mm_add_epi32(_mm_srai_epi32(_mm_mullo_epi32(_mm_sub_epi32(second, first), ratio), 16), first);
+}
+
+DVL_ATTRIBUTE_TARGET("sse4.1") void ScaleRowSse41(const BilinearScale32Row &row)
+{
+	const __m128i mixY = _mm_set1_epi32(row.mixY);
+	uint8_t *dstPixels = row.dst;
+	for (unsigned x = 0; x < row.width; ++x, dstPixels += 4) {
+		const uint8_t *s[4];
+		GetSourcePixels(row, x, s);
+		const int mixX = Frac(row.mixXs[x]);
+		const __m128i ratio = _mm_set1_epi32(mixX);
+		const __m128i top = MixSse41(LoadPixelSse41(s[0]), LoadPixelSse41(s[1]), ratio);
+		const __m128i bottom = MixSse41(LoadPixelSse41(s[2]), LoadPixelSse41(s[3]), ratio);
+		const __m128i mixed = MixSse41(top, bottom, mixY);
+		const __m128i words = _mm_packus_epi32(mixed, mixed);
+		const auto value = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(words, words)));
+		if (!IsOpaque(value)) {
+			ScalePixel(s, mixX, row.mixY, dstPixels);
+			continue;
+		}
+		std::memcpy(dstPixels, &value, sizeof(value));
+	}
+}
+
+// There is no byte gather, so the blended pixels are gathered as the 32-bit words that contain them.
+DVL_ATTRIBUTE_TARGET("avx2") __m256i LookupBlendAvx2(const uint8_t *table, __m256i first, __m256i second)
+{
+	const __m256i index = _mm256_or_si256(_mm256_slli_epi32(first, 8), second);
+	const __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int *>(table), _mm256_srli_epi32(index, 2), 4);
+	const __m256i shift = _mm256_slli_epi32(_mm256_and_si256(index, _mm256_set1_epi32(3)), 3);
+	return _mm256_and_si256(_mm256_srlv_epi32(words, shift), _mm256_set1_epi32(0xFF));
+}
+
+/** @brief Replaces the transparent pixels of `pixels` with `replacement`. */
+DVL_ATTRIBUTE_TARGET("avx2") __m256i ReplaceTransparentAvx2(__m256i pixels, __m256i replacement, __m256i transparent)
+{
+	return _mm256_blendv_epi8(pixels, replacement, _mm256_cmpeq_epi32(pixels, transparent));
+}
+
+/** @return The number of pixels of the row that were done. */
+DVL_ATTRIBUTE_TARGET("avx2") unsigned DownscaleByHalf8RowAvx2(const uint8_t *srcPixels, int srcPitch, const uint8_t *table, uint8_t *dstPixels, unsigned width, uint8_t transparentIndex)
+{
+	const __m256i transparent = _mm256_set1_epi32(transparentIndex);
+	const __m128i lowBytes = _mm_set1_epi16(0xFF);
+	unsigned x = 0;
+	for (; x + 8 <= width; x += 8, srcPixels += 16, dstPixels += 8) {
+		const __m128i topRow = _mm_loadu_si128(reinterpret_cast<const __m128i *>(srcPixels));
+		const __m128i bottomRow = _mm_loadu_si128(reinterpret_cast<const __m128i *>(srcPixels + srcPitch));
+		__m256i quad0 = _mm256_cvtepu16_epi32(_mm_and_si128(topRow, lowBytes));
+		__m256i quad1 = _mm256_cvtepu16_epi32(_mm_srli_epi16(topRow, 8));
+		__m256i quad2 = _mm256_cvtepu16_epi32(_mm_and_si128(bottomRow, lowBytes));
+		__m256i quad3 = _mm256_cvtepu16_epi32(_mm_srli_epi16(bottomRow, 8));
+		quad0 = ReplaceTransparentAvx2(quad0, quad1, transparent);
+		quad1 = ReplaceTransparentAvx2(quad1, quad0, transparent);
+		quad2 = ReplaceTransparentAvx2(quad2, quad3, transparent);
+		quad3 = ReplaceTransparentAvx2(quad3, quad2, transparent);
+		__m256i top = LookupBlendAvx2(table, quad0, quad1);
+		__m256i bottom = LookupBlendAvx2(table, quad2, quad3);
+		top = ReplaceTransparentAvx2(top, bottom, transparent);
+		bottom = ReplaceTransparentAvx2(bottom, top, transparent);
+		const __m256i result = LookupBlendAvx2(table, top, bottom);
+		// Narrow 8 32-bit values to 8 bytes, undoing the per-lane interleaving of the pack.
+		const __m128i words = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(result, result), 0x08));
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(dstPixels), _mm_packus_epi16(words, words));
+	}
+	return x;
+}
+
+#elif defined(DVL_SIMD_NEON)
+
+int32x4_t LoadPixelNeon(const uint8_t *pixel)
+{
+	uint32_t value;
+	std::memcpy(&value, pixel, sizeof(value));
+	return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(value))))));
+}
+
+int32x4_t MixNeon(int32x4_t first, int32x4_t second, int32x4_t ratio)
+{
+	return vaddq_s32(vshrq_n_s32(vmulq_s32(vsubq_s32(second, first), ratio), 16), first);
+}
+
+void ScaleRowNeon(const BilinearScale32Row &row)
+{
+	const int32x4_t mixY = vdupq_n_s32(row.mixY);
+	uint8_t *dstPixels = row.dst;
+	for (unsigned x = 0; x < row.width; ++x, dstPixels += 4) {
+		const uint8_t *s[4];
+		GetSourcePixels(row, x, s);
+		const int mixX = Frac(row.mixXs[x]);
+		const int32x4_t ratio = vdupq_n_s32(mixX);
+		const int32x4_t top = MixNeon(LoadPixelNeon(s[0]), LoadPixelNeon(s[1]), ratio);
+		const int32x4_t bottom = MixNeon(LoadPixelNeon(s[2]), LoadPixelNeon(s[3]), ratio);
+		const uint16x4_t mixed = vmovn_u32(vreinterpretq_u32_s32(MixNeon(top, bottom, mixY)));
+		const uint32_t value = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(mixed, mixed))), 0);
+		if (!IsOpaque(value)) {
+			ScalePixel(s, mixX, row.mixY, dstPixels);
+			continue;
+		}
+		std::memcpy(dstPixels, &value, sizeof(value));
+	}
+}
+
+#endif
+
+using ScaleRowFn = void (*)(const BilinearScale32Row &row);
+
+ScaleRowFn SelectScaleRow()
+{
+	[[maybe_unused]] const CpuFeatures &features = GetCpuFeatures();
+#if defined(DVL_SIMD_X86)
+	if (features.sse41)
+		return &ScaleRowSse41;
+#elif defined(DVL_SIMD_NEON)
+	if (features.neon)
+		return &ScaleRowNeon;
+#endif
+	return &ScaleRowScalar;
+}
+
+/** @brief Below this many destination pixels, handing out the rows to the worker threads costs more than it saves. */
+constexpr unsigned MinPixelsForThreads = 256 * 256;
+
+/** @brief Rows per job of the multithreaded variant. */
+constexpr unsigned RowsPerJob = 16;
+
 } // namespace
 
 void BilinearScale32(SDL_Surface *src, SDL_Surface *dst)
 {
-	const std::unique_ptr<int[]> mixXs = CreateMixFactors(src->w, dst->w);
-	const std::unique_ptr<int[]> mixYs = CreateMixFactors(src->h, dst->h);
-
-	const unsigned dgap = dst->pitch - dst->w * 4;
-
-	auto *srcPixels = static_cast<uint8_t *>(src->pixels);
-	auto *dstPixels = static_cast<uint8_t *>(dst->pixels);
-
-	int *curMixY = &mixYs[0];
-	unsigned srcY = 0;
-	for (unsigned y = 0; y < static_cast<unsigned>(dst->h); ++y) {
-		uint8_t *s[4] = {
-			srcPixels,                 // Self
-			srcPixels + 4,             // Right
-			srcPixels + src->pitch,    // Bottom
-			srcPixels + src->pitch + 4 // Bottom right
-		};
-
-		int *curMixX = &mixXs[0];
-		unsigned srcX = 0;
-		for (unsigned x = 0; x < static_cast<unsigned>(dst->w); ++x) {
-			const int mixX = Frac(*curMixX);
-			const int mixY = Frac(*curMixY);
-
-			const uint8_t alpha0 = MixColors(s[0][3], s[1][3], mixX);
-			const uint8_t alpha1 = MixColors(s[2][3], s[3][3], mixX);
-			const uint8_t finalAlpha = MixColors(alpha0, alpha1, mixY);
-
-			if (finalAlpha == 0) {
-				dstPixels[0] = 0;
-				dstPixels[1] = 0;
-				dstPixels[2] = 0;
-				dstPixels[3] = 0;
-			} else if (finalAlpha == 255) {
-				for (unsigned channel = 0; channel < 3; ++channel) {
-					dstPixels[channel] = MixColors(
-					    MixColors(s[0][channel], s[1][channel], mixX),
-					    MixColors(s[2][channel], s[3][channel], mixX),
-					    mixY);
-				}
-				dstPixels[3] = 255;
-			} else {
-				for (unsigned channel = 0; channel < 3; ++channel) {
-					dstPixels[channel] = MixColorsWithAlpha(
-					    MixColorsWithAlpha(s[0][channel], s[0][3], s[1][channel], s[1][3], alpha0, mixX),
-					    alpha0,
-					    MixColorsWithAlpha(s[2][channel], s[2][3], s[3][channel], s[3][3], alpha1, mixX),
-					    alpha1,
-					    finalAlpha,
-					    mixY);
-				}
-				dstPixels[3] = finalAlpha;
-			}
-
-			++curMixX;
-			if (*curMixX > 0) {
-				unsigned step = ToInt(*curMixX);
-				srcX += step;
-				if (srcX <= static_cast<unsigned>(src->w)) {
-					step *= 4;
-					for (auto &v : s) {
-						v += step;
-					}
-				}
-			}
-
-			dstPixels += 4;
-		}
+	const auto dstWidth = static_cast<unsigned>(dst->w);
+	const auto dstHeight = static_cast<unsigned>(dst->h);
+	const std::unique_ptr<int[]> mixXs = CreateMixFactors(src->w, dstWidth);
+	const std::unique_ptr<int[]> mixYs = CreateMixFactors(src->h, dstHeight);
+	const std::unique_ptr<unsigned[]> srcXs = CreateSourceOffsets(mixXs.get(), dstWidth, src->w, /*inclusiveLimit=*/true);
+	const std::unique_ptr<unsigned[]> srcYs = CreateSourceOffsets(mixYs.get(), dstHeight, src->h, /*inclusiveLimit=*/false);
 
-		++curMixY;
-		if (*curMixY > 0) {
-			const unsigned step = ToInt(*curMixY);
-			srcY += step;
-			if (srcY < static_cast<unsigned>(src->h)) {
-				srcPixels += step * src->pitch;
-			}
+	const ScaleRowFn scaleRow = SelectScaleRow();
+	const auto scaleRows = [&](unsigned begin, unsigned end) {
+		for (unsigned y = begin; y < end; ++y) {
+			scaleRow(BilinearScale32Row {
+			    static_cast<const uint8_t *>(src->pixels) + static_cast<size_t>(srcYs[y] * src->pitch),
+			    src->pitch,
+			    static_cast<uint8_t *>(dst->pixels) + static_cast<size_t>(y * dst->pitch),
+			    dstWidth,
+			    mixXs.get(),
+			    srcXs.get(),
+			    Frac(mixYs[y]),
+			});
 		}
+	};
 
-		dstPixels += dgap;
+	if (dstWidth * dstHeight < MinPixelsForThreads) {
+		scaleRows(0, dstHeight);
+		return;
+	}
+	GetWorkerThreadPool().parallelFor((dstHeight + RowsPerJob - 1) / RowsPerJob, [&](unsigned job) {
+		scaleRows(job * RowsPerJob, std::min(dstHeight, (job + 1) * RowsPerJob));
+	});
+}
+
+void IntegerScale32(const SDL_Surface *src, SDL_Surface *dst)
+{
+	const auto scaleX = static_cast<unsigned>(dst->w / src->w);
+	const auto scaleY = static_cast<unsigned>(dst->h / src->h);
+	const auto srcWidth = static_cast<unsigned>(src->w);
+	for (unsigned y = 0, h = static_cast<unsigned>(src->h); y < h; ++y) {
+		const auto *srcPixels = reinterpret_cast<const uint32_t *>(static_cast<const uint8_t *>(src->pixels) + static_cast<size_t>(y * src->pitch));
+		auto *const dstRow = static_cast<uint8_t *>(dst->pixels) + static_cast<size_t>(y * scaleY * dst->pitch);
+		auto *dstPixels = reinterpret_cast<uint32_t *>(dstRow);
+		for (unsigned x = 0; x < srcWidth; ++x, dstPixels += scaleX)
+			std::fill_n(dstPixels, scaleX, srcPixels[x]);
+		// The other rows of the block are copies of the first one.
+		for (unsigned i = 1; i < scaleY; ++i)
+			std::memcpy(dstRow + static_cast<size_t>(i * dst->pitch), dstRow, static_cast<size_t>(srcWidth * scaleX * 4));
 	}
 }
 
 void BilinearDownscaleByHalf8(const SDL_Surface *src, const Uint8 paletteBlendingTable[256][256], SDL_Surface *dst, uint8_t transparentIndex)
 {
+#if defined(DVL_SIMD_X86)
+	const bool useAvx2 = GetCpuFeatures().avx2;
+#endif
 	const auto *const srcPixelsBegin = static_cast<const uint8_t *>(src->pixels)
 	    + static_cast<size_t>(src->clip_rect.y * src->pitch + src->clip_rect.x);
 	auto *const dstPixelsBegin = static_cast<uint8_t *>(dst->pixels)
@@ -157,7 +369,16 @@ void BilinearDownscaleByHalf8(const SDL_Surface *src, const Uint8 paletteBlendin
 	for (unsigned y = 0, h = static_cast<unsigned>(dst->clip_rect.h); y < h; ++y) {
 		const uint8_t *srcPixels = srcPixelsBegin + static_cast<size_t>(2 * y * src->pitch);
 		uint8_t *dstPixels = dstPixelsBegin + static_cast<size_t>(y * dst->pitch);
-		for (unsigned x = 0, w = static_cast<unsigned>(dst->clip_rect.w); x < w; ++x) {
+		unsigned x = 0;
+		const auto w = static_cast<unsigned>(dst->clip_rect.w);
+#if defined(DVL_SIMD_X86)
+		if (useAvx2) {
+			x = DownscaleByHalf8RowAvx2(srcPixels, src->pitch, &paletteBlendingTable[0][0], dstPixels, w, transparentIndex);
+			srcPixels += 2 * x;
+			dstPixels += x;
+		}
+#endif
+		for (; x < w; ++x) {
 			uint8_t quad[] = {
 				srcPixels[0],
 				srcPixels[1],
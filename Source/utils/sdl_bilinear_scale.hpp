@@ -15,9 +15,17 @@ namespace devilution {
 /**
  * @brief Bilinear 32-bit scaling.
  * Requires `src` and `dst` to have the same pixel format (ARGB8888 or RGBA8888).
+ *
+ * Large surfaces are scaled on the worker threads.
  */
 void BilinearScale32(SDL_Surface *src, SDL_Surface *dst);
 
+/**
+ * @brief Nearest neighbour 32-bit scaling by a whole factor.
+ * Requires the size of `dst` to be a multiple of the size of `src`, and the same pixel format.
+ */
+void IntegerScale32(const SDL_Surface *src, SDL_Surface *dst);
+
 /**
  * @brief Streamlined bilinear downscaling using blended transparency table.
  * Requires `src` and `dst` to have the same pixel format (INDEX8).
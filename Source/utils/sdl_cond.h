@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SDL_mutex.h>
+
+#include "appfat.h"
+#include "utils/sdl_mutex.h"
+
+namespace devilution {
+
+/*
+ * RAII wrapper for SDL_cond, to be used together with SdlMutex.
+ */
+class SdlCond final {
+public:
+	SdlCond()
+	    : cond_(SDL_CreateCond())
+	{
+		if (cond_ == nullptr)
+			ErrSdl();
+	}
+
+	~SdlCond()
+	{
+		SDL_DestroyCond(cond_);
+	}
+
+	SdlCond(const SdlCond &) = delete;
+	SdlCond(SdlCond &&) = delete;
+	SdlCond &operator=(const SdlCond &) = delete;
+	SdlCond &operator=(SdlCond &&) = delete;
+
+	/** @brief Atomically unlocks `mutex` and waits for a signal. `mutex` must be locked by the caller. */
+	void wait(SdlMutex &mutex) noexcept // NOLINT(readability-identifier-naming)
+	{
+		if (SDL_CondWait(cond_, mutex.get()) == -1)
+			ErrSdl();
+	}
+
+	template <typename Predicate>
+	void wait(SdlMutex &mutex, Predicate predicate) // NOLINT(readability-identifier-naming)
+	{
+		while (!predicate())
+			wait(mutex);
+	}
+
+	void notify_one() noexcept // NOLINT(readability-identifier-naming)
+	{
+		if (SDL_CondSignal(cond_) == -1)
+			ErrSdl();
+	}
+
+	void notify_all() noexcept // NOLINT(readability-identifier-naming)
+	{
+		if (SDL_CondBroadcast(cond_) == -1)
+			ErrSdl();
+	}
+
+private:
+	SDL_cond *cond_;
+};
+
+} // namespace devilution
@@ -0,0 +1,146 @@
+#include "utils/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <SDL.h>
+
+namespace devilution {
+
+namespace {
+
+std::optional<ThreadPool> WorkerThreadPool;
+
+unsigned DefaultNumWorkers()
+{
+#ifndef USE_SDL1
+	const int numCpus = SDL_GetCPUCount();
+	if (numCpus > 2)
+		return static_cast<unsigned>(numCpus - 1);
+#endif
+	// Keep a worker around even on single core machines so that background tasks can make progress.
+	return 1;
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned numWorkers)
+{
+	workers_.reserve(numWorkers);
+	for (unsigned i = 0; i < numWorkers; ++i)
+		workers_.emplace_back(WorkerMain, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<SdlMutex> lock(mutex_);
+		stopping_ = true;
+	}
+	taskAvailable_.notify_all();
+	for (SdlThread &worker : workers_)
+		worker.join();
+}
+
+int SDLCALL ThreadPool::WorkerMain(void *pool)
+{
+	static_cast<ThreadPool *>(pool)->runWorker();
+	return 0;
+}
+
+void ThreadPool::runWorker()
+{
+	while (true) {
+		std::function<void()> task;
+		{
+			std::lock_guard<SdlMutex> lock(mutex_);
+			taskAvailable_.wait(mutex_, [this]() { return stopping_ || !tasks_.empty(); });
+			if (tasks_.empty())
+				return;
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+		task();
+	}
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+	{
+		std::lock_guard<SdlMutex> lock(mutex_);
+		tasks_.emplace_back(std::move(task));
+	}
+	taskAvailable_.notify_one();
+}
+
+void ThreadPool::parallelFor(unsigned count, tl::function_ref<void(unsigned)> job)
+{
+	if (count == 0)
+		return;
+	const unsigned numHelpers = std::min(count - 1, numWorkers());
+	if (numHelpers == 0) {
+		for (unsigned i = 0; i < count; ++i)
+			job(i);
+		return;
+	}
+
+	// Helpers may only get to run after all the jobs are done (e.g. when the workers are busy with other tasks),
+	// so the shared state must outlive this call. `job` is only ever called before `numDone` reaches `count`.
+	struct Jobs {
+		tl::function_ref<void(unsigned)> job;
+		unsigned count;
+		std::atomic<unsigned> next { 0 };
+		unsigned numDone = 0;
+
+		Jobs(tl::function_ref<void(unsigned)> job, unsigned count)
+		    : job(job)
+		    , count(count)
+		{
+		}
+	};
+	auto jobs = std::make_shared<Jobs>(job, count);
+
+	const auto runJobs = [this, jobs]() {
+		unsigned numFinished = 0;
+		for (unsigned i = jobs->next++; i < jobs->count; i = jobs->next++) {
+			jobs->job(i);
+			++numFinished;
+		}
+		if (numFinished == 0)
+			return;
+		std::lock_guard<SdlMutex> lock(mutex_);
+		jobs->numDone += numFinished;
+		if (jobs->numDone == jobs->count)
+			jobsDone_.notify_all();
+	};
+
+	{
+		std::lock_guard<SdlMutex> lock(mutex_);
+		for (unsigned i = 0; i < numHelpers; ++i)
+			tasks_.emplace_back(runJobs);
+	}
+	taskAvailable_.notify_all();
+
+	runJobs();
+
+	std::lock_guard<SdlMutex> lock(mutex_);
+	jobsDone_.wait(mutex_, [&jobs]() { return jobs->numDone == jobs->count; });
+}
+
+ThreadPool &GetWorkerThreadPool()
+{
+	if (!WorkerThreadPool)
+		WorkerThreadPool.emplace(DefaultNumWorkers());
+	return *WorkerThreadPool;
+}
+
+void ShutDownWorkerThreadPool()
+{
+	WorkerThreadPool = std::nullopt;
+}
+
+} // namespace devilution
@@ -0,0 +1,67 @@
+/**
+ * @file thread_pool.hpp
+ *
+ * A small pool of worker threads for CPU-bound jobs.
+ */
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include <function_ref.hpp>
+
+#include "utils/sdl_cond.h"
+#include "utils/sdl_mutex.h"
+#include "utils/sdl_thread.h"
+
+namespace devilution {
+
+class ThreadPool final {
+public:
+	explicit ThreadPool(unsigned numWorkers);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	[[nodiscard]] unsigned numWorkers() const
+	{
+		return static_cast<unsigned>(workers_.size());
+	}
+
+	/** @brief Queues a task to be run on one of the workers. */
+	void submit(std::function<void()> task);
+
+	/**
+	 * @brief Calls `job(i)` for every `i` in `[0, count)` and waits for all of them to finish.
+	 *
+	 * The calling thread takes part in the work, so this makes progress even when all workers are busy.
+	 * Jobs are not started in any particular order.
+	 */
+	void parallelFor(unsigned count, tl::function_ref<void(unsigned)> job);
+
+private:
+	static int SDLCALL WorkerMain(void *pool);
+	void runWorker();
+
+	SdlMutex mutex_;
+	SdlCond taskAvailable_;
+	SdlCond jobsDone_;
+	std::deque<std::function<void()>> tasks_;
+	bool stopping_ = false;
+	std::vector<SdlThread> workers_;
+};
+
+/**
+ * @brief Returns the pool shared by the engine, starting it on first use.
+ *
+ * The pool has one worker less than there are CPU cores, because the main thread takes part in `parallelFor`.
+ */
+ThreadPool &GetWorkerThreadPool();
+
+/** @brief Stops the shared pool's workers. Must be called before `SDL_Quit`. */
+void ShutDownWorkerThreadPool();
+
+} // namespace devilution
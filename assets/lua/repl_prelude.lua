@@ -1,6 +1,7 @@
 events = require('devilutionx.events')
 log = require('devilutionx.log')
 audio = require('devilutionx.audio')
+assets = require('devilutionx.assets')
 render = require('devilutionx.render')
 message = require('devilutionx.message')
 if _DEBUG then dev = require('devilutionx.dev') end
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "engine/palette.h"
+#include "engine/render/blit_simd.hpp"
+
+namespace devilution {
+namespace {
+
+/** @brief Enough pixels for the table lookups to be spread all over the lookup tables. */
+constexpr size_t NumPixels = 1 << 16;
+
+std::vector<uint8_t> MakeRandomPixels(uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::vector<uint8_t> pixels(NumPixels);
+	for (uint8_t &pixel : pixels)
+		pixel = static_cast<uint8_t>(rng());
+	return pixels;
+}
+
+void InitTransparencyLookup()
+{
+	std::mt19937 rng(0);
+	for (unsigned i = 0; i < 256; ++i) {
+		paletteTransparencyLookup[i][i] = static_cast<uint8_t>(i);
+		for (unsigned j = 0; j < i; ++j)
+			paletteTransparencyLookup[i][j] = paletteTransparencyLookup[j][i] = static_cast<uint8_t>(rng());
+	}
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+	UpdatePackedTransparencyLookup();
+#endif
+}
+
+void BM_FillBlended(benchmark::State &state, BlitFillBlendedFn fn)
+{
+	const auto lineLength = static_cast<unsigned>(state.range(0));
+	std::vector<uint8_t> dst = MakeRandomPixels(1);
+	uint8_t color = 0;
+	for (auto _ : state) {
+		for (size_t i = 0; i + lineLength <= dst.size(); i += lineLength)
+			fn(&dst[i], lineLength, color++);
+		benchmark::DoNotOptimize(dst.data());
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(NumPixels / lineLength * lineLength));
+}
+
+void BM_PixelsBlended(benchmark::State &state, BlitPixelsBlendedFn fn)
+{
+	const auto lineLength = static_cast<unsigned>(state.range(0));
+	std::vector<uint8_t> dst = MakeRandomPixels(1);
+	const std::vector<uint8_t> src = MakeRandomPixels(2);
+	for (auto _ : state) {
+		for (size_t i = 0; i + lineLength <= dst.size(); i += lineLength)
+			fn(&dst[i], &src[i], lineLength);
+		benchmark::DoNotOptimize(dst.data());
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(NumPixels / lineLength * lineLength));
+}
+
+// Line lengths of a level tile, of sprites, and of a dialog backdrop.
+void ApplyLineLengths(benchmark::internal::Benchmark *benchmark)
+{
+	benchmark->Arg(32)->Arg(64)->Arg(128)->Arg(640);
+}
+
+} // namespace
+} // namespace devilution
+
+int main(int argc, char **argv)
+{
+	using namespace devilution;
+	InitTransparencyLookup();
+	for (const BlitKernelVariant<BlitFillBlendedFn> &variant : GetBlitFillBlendedVariants()) {
+		benchmark::RegisterBenchmark((std::string("BlitFillBlended/") + variant.name).c_str(), BM_FillBlended, variant.fn)->Apply(ApplyLineLengths);
+	}
+	for (const BlitKernelVariant<BlitPixelsBlendedFn> &variant : GetBlitPixelsBlendedVariants()) {
+		benchmark::RegisterBenchmark((std::string("BlitPixelsBlended/") + variant.name).c_str(), BM_PixelsBlended, variant.fn)->Apply(ApplyLineLengths);
+	}
+	benchmark::Initialize(&argc, argv);
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
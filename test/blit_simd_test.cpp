@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+
+#include "engine/palette.h"
+#include "engine/render/blit_impl.hpp"
+#include "engine/render/blit_simd.hpp"
+
+namespace devilution {
+namespace {
+
+std::array<uint8_t, 256> MakeColorMap()
+{
+	std::array<uint8_t, 256> colorMap;
+	for (size_t i = 0; i < colorMap.size(); ++i)
+		colorMap[i] = static_cast<uint8_t>(255 - ((i * 7) & 0xFF));
+	return colorMap;
+}
+
+TEST(BlitSimdTest, PixelsWithMapMatchesScalar)
+{
+	const std::array<uint8_t, 256> colorMap = MakeColorMap();
+	std::array<uint8_t, 96> src;
+	for (size_t i = 0; i < src.size(); ++i)
+		src[i] = static_cast<uint8_t>(i * 37 + 11);
+
+	for (unsigned length = 1; length <= src.size(); ++length) {
+		std::array<uint8_t, 96> expected {};
+		std::array<uint8_t, 96> actual {};
+		BlitPixelsWithMap(expected.data(), src.data(), length, colorMap.data());
+		BlitPixelsWithMapFast(actual.data(), src.data(), length, colorMap.data());
+		EXPECT_EQ(actual, expected) << "length=" << length;
+	}
+}
+
+TEST(BlitSimdTest, PixelsWithMapCoversEveryIndex)
+{
+	const std::array<uint8_t, 256> colorMap = MakeColorMap();
+	std::array<uint8_t, 256> src;
+	for (size_t i = 0; i < src.size(); ++i)
+		src[i] = static_cast<uint8_t>(i);
+
+	std::array<uint8_t, 256> actual {};
+	BlitPixelsWithMapKernel(actual.data(), src.data(), static_cast<unsigned>(src.size()), colorMap.data());
+	EXPECT_EQ(actual, colorMap);
+}
+
+void InitTransparencyLookup()
+{
+	for (unsigned i = 0; i < 256; ++i) {
+		for (unsigned j = 0; j <= i; ++j)
+			paletteTransparencyLookup[i][j] = paletteTransparencyLookup[j][i] = static_cast<uint8_t>((i * 31 + j * 31 + i * j) >> 2);
+	}
+#if DEVILUTIONX_PALETTE_TRANSPARENCY_PACKED_LUT
+	UpdatePackedTransparencyLookup();
+#endif
+}
+
+TEST(BlitSimdTest, PackedTransparencyIndexCoversHalfTheTable)
+{
+	std::array<bool, PackedTransparencyLookupSize> used {};
+	for (unsigned i = 0; i < 256; ++i) {
+		for (unsigned j = 0; j < 256; ++j) {
+			const unsigned index = GetPackedTransparencyIndex(static_cast<uint8_t>(i), static_cast<uint8_t>(j));
+			ASSERT_LT(index, PackedTransparencyLookupSize);
+			EXPECT_EQ(index, GetPackedTransparencyIndex(static_cast<uint8_t>(j), static_cast<uint8_t>(i)));
+			used[index] = true;
+		}
+	}
+	for (unsigned index = 0; index < PackedTransparencyLookupSize; ++index)
+		EXPECT_TRUE(used[index]) << "index=" << index;
+}
+
+TEST(BlitSimdTest, FillBlendedVariantsMatchScalar)
+{
+	InitTransparencyLookup();
+	std::array<uint8_t, 96> initial;
+	for (size_t i = 0; i < initial.size(); ++i)
+		initial[i] = static_cast<uint8_t>(i * 53 + 7);
+
+	for (const BlitKernelVariant<BlitFillBlendedFn> &variant : GetBlitFillBlendedVariants()) {
+		for (unsigned length = 1; length <= initial.size(); ++length) {
+			const auto color = static_cast<uint8_t>(length * 3);
+			std::array<uint8_t, 96> expected = initial;
+			std::array<uint8_t, 96> actual = initial;
+			BlitFillBlended(expected.data(), length, color);
+			variant.fn(actual.data(), length, color);
+			EXPECT_EQ(actual, expected) << variant.name << " length=" << length;
+		}
+	}
+}
+
+TEST(BlitSimdTest, PixelsBlendedVariantsMatchScalar)
+{
+	InitTransparencyLookup();
+	std::array<uint8_t, 96> initial;
+	std::array<uint8_t, 96> src;
+	for (size_t i = 0; i < initial.size(); ++i) {
+		initial[i] = static_cast<uint8_t>(i * 53 + 7);
+		src[i] = static_cast<uint8_t>(255 - i * 11);
+	}
+
+	for (const BlitKernelVariant<BlitPixelsBlendedFn> &variant : GetBlitPixelsBlendedVariants()) {
+		for (unsigned length = 1; length <= initial.size(); ++length) {
+			std::array<uint8_t, 96> expected = initial;
+			std::array<uint8_t, 96> actual = initial;
+			BlitPixelsBlended(expected.data(), src.data(), length);
+			variant.fn(actual.data(), src.data(), length);
+			EXPECT_EQ(actual, expected) << variant.name << " length=" << length;
+		}
+	}
+}
+
+TEST(BlitSimdTest, PixelsBlendedVariantsCoverEveryPair)
+{
+	InitTransparencyLookup();
+	std::array<uint8_t, 256> dst;
+	std::array<uint8_t, 256> src;
+	for (const BlitKernelVariant<BlitPixelsBlendedFn> &variant : GetBlitPixelsBlendedVariants()) {
+		for (unsigned i = 0; i < 256; ++i) {
+			for (unsigned j = 0; j < 256; ++j) {
+				dst[j] = static_cast<uint8_t>(i);
+				src[j] = static_cast<uint8_t>(j);
+			}
+			variant.fn(dst.data(), src.data(), static_cast<unsigned>(dst.size()));
+			for (unsigned j = 0; j < 256; ++j)
+				ASSERT_EQ(dst[j], paletteTransparencyLookup[i][j]) << variant.name << " i=" << i << " j=" << j;
+		}
+	}
+}
+
+} // namespace
+} // namespace devilution
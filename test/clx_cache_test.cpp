@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "diablo.h"
+#include "engine/assets.hpp"
+#include "engine/clx_cache.hpp"
+#include "init.h"
+#include "mpq/mpq_reader.hpp"
+#include "mpq/mpq_writer.hpp"
+#include "utils/file_util.h"
+#include "utils/paths.h"
+
+#ifdef DEVILUTIONX_CLX_CACHE
+namespace devilution {
+namespace {
+
+constexpr std::string_view SpritePath = "monsters\\test\\test.cl2";
+constexpr uint32_t Width = 96;
+const std::string ArchivesPath = "clx_cache_test_archives" DIRECTORY_SEPARATOR_STR;
+
+std::optional<MpqArchive> WriteArchive(const std::string &name, std::string_view contents)
+{
+	const std::string path = ArchivesPath + name;
+	if (FileExists(path))
+		RemoveFile(path.c_str());
+	{
+		MpqWriter writer { path };
+		writer.WriteFile(SpritePath, reinterpret_cast<const std::byte *>(contents.data()), contents.size());
+	}
+	int32_t error;
+	return MpqArchive::Open(path.c_str(), error);
+}
+
+std::vector<uint8_t> Load(uint16_t &numLists)
+{
+	size_t size = 0;
+	const std::unique_ptr<uint8_t[]> data = LoadCachedClx(SpritePath, Width, size, numLists);
+	if (data == nullptr)
+		return {};
+	return { data.get(), data.get() + size };
+}
+
+class ClxCacheTest : public ::testing::Test {
+public:
+	void SetUp() override
+	{
+		RecursivelyCreateDir(ArchivesPath.c_str());
+		paths::SetPrefPath("clx_cache_test");
+		std::filesystem::remove_all(paths::PrefPath() + ClxCacheDirectory);
+
+		diabdat_mpq = WriteArchive("diabdat.mpq", "diablo");
+		hellfire_mpq = WriteArchive("hellfire.mpq", "hellfire");
+		ASSERT_TRUE(diabdat_mpq && hellfire_mpq);
+		RebuildAssetIndex();
+		gbIsHellfire = false;
+	}
+
+	void TearDown() override
+	{
+		diabdat_mpq = std::nullopt;
+		hellfire_mpq = std::nullopt;
+		ClearAssetIndex();
+		gbIsHellfire = false;
+	}
+};
+
+TEST_F(ClxCacheTest, EntriesAreKeptPerArchive)
+{
+	const std::vector<uint8_t> diabloClx { 1, 2, 3, 4 };
+	const std::vector<uint8_t> hellfireClx { 5, 6, 7, 8, 9 };
+	uint16_t numLists = 0;
+
+	// Both archives have the sprite, Hellfire games read it from hellfire.mpq.
+	const uint64_t diabloSource = GetMpqAssetSource(SpritePath);
+	gbIsHellfire = true;
+	const uint64_t hellfireSource = GetMpqAssetSource(SpritePath);
+	gbIsHellfire = false;
+	ASSERT_NE(diabloSource, 0);
+	ASSERT_NE(hellfireSource, 0);
+	ASSERT_NE(diabloSource, hellfireSource);
+
+	StoreCachedClx(SpritePath, Width, diabloClx.data(), diabloClx.size(), 1);
+	EXPECT_EQ(Load(numLists), diabloClx);
+	EXPECT_EQ(numLists, 1);
+
+	// The conversion of diabdat.mpq's sprite must not be served to Hellfire games.
+	gbIsHellfire = true;
+	EXPECT_FALSE(HasCachedClx(SpritePath, Width));
+	EXPECT_TRUE(Load(numLists).empty());
+
+	StoreCachedClx(SpritePath, Width, hellfireClx.data(), hellfireClx.size(), 2);
+	EXPECT_EQ(Load(numLists), hellfireClx);
+	EXPECT_EQ(numLists, 2);
+
+	gbIsHellfire = false;
+	EXPECT_EQ(Load(numLists), diabloClx);
+	EXPECT_EQ(numLists, 1);
+}
+
+TEST_F(ClxCacheTest, EntriesAreStaleOnceTheArchiveChanges)
+{
+	const std::vector<uint8_t> clx { 1, 2, 3, 4 };
+	uint16_t numLists = 0;
+	StoreCachedClx(SpritePath, Width, clx.data(), clx.size(), 1);
+	ASSERT_EQ(Load(numLists), clx);
+
+	diabdat_mpq = std::nullopt;
+	diabdat_mpq = WriteArchive("diabdat.mpq", "another diablo");
+	ASSERT_TRUE(diabdat_mpq);
+	RebuildAssetIndex();
+	EXPECT_TRUE(HasCachedClx(SpritePath, Width));
+	EXPECT_TRUE(Load(numLists).empty());
+}
+
+} // namespace
+} // namespace devilution
+#endif
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "engine/clx_sprite.hpp"
+#include "engine/render/clx_render.hpp"
+#include "engine/render/clx_spans.hpp"
+#include "engine/surface.hpp"
+#include "utils/clx_encode.hpp"
+#include "utils/endian.hpp"
+
+namespace devilution {
+namespace {
+
+constexpr uint16_t SpriteWidth = 45;
+constexpr uint16_t SpriteHeight = 30;
+
+/**
+ * @brief Builds a CLX list with a single sprite made of transparent, fill and pixels runs.
+ *
+ * Transparent runs are merged across lines, as in the game's CL2 files.
+ */
+std::vector<uint8_t> MakeClxList()
+{
+	std::vector<uint8_t> pixelData;
+	unsigned transparentRun = 0;
+	for (unsigned y = 0; y < SpriteHeight; ++y) {
+		unsigned x = 0;
+		while (x < SpriteWidth) {
+			const unsigned seed = (x * 7 + y * 13) % 5;
+			const unsigned length = std::min(SpriteWidth - x, 1 + (x * 11 + y * 5) % 23);
+			if (seed < 2) {
+				transparentRun += length;
+			} else {
+				AppendClxTransparentRun(transparentRun, pixelData);
+				transparentRun = 0;
+				if (seed == 2) {
+					AppendClxFillRun(static_cast<uint8_t>(y * 3 + x), length, pixelData);
+				} else {
+					std::array<uint8_t, SpriteWidth> pixels;
+					for (unsigned i = 0; i < length; ++i)
+						pixels[i] = static_cast<uint8_t>(x + i + y * 17);
+					AppendClxPixelsRun(pixels.data(), length, pixelData);
+				}
+			}
+			x += length;
+		}
+	}
+	AppendClxTransparentRun(transparentRun, pixelData);
+
+	constexpr size_t ListHeaderSize = 12;
+	constexpr size_t FrameHeaderSize = 10;
+	std::vector<uint8_t> clx(ListHeaderSize + FrameHeaderSize + pixelData.size());
+	WriteLE32(&clx[0], 1);
+	WriteLE32(&clx[4], ListHeaderSize);
+	WriteLE32(&clx[8], static_cast<uint32_t>(clx.size()));
+	WriteLE16(&clx[ListHeaderSize], FrameHeaderSize);
+	WriteLE16(&clx[ListHeaderSize + 2], SpriteWidth);
+	WriteLE16(&clx[ListHeaderSize + 4], SpriteHeight);
+	WriteLE32(&clx[ListHeaderSize + 6], 0);
+	std::memcpy(&clx[ListHeaderSize + FrameHeaderSize], pixelData.data(), pixelData.size());
+	return clx;
+}
+
+std::vector<uint8_t> Render(ClxSprite sprite, Point position, const uint8_t *trn)
+{
+	OwnedSurface out { 64, 48 };
+	std::memset(out.begin(), 0xFF, static_cast<size_t>(out.pitch()) * out.h());
+	if (trn != nullptr) {
+		ClxDrawTRN(out, position, sprite, trn);
+	} else {
+		ClxDraw(out, position, sprite);
+	}
+	std::vector<uint8_t> pixels;
+	for (int y = 0; y < out.h(); ++y)
+		pixels.insert(pixels.end(), out.at(0, y), out.at(out.w(), y));
+	return pixels;
+}
+
+TEST(ClxRenderTest, SpanTableIsLinked)
+{
+	const std::vector<uint8_t> clx = MakeClxList();
+	EXPECT_EQ(ClxSpriteList { clx.data() }[0].spanTable(), nullptr);
+
+	const std::unique_ptr<uint8_t[]> compiled = CopyClxWithSpanTables(clx.data(), clx.size());
+	const ClxSprite sprite = ClxSpriteList { compiled.get() }[0];
+	ASSERT_NE(sprite.spanTable(), nullptr);
+	EXPECT_EQ(sprite.spanTable(), &compiled[GetClxSpanTablesOffset(clx.size())]);
+	EXPECT_EQ(ClxSpriteList { compiled.get() }.clone()[0].spanTable(), nullptr);
+}
+
+TEST(ClxRenderTest, SpansCoverOpaquePixels)
+{
+	const std::vector<uint8_t> clx = MakeClxList();
+	const std::unique_ptr<uint8_t[]> compiled = CopyClxWithSpanTables(clx.data(), clx.size());
+	const ClxSprite sprite = ClxSpriteList { compiled.get() }[0];
+	const ClxSpanTable spans { sprite.spanTable(), sprite.height() };
+	for (unsigned line = 0; line < SpriteHeight; ++line) {
+		unsigned prevEnd = 0;
+		for (const ClxSpan *span = spans.lineBegin(line); span != spans.lineEnd(line); ++span) {
+			EXPECT_GE(span->x, prevEnd) << "line=" << line;
+			EXPECT_LE(span->x + span->length, SpriteWidth) << "line=" << line;
+			EXPECT_GT(span->length, 0) << "line=" << line;
+			prevEnd = span->x + span->length;
+		}
+	}
+}
+
+TEST(ClxRenderTest, SpanTableRendersSameAsCommands)
+{
+	const std::vector<uint8_t> clx = MakeClxList();
+	const std::unique_ptr<uint8_t[]> compiled = CopyClxWithSpanTables(clx.data(), clx.size());
+	const ClxSprite commands = ClxSpriteList { clx.data() }[0];
+	const ClxSprite spans = ClxSpriteList { compiled.get() }[0];
+	std::array<uint8_t, 256> trn;
+	for (size_t i = 0; i < trn.size(); ++i)
+		trn[i] = static_cast<uint8_t>(i ^ 0x5A);
+
+	// Covers every combination of clipping on each side.
+	for (const int x : { -50, -20, -1, 0, 10, 19, 30, 63 }) {
+		for (const int y : { -1, 0, 10, 29, 35, 47, 48, 60, 77, 78 }) {
+			const Point position { x, y };
+			EXPECT_EQ(Render(spans, position, nullptr), Render(commands, position, nullptr)) << "x=" << x << " y=" << y;
+			EXPECT_EQ(Render(spans, position, trn.data()), Render(commands, position, trn.data())) << "x=" << x << " y=" << y;
+		}
+	}
+}
+
+} // namespace
+} // namespace devilution
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 #include "codec.h"
 
 using namespace devilution;
@@ -13,3 +17,90 @@ TEST(Codec, codec_get_encoded_len_eq)
 {
 	EXPECT_EQ(codec_get_encoded_len(128), 136);
 }
+
+namespace {
+
+constexpr char Password[] = "szqnlsk1";
+
+std::vector<std::byte> Encode(size_t size)
+{
+	std::vector<std::byte> data(codec_get_encoded_len(size));
+	for (size_t i = 0; i < size; ++i)
+		data[i] = static_cast<std::byte>(i * 7 + 3);
+	codec_encode(data.data(), size, data.size(), Password);
+	return data;
+}
+
+/** @brief Decodes the data with `CodecDecoder` the way the save reader does, returns 0 if it is invalid. */
+size_t DecodeChunked(std::vector<std::byte> &data)
+{
+	if (data.size() < CodecSignatureSize)
+		return 0;
+	const std::byte *signature = data.data() + data.size() - CodecSignatureSize;
+	const size_t decodedSize = CodecDecoder::DecodedSize(data.size(), signature);
+	CodecDecoder decoder(Password);
+	for (size_t offset = 0; offset + CodecChunkSize <= data.size() - CodecSignatureSize; offset += CodecChunkSize)
+		decoder.DecodeChunk(&data[offset]);
+	if (!decoder.Verify(signature))
+		return 0;
+	return decodedSize;
+}
+
+} // namespace
+
+TEST(Codec, DecoderMatchesCodecDecode)
+{
+	for (const size_t size : { 1, 63, 64, 65, 128, 1000 }) {
+		std::vector<std::byte> expected = Encode(size);
+		std::vector<std::byte> actual = expected;
+		EXPECT_EQ(codec_decode(expected.data(), expected.size(), Password), size) << "size " << size;
+		EXPECT_EQ(DecodeChunked(actual), size) << "size " << size;
+		expected.resize(size);
+		actual.resize(size);
+		EXPECT_EQ(actual, expected) << "size " << size;
+	}
+}
+
+TEST(Codec, DecoderRejectsCorruptedSignature)
+{
+	std::vector<std::byte> data = Encode(100);
+	const size_t signatureOffset = data.size() - CodecSignatureSize;
+
+	std::vector<std::byte> badChecksum = data;
+	badChecksum[signatureOffset] ^= std::byte { 1 };
+	EXPECT_EQ(DecodeChunked(badChecksum), 0);
+
+	std::vector<std::byte> badError = data;
+	badError[signatureOffset + 4] = std::byte { 1 };
+	EXPECT_EQ(CodecDecoder::DecodedSize(badError.size(), &badError[signatureOffset]), 0);
+	EXPECT_EQ(DecodeChunked(badError), 0);
+
+	for (const uint8_t lastChunkSize : { 0, 65 }) {
+		std::vector<std::byte> badSize = data;
+		badSize[signatureOffset + 5] = static_cast<std::byte>(lastChunkSize);
+		EXPECT_EQ(CodecDecoder::DecodedSize(badSize.size(), &badSize[signatureOffset]), 0) << "lastChunkSize " << lastChunkSize;
+	}
+}
+
+TEST(Codec, DecoderRejectsCorruptedTrailingChunk)
+{
+	const std::vector<std::byte> data = Encode(100);
+
+	// The size can only be checked against the signature, the contents are caught by `Verify`.
+	std::vector<std::byte> badContents = data;
+	badContents[data.size() - CodecSignatureSize - 1] ^= std::byte { 1 };
+	std::vector<std::byte> badContentsCopy = badContents;
+	EXPECT_EQ(DecodeChunked(badContents), 0);
+	EXPECT_EQ(codec_decode(badContentsCopy.data(), badContentsCopy.size(), Password), 0);
+
+	// A truncated last chunk.
+	std::vector<std::byte> truncated(data.begin(), data.end() - CodecSignatureSize - 1);
+	truncated.insert(truncated.end(), data.end() - CodecSignatureSize, data.end());
+	EXPECT_EQ(CodecDecoder::DecodedSize(truncated.size(), &truncated[truncated.size() - CodecSignatureSize]), 0);
+	EXPECT_EQ(DecodeChunked(truncated), 0);
+
+	// A missing last chunk still has a valid size, but not the checksum of the decoded chunks.
+	std::vector<std::byte> missing(data.begin(), data.end() - CodecSignatureSize - CodecChunkSize);
+	missing.insert(missing.end(), data.end() - CodecSignatureSize, data.end());
+	EXPECT_EQ(DecodeChunked(missing), 0);
+}
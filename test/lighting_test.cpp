@@ -1,12 +1,56 @@
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include "automap.h"
 #include "control.h"
+#include "init.h"
+#include "levels/gendung.h"
 #include "lighting.h"
+#include "player.h"
 
 using namespace devilution;
 
+namespace {
+
+class LightingTest : public ::testing::Test {
+public:
+	static void SetUpTestSuite()
+	{
+		LoadCoreArchives();
+		LoadGameArchives();
+
+		// The tests need spawn.mpq or diabdat.mpq
+		// Please provide them so that the tests can run successfully
+		ASSERT_TRUE(HaveSpawn() || HaveDiabdat());
+	}
+
+	void SetUp() override
+	{
+		leveltype = DTYPE_CATHEDRAL;
+		MakeLightTable();
+		InitLighting();
+		memset(dPiece, 0, sizeof(dPiece));
+		SOLData[0] = TileProperties::None;
+	}
+};
+
+/** @brief Relights the whole map the way ProcessLightList does after loading a level. */
+std::vector<uint8_t> RelightAll()
+{
+	memcpy(dLight, dPreLight, sizeof(dLight));
+	UpdateLighting = true;
+	ProcessLightList();
+	return { &dLight[0][0], &dLight[0][0] + MAXDUNX * MAXDUNY };
+}
+
+} // namespace
+
 TEST(Lighting, CrawlTables)
 {
 	bool added[40][40];
@@ -33,3 +77,207 @@ TEST(Lighting, CrawlTables)
 		}
 	}
 }
+
+TEST_F(LightingTest, IncrementalRelightMatchesFullRelight)
+{
+	std::mt19937 rng(1234);
+	const auto random = [&rng](int min, int max) { return std::uniform_int_distribution<int>(min, max)(rng); };
+
+	for (const dungeon_type type : { DTYPE_CATHEDRAL, DTYPE_CRYPT }) {
+		SCOPED_TRACE(testing::Message() << "leveltype " << static_cast<int>(type));
+		leveltype = type;
+		MakeLightTable();
+		InitLighting();
+
+		// Static light for DoUnLight to restore, and walls that lights hidden in them are not drawn for.
+		SOLData[1] = TileProperties::Solid;
+		for (int x = 0; x < MAXDUNX; x++) {
+			for (int y = 0; y < MAXDUNY; y++) {
+				dPiece[x][y] = random(0, 49) == 0 ? 1 : 0;
+				dPreLight[x][y] = static_cast<uint8_t>(random(10, LightsMax));
+			}
+		}
+		RelightAll();
+
+		// Lights go right up to the edges, where they are drawn without the precomputed cones.
+		const auto randomTile = [&]() { return Point { random(1, MAXDUNX - 2), random(1, MAXDUNY - 2) }; };
+		const auto randomRadius = [&]() { return static_cast<uint8_t>(random(0, 14)); };
+
+		std::vector<int> lights;
+		for (int frame = 0; frame < 2000; frame++) {
+			// Changing a light twice before ProcessLightList forgets where it was drawn, which the game never does.
+			std::array<bool, MAXLIGHTS> changed {};
+			const int changes = random(0, 3);
+			for (int change = 0; change < changes; change++) {
+				const int action = lights.empty() ? 0 : random(0, 5);
+				if (action == 0) {
+					const int lid = AddLight(randomTile(), randomRadius());
+					if (lid != NO_LIGHT) {
+						lights.push_back(lid);
+						changed[lid] = true;
+					}
+					continue;
+				}
+				const size_t index = static_cast<size_t>(random(0, static_cast<int>(lights.size()) - 1));
+				const int lid = lights[index];
+				if (changed[lid])
+					continue;
+				changed[lid] = true;
+				Point next = Lights[lid].position.tile + Displacement { random(-1, 1), random(-1, 1) };
+				if (next.x < 1 || next.x > MAXDUNX - 2 || next.y < 1 || next.y > MAXDUNY - 2)
+					next = randomTile();
+				switch (action) {
+				case 1:
+					AddUnLight(lid);
+					lights.erase(lights.begin() + index);
+					break;
+				case 2:
+					ChangeLightXY(lid, next);
+					break;
+				case 3:
+					ChangeLightRadius(lid, randomRadius());
+					break;
+				case 4:
+					ChangeLightOffset(lid, { static_cast<int8_t>(random(-7, 7)), static_cast<int8_t>(random(-7, 7)) });
+					break;
+				default:
+					ChangeLight(lid, next, randomRadius());
+					break;
+				}
+			}
+			ProcessLightList();
+
+			const std::vector<uint8_t> incremental { &dLight[0][0], &dLight[0][0] + MAXDUNX * MAXDUNY };
+			ASSERT_EQ(incremental, RelightAll()) << "frame " << frame;
+		}
+	}
+}
+
+TEST_F(LightingTest, StampsMatchConeLoop)
+{
+	std::mt19937 rng(42);
+	std::vector<uint8_t> before(MAXDUNX * MAXDUNY);
+	std::vector<uint8_t> stamped;
+
+	// Switching back and forth, as the stamps are only made again when the falloffs change.
+	for (const dungeon_type type : { DTYPE_CATHEDRAL, DTYPE_NEST, DTYPE_HELL, DTYPE_CRYPT, DTYPE_CATACOMBS }) {
+		leveltype = type;
+		MakeLightTable();
+		for (uint8_t radius = 0; radius < 16; radius++) {
+			for (uint8_t &level : before)
+				level = static_cast<uint8_t>(std::uniform_int_distribution<int>(0, LightsMax)(rng));
+			for (int8_t offsetX = -7; offsetX <= 7; offsetX++) {
+				for (int8_t offsetY = -7; offsetY <= 7; offsetY++) {
+					constexpr Point Position { 50, 50 };
+					memcpy(dLight, before.data(), sizeof(dLight));
+					DoLighting(Position, radius, { offsetX, offsetY });
+					stamped.assign(&dLight[0][0], &dLight[0][0] + MAXDUNX * MAXDUNY);
+
+					memcpy(dLight, before.data(), sizeof(dLight));
+					DoLightingWithoutStamps(Position, radius, { offsetX, offsetY });
+					ASSERT_EQ(stamped, std::vector<uint8_t>(&dLight[0][0], &dLight[0][0] + MAXDUNX * MAXDUNY))
+					    << "leveltype " << static_cast<int>(type) << " radius " << static_cast<int>(radius)
+					    << " offset " << static_cast<int>(offsetX) << ":" << static_cast<int>(offsetY);
+				}
+			}
+		}
+	}
+}
+
+namespace {
+
+struct VisionState {
+	std::vector<DungeonFlag> flags;
+	std::vector<uint8_t> automapView;
+	std::array<bool, 256> transList;
+
+	static VisionState Save()
+	{
+		return {
+			{ &dFlags[0][0], &dFlags[0][0] + MAXDUNX * MAXDUNY },
+			{ &AutomapView[0][0], &AutomapView[0][0] + DMAXX * DMAXY },
+			TransList,
+		};
+	}
+
+	void restore() const
+	{
+		std::copy(flags.begin(), flags.end(), &dFlags[0][0]);
+		std::copy(automapView.begin(), automapView.end(), &AutomapView[0][0]);
+		TransList = transList;
+	}
+
+	bool operator==(const VisionState &other) const
+	{
+		return flags == other.flags && automapView == other.automapView && transList == other.transList;
+	}
+};
+
+} // namespace
+
+TEST_F(LightingTest, CachedVisionMatchesCrawl)
+{
+	std::mt19937 rng(7);
+	const auto random = [&rng](int min, int max) { return std::uniform_int_distribution<int>(min, max)(rng); };
+
+	// Pillars that block light and rooms with their own transparency.
+	SOLData[1] = TileProperties::BlockLight;
+	for (int x = 0; x < MAXDUNX; x++) {
+		for (int y = 0; y < MAXDUNY; y++) {
+			dPiece[x][y] = random(0, 7) == 0 ? 1 : 0;
+			dTransVal[x][y] = static_cast<int8_t>((x / 10 + y / 10) % 4);
+		}
+	}
+	memset(dFlags, 0, sizeof(dFlags));
+	memset(AutomapView, 0, sizeof(AutomapView));
+
+	currlevel = 1;
+	Players.resize(1);
+	MyPlayer = &Players[0];
+	MyPlayer->plractive = true;
+	MyPlayer->plrlevel = currlevel;
+	MyPlayer->plrIsOnSetLevel = false;
+
+	Point position { 40, 40 };
+	int radius = 10;
+	ActivateVision(position, radius, 0);
+	ProcessVisionList();
+
+	for (int frame = 0; frame < 3000; frame++) {
+		const Point oldPosition = position;
+		const int oldRadius = radius;
+		switch (random(0, 5)) {
+		case 0: {
+			const Point next = position + Displacement { random(-1, 1), random(-1, 1) };
+			if (next.x >= 20 && next.x < MAXDUNX - 20 && next.y >= 20 && next.y < MAXDUNY - 20)
+				position = next;
+			ChangeVisionXY(0, position);
+		} break;
+		case 1:
+			radius = random(1, 15);
+			ChangeVisionRadius(0, radius);
+			break;
+		case 2: {
+			// Opening or closing a door next to the player like ObjSetMicro, the cached tiles are stale after that.
+			const Point door = position + Displacement { random(-5, 5), random(-5, 5) };
+			dPiece[door.x][door.y] = dPiece[door.x][door.y] == 0 ? 1 : 0;
+			InvalidateVisionCache();
+			ChangeVisionXY(0, position);
+		} break;
+		default:
+			// Standing still, e.g. after a monster died, reuses the cached tiles.
+			ChangeVisionXY(0, position);
+			break;
+		}
+
+		const VisionState before = VisionState::Save();
+		ProcessVisionList();
+		const VisionState cached = VisionState::Save();
+
+		before.restore();
+		TransList = {};
+		DoUnVision(oldPosition, oldRadius);
+		DoVision(position, radius, MAP_EXP_SELF, true);
+		ASSERT_TRUE(cached == VisionState::Save()) << "frame " << frame;
+	}
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mpq/mpq_reader.hpp"
+#include "mpq/mpq_writer.hpp"
+#include "utils/file_util.h"
+
+namespace devilution {
+namespace {
+
+TEST(MpqReaderTest, TruncatedArchive)
+{
+	const std::string path = "Test_MpqReaderTest_TruncatedArchive.mpq";
+	if (FileExists(path))
+		RemoveFile(path.c_str());
+
+	std::vector<std::byte> contents(20000);
+	for (size_t i = 0; i < contents.size(); ++i)
+		contents[i] = static_cast<std::byte>(i * 31 + i / 100);
+	{
+		MpqWriter writer { path };
+		ASSERT_TRUE(writer.WriteFile("file", contents.data(), contents.size()));
+	}
+
+	// The file's data is at the end of the archive, cut some of it off.
+	std::uintmax_t archiveSize;
+	ASSERT_TRUE(GetFileSize(path.c_str(), &archiveSize));
+	ASSERT_TRUE(ResizeFile(path.c_str(), archiveSize - 100));
+
+	int32_t error;
+	std::optional<MpqArchive> archive = MpqArchive::Open(path.c_str(), error);
+	ASSERT_TRUE(archive) << MpqArchive::ErrorMessage(error);
+	size_t size;
+	const std::unique_ptr<std::byte[]> data = archive->ReadFile("file", size, error);
+	EXPECT_EQ(data, nullptr);
+	EXPECT_NE(error, 0);
+}
+
+} // namespace
+} // namespace devilution
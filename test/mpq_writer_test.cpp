@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "codec.h"
+#include "mpq/mpq_reader.hpp"
+#include "mpq/mpq_writer.hpp"
+#include "utils/file_util.h"
+
+namespace devilution {
+namespace {
+
+std::string GetTmpPathName()
+{
+	const auto *currentTest = ::testing::UnitTest::GetInstance()->current_test_info();
+	std::string result = "Test_";
+	result.append(currentTest->test_case_name());
+	result += '_';
+	result.append(currentTest->name());
+	result.append(".mpq");
+	return result;
+}
+
+std::vector<std::byte> MakeContents(size_t size, uint8_t seed)
+{
+	std::vector<std::byte> contents(size);
+	for (size_t i = 0; i < size; ++i)
+		contents[i] = static_cast<std::byte>((i / 7) * seed + (i % 3));
+	return contents;
+}
+
+void WriteFile(MpqWriter &writer, std::string_view name, const std::vector<std::byte> &contents)
+{
+	ASSERT_TRUE(writer.WriteFile(name, contents.data(), contents.size()));
+}
+
+std::vector<std::byte> ReadFile(MpqArchive &archive, std::string_view name)
+{
+	size_t size;
+	int32_t error;
+	const std::unique_ptr<std::byte[]> data = archive.ReadFile(name, size, error);
+	if (data == nullptr)
+		return {};
+	return { data.get(), data.get() + size };
+}
+
+TEST(MpqWriterTest, RoundTrip)
+{
+	const std::string path = GetTmpPathName();
+	if (FileExists(path))
+		RemoveFile(path.c_str());
+
+	// Larger than a sector, so that the files are split into several compressed sectors.
+	const std::vector<std::byte> kept = MakeContents(10000, 3);
+	const std::vector<std::byte> renamed = MakeContents(5000, 5);
+	const std::vector<std::byte> removed = MakeContents(100, 7);
+	const std::vector<std::byte> replaced = MakeContents(2000, 11);
+	const std::vector<std::byte> replacement = MakeContents(3000, 13);
+	const std::vector<std::byte> added = MakeContents(1, 17);
+	{
+		MpqWriter writer { path };
+		WriteFile(writer, "kept", kept);
+		WriteFile(writer, "renamed", renamed);
+		WriteFile(writer, "removed", removed);
+		WriteFile(writer, "replaced", replaced);
+	}
+
+	// Edit the archive that was just written, so that unchanged files are copied over from it.
+	{
+		MpqWriter writer { path };
+		ASSERT_TRUE(writer.HasFile("kept"));
+		writer.RenameFile("renamed", "new_name");
+		writer.RemoveHashEntry("removed");
+		WriteFile(writer, "replaced", replacement);
+		WriteFile(writer, "added", added);
+		EXPECT_FALSE(writer.HasFile("renamed"));
+		EXPECT_FALSE(writer.HasFile("removed"));
+		EXPECT_TRUE(writer.HasFile("new_name"));
+		EXPECT_TRUE(writer.Commit());
+	}
+	EXPECT_FALSE(FileExists(path + ".tmp"));
+
+	int32_t error;
+	std::optional<MpqArchive> archive = MpqArchive::Open(path.c_str(), error);
+	ASSERT_TRUE(archive) << MpqArchive::ErrorMessage(error);
+	EXPECT_EQ(ReadFile(*archive, "kept"), kept);
+	EXPECT_EQ(ReadFile(*archive, "new_name"), renamed);
+	EXPECT_EQ(ReadFile(*archive, "replaced"), replacement);
+	EXPECT_EQ(ReadFile(*archive, "added"), added);
+	EXPECT_FALSE(archive->HasFile("renamed"));
+	EXPECT_FALSE(archive->HasFile("removed"));
+}
+
+TEST(MpqWriterTest, EncodedFile)
+{
+	const std::string path = GetTmpPathName();
+	if (FileExists(path))
+		RemoveFile(path.c_str());
+
+	constexpr char Password[] = "xrgyrkj1";
+	const std::vector<std::byte> contents = MakeContents(4000, 19);
+	{
+		MpqWriter writer { path };
+		std::unique_ptr<std::byte[]> data { new std::byte[codec_get_encoded_len(contents.size())] };
+		std::copy(contents.begin(), contents.end(), data.get());
+		ASSERT_TRUE(writer.WriteEncodedFile("encoded", std::move(data), contents.size(), Password));
+	}
+	EXPECT_FALSE(FileExists(path + ".tmp"));
+
+	int32_t error;
+	std::optional<MpqArchive> archive = MpqArchive::Open(path.c_str(), error);
+	ASSERT_TRUE(archive) << MpqArchive::ErrorMessage(error);
+	std::vector<std::byte> encoded = ReadFile(*archive, "encoded");
+	ASSERT_EQ(encoded.size(), codec_get_encoded_len(contents.size()));
+	const size_t decodedSize = codec_decode(encoded.data(), encoded.size(), Password);
+	ASSERT_EQ(decodedSize, contents.size());
+	encoded.resize(decodedSize);
+	EXPECT_EQ(encoded, contents);
+}
+
+} // namespace
+} // namespace devilution
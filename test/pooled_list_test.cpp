@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <vector>
+
+#include "utils/pooled_list.hpp"
+
+namespace devilution {
+namespace {
+
+std::vector<int> Values(const PooledList<int, 4> &list)
+{
+	return { list.begin(), list.end() };
+}
+
+TEST(PooledListTest, KeepsInsertionOrder)
+{
+	PooledList<int, 4> list;
+	for (int i = 0; i < 10; i++)
+		list.emplace_back(i);
+	EXPECT_EQ(list.size(), 10);
+	EXPECT_EQ(list.back(), 9);
+	EXPECT_EQ(Values(list), (std::vector<int> { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+
+	auto it = list.cbegin();
+	std::advance(it, 7);
+	EXPECT_EQ(*it, 7);
+}
+
+TEST(PooledListTest, RemoveIfKeepsOrderAndReusesSlots)
+{
+	PooledList<int, 4> list;
+	std::vector<int *> addresses;
+	for (int i = 0; i < 8; i++)
+		addresses.push_back(&list.emplace_back(i));
+
+	EXPECT_EQ(list.remove_if([](int value) { return value % 3 == 0; }), 3);
+	EXPECT_EQ(Values(list), (std::vector<int> { 1, 2, 4, 5, 7 }));
+	EXPECT_EQ(&list.back(), addresses[7]);
+
+	// New elements go to the end of the list but reuse the removed slots.
+	int &reused = list.emplace_back(42);
+	EXPECT_EQ(Values(list), (std::vector<int> { 1, 2, 4, 5, 7, 42 }));
+	EXPECT_TRUE(&reused == addresses[0] || &reused == addresses[3] || &reused == addresses[6]);
+}
+
+TEST(PooledListTest, VisitsElementsAddedWhileIterating)
+{
+	PooledList<int, 4> list;
+	list.emplace_back(3);
+	std::vector<int> visited;
+	for (int &value : list) {
+		visited.push_back(value);
+		if (value > 0)
+			list.emplace_back(value - 1);
+		// Growing the pool must not move the element being visited.
+		EXPECT_EQ(value, visited.back());
+	}
+	EXPECT_EQ(visited, (std::vector<int> { 3, 2, 1, 0 }));
+}
+
+TEST(PooledListTest, Clear)
+{
+	PooledList<int, 4> list;
+	int *first = &list.emplace_back(1);
+	list.emplace_back(2);
+	list.clear();
+	EXPECT_TRUE(list.empty());
+	EXPECT_EQ(list.begin(), list.end());
+	EXPECT_EQ(&list.emplace_back(3), first);
+}
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "engine/render/prelit_tile_cache.hpp"
+
+namespace devilution {
+namespace {
+
+constexpr uint16_t TileTypeShift = 12;
+
+LevelCelBlock MakeLevelCelBlock(TileType tileType, uint16_t frame)
+{
+	return LevelCelBlock { static_cast<uint16_t>((static_cast<uint16_t>(tileType) << TileTypeShift) | frame) };
+}
+
+/** @brief Builds a CEL file out of the given frames. */
+std::vector<std::byte> MakeCel(const std::vector<std::vector<uint8_t>> &frames)
+{
+	const size_t headerSize = sizeof(uint32_t) * (frames.size() + 2);
+	std::vector<uint32_t> header;
+	header.push_back(static_cast<uint32_t>(frames.size()));
+	uint32_t offset = static_cast<uint32_t>(headerSize);
+	for (const std::vector<uint8_t> &frame : frames) {
+		header.push_back(offset);
+		offset += static_cast<uint32_t>(frame.size());
+	}
+	header.push_back(offset);
+
+	std::vector<std::byte> cel(offset);
+	std::memcpy(cel.data(), header.data(), headerSize);
+	for (size_t i = 0; i < frames.size(); ++i)
+		std::memcpy(&cel[header[i + 1]], frames[i].data(), frames[i].size());
+	return cel;
+}
+
+std::array<uint8_t, 256> MakeLightTable(uint8_t shade)
+{
+	std::array<uint8_t, 256> lightTable;
+	for (size_t i = 0; i < lightTable.size(); ++i)
+		lightTable[i] = static_cast<uint8_t>(i + shade);
+	return lightTable;
+}
+
+std::vector<uint8_t> MakeSquare()
+{
+	std::vector<uint8_t> square(DunFrameWidth * DunFrameHeight);
+	for (size_t i = 0; i < square.size(); ++i)
+		square[i] = static_cast<uint8_t>(64 + i % 128);
+	return square;
+}
+
+TEST(PreLitTileCacheTest, AppliesLightTableToSquares)
+{
+	const std::vector<uint8_t> square = MakeSquare();
+	const std::vector<std::byte> cel = MakeCel({ square });
+	const std::array<uint8_t, 256> lightTable = MakeLightTable(3);
+	InvalidatePreLitTiles();
+
+	const uint8_t *frame = GetPreLitTileFrame(cel.data(), MakeLevelCelBlock(TileType::Square, 1), 3, lightTable.data());
+	ASSERT_NE(frame, nullptr);
+	for (size_t i = 0; i < square.size(); ++i)
+		ASSERT_EQ(frame[i], lightTable[square[i]]) << "i=" << i;
+}
+
+TEST(PreLitTileCacheTest, KeepsTransparentSquareRunHeaders)
+{
+	// Each line: 8 transparent pixels, 24 opaque pixels.
+	std::vector<uint8_t> transparentSquare;
+	for (int y = 0; y < DunFrameHeight; ++y) {
+		transparentSquare.push_back(static_cast<uint8_t>(-8));
+		transparentSquare.push_back(24);
+		for (int x = 0; x < 24; ++x)
+			transparentSquare.push_back(static_cast<uint8_t>(100 + x));
+	}
+	const std::vector<std::byte> cel = MakeCel({ transparentSquare });
+	const std::array<uint8_t, 256> lightTable = MakeLightTable(5);
+	InvalidatePreLitTiles();
+
+	const uint8_t *frame = GetPreLitTileFrame(cel.data(), MakeLevelCelBlock(TileType::TransparentSquare, 1), 5, lightTable.data());
+	ASSERT_NE(frame, nullptr);
+	for (size_t i = 0; i < transparentSquare.size(); ++i) {
+		const bool isHeader = i % 26 < 2;
+		const uint8_t expected = isHeader ? transparentSquare[i] : lightTable[transparentSquare[i]];
+		ASSERT_EQ(frame[i], expected) << "i=" << i;
+	}
+}
+
+TEST(PreLitTileCacheTest, InvalidateRebuildsFrames)
+{
+	const std::vector<std::byte> cel = MakeCel({ MakeSquare() });
+	std::array<uint8_t, 256> lightTable = MakeLightTable(1);
+	InvalidatePreLitTiles();
+
+	const LevelCelBlock levelCelBlock = MakeLevelCelBlock(TileType::Square, 1);
+	EXPECT_EQ(GetPreLitTileFrame(cel.data(), levelCelBlock, 7, lightTable.data())[0], 65);
+
+	lightTable = MakeLightTable(2);
+	EXPECT_EQ(GetPreLitTileFrame(cel.data(), levelCelBlock, 7, lightTable.data())[0], 65);
+
+	InvalidatePreLitTiles();
+	EXPECT_EQ(GetPreLitTileFrame(cel.data(), levelCelBlock, 7, lightTable.data())[0], 66);
+}
+
+TEST(PreLitTileCacheTest, ColorCyclingOnlyDropsCycledFrames)
+{
+	std::vector<uint8_t> cycled(DunFrameWidth * DunFrameHeight, 20);
+	const std::vector<std::byte> cel = MakeCel({ MakeSquare(), cycled });
+	std::array<uint8_t, 256> lightTable = MakeLightTable(1);
+	InvalidatePreLitTiles();
+
+	const LevelCelBlock plain = MakeLevelCelBlock(TileType::Square, 1);
+	const LevelCelBlock lava = MakeLevelCelBlock(TileType::Square, 2);
+	EXPECT_EQ(GetPreLitTileFrame(cel.data(), plain, 4, lightTable.data())[0], 65);
+	EXPECT_EQ(GetPreLitTileFrame(cel.data(), lava, 4, lightTable.data())[0], 21);
+
+	lightTable = MakeLightTable(2);
+	InvalidateColorCycledPreLitTiles();
+	EXPECT_EQ(GetPreLitTileFrame(cel.data(), plain, 4, lightTable.data())[0], 65);
+	EXPECT_EQ(GetPreLitTileFrame(cel.data(), lava, 4, lightTable.data())[0], 22);
+}
+
+TEST(PreLitTileCacheTest, EvictsLeastRecentlyUsed)
+{
+	constexpr uint16_t NumFrames = PreLitTileCacheCapacity + 1;
+	const std::vector<std::byte> cel = MakeCel(std::vector<std::vector<uint8_t>>(NumFrames, MakeSquare()));
+	std::array<uint8_t, 256> lightTable = MakeLightTable(1);
+	InvalidatePreLitTiles();
+
+	for (uint16_t frame = 1; frame < NumFrames; ++frame)
+		GetPreLitTileFrame(cel.data(), MakeLevelCelBlock(TileType::Square, frame), 1, lightTable.data());
+	// Frame 1 becomes the most recently used one, so adding one more frame evicts frame 2 instead.
+	GetPreLitTileFrame(cel.data(), MakeLevelCelBlock(TileType::Square, 1), 1, lightTable.data());
+	GetPreLitTileFrame(cel.data(), MakeLevelCelBlock(TileType::Square, NumFrames), 1, lightTable.data());
+
+	lightTable = MakeLightTable(2);
+	EXPECT_EQ(GetPreLitTileFrame(cel.data(), MakeLevelCelBlock(TileType::Square, 1), 1, lightTable.data())[0], 65);
+	EXPECT_EQ(GetPreLitTileFrame(cel.data(), MakeLevelCelBlock(TileType::Square, 2), 1, lightTable.data())[0], 66);
+}
+
+} // namespace
+} // namespace devilution
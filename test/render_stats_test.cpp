@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+
+#include "engine/render/render_stats.hpp"
+
+namespace devilution {
+namespace {
+
+class RenderStatsTest : public ::testing::Test {
+protected:
+	void SetUp() override
+	{
+		SetRenderStatsEnabled(false);
+		SetRenderStatsEnabled(true);
+	}
+
+	void TearDown() override
+	{
+		SetRenderStatsEnabled(false);
+	}
+};
+
+TEST_F(RenderStatsTest, ScopesAreCountedPerFrame)
+{
+	BeginRenderStatsFrame();
+	{
+		const RenderStatsScope tile { RenderStatsCategory::Tiles };
+	}
+	{
+		const RenderStatsScope text { RenderStatsCategory::Text };
+		// Glyphs are attributed to the text that contains them.
+		const RenderStatsScope glyph { RenderStatsCategory::Sprites };
+	}
+	{
+		const RenderStatsScope sprite { RenderStatsCategory::Sprites };
+	}
+	CountRenderedTile(TileType::LeftTriangle, MaskType::Left);
+	EndRenderStatsFrame();
+
+	ASSERT_EQ(GetRenderStatsFrameCount(), 1);
+	const RenderStatsFrame &frame = GetRenderStatsFrame(0);
+	EXPECT_EQ(frame.counts[static_cast<size_t>(RenderStatsCategory::Tiles)], 1);
+	EXPECT_EQ(frame.counts[static_cast<size_t>(RenderStatsCategory::Text)], 1);
+	EXPECT_EQ(frame.counts[static_cast<size_t>(RenderStatsCategory::Sprites)], 1);
+	EXPECT_EQ(frame.counts[static_cast<size_t>(RenderStatsCategory::Automap)], 0);
+	EXPECT_EQ(GetRenderedTileCount(TileType::LeftTriangle, MaskType::Left), 1);
+	EXPECT_EQ(GetRenderedTileCount(TileType::Square, MaskType::Solid), 0);
+
+	BeginRenderStatsFrame();
+	EndRenderStatsFrame();
+	ASSERT_EQ(GetRenderStatsFrameCount(), 2);
+	EXPECT_EQ(GetRenderStatsFrame(1).counts[static_cast<size_t>(RenderStatsCategory::Tiles)], 0);
+	EXPECT_EQ(GetRenderedTileCount(TileType::LeftTriangle, MaskType::Left), 0);
+}
+
+TEST_F(RenderStatsTest, NothingIsRecordedWhenDisabled)
+{
+	SetRenderStatsEnabled(false);
+	BeginRenderStatsFrame();
+	{
+		const RenderStatsScope tile { RenderStatsCategory::Tiles };
+	}
+	EndRenderStatsFrame();
+	SetRenderStatsEnabled(true);
+	EXPECT_EQ(GetRenderStatsFrameCount(), 0);
+}
+
+TEST_F(RenderStatsTest, HistoryKeepsTheLatestFrames)
+{
+	for (size_t i = 0; i < RenderStatsHistorySize + 10; ++i) {
+		BeginRenderStatsFrame();
+		for (size_t j = 0; j < i; ++j) {
+			const RenderStatsScope blit { RenderStatsCategory::Blit };
+		}
+		EndRenderStatsFrame();
+	}
+	ASSERT_EQ(GetRenderStatsFrameCount(), RenderStatsHistorySize);
+	EXPECT_EQ(GetRenderStatsFrame(0).counts[static_cast<size_t>(RenderStatsCategory::Blit)], 10);
+	EXPECT_EQ(GetRenderStatsFrame(RenderStatsHistorySize - 1).counts[static_cast<size_t>(RenderStatsCategory::Blit)], RenderStatsHistorySize + 9);
+
+	size_t histogramTotal = 0;
+	for (uint16_t count : GetRenderStatsHistogram())
+		histogramTotal += count;
+	EXPECT_EQ(histogramTotal, RenderStatsHistorySize);
+}
+
+TEST_F(RenderStatsTest, CsvHasOneRowPerFrame)
+{
+	for (int i = 0; i < 3; ++i) {
+		BeginRenderStatsFrame();
+		EndRenderStatsFrame();
+	}
+	const std::string csv = FormatRenderStatsCsv();
+	EXPECT_EQ(csv.substr(0, csv.find('\n')), "frame,frame_us,Tiles,Tiles_us,Sprites,Sprites_us,Text,Text_us,Automap,Automap_us,Blit,Blit_us");
+	EXPECT_EQ(std::count(csv.begin(), csv.end(), '\n'), 4);
+	EXPECT_NE(csv.find("\n2,"), std::string::npos);
+}
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#include "utils/sdl_bilinear_scale.hpp"
+#include "utils/sdl_wrap.h"
+
+namespace devilution {
+namespace {
+
+SDLSurfaceUniquePtr CreateSurface32(int width, int height)
+{
+	return SDLWrap::CreateRGBSurface(0, width, height, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+}
+
+uint32_t &PixelAt32(SDL_Surface *surface, int x, int y)
+{
+	return reinterpret_cast<uint32_t *>(static_cast<uint8_t *>(surface->pixels) + y * surface->pitch)[x];
+}
+
+uint8_t &PixelAt8(SDL_Surface *surface, int x, int y)
+{
+	return static_cast<uint8_t *>(surface->pixels)[y * surface->pitch + x];
+}
+
+TEST(SdlBilinearScaleTest, IntegerScaleRepeatsPixels)
+{
+	const SDLSurfaceUniquePtr src = CreateSurface32(5, 3);
+	for (int y = 0; y < 3; ++y) {
+		for (int x = 0; x < 5; ++x)
+			PixelAt32(src.get(), x, y) = 0xFF000000 | (y << 8) | x;
+	}
+	const SDLSurfaceUniquePtr dst = CreateSurface32(15, 6);
+	IntegerScale32(src.get(), dst.get());
+	for (int y = 0; y < 6; ++y) {
+		for (int x = 0; x < 15; ++x)
+			EXPECT_EQ(PixelAt32(dst.get(), x, y), PixelAt32(src.get(), x / 3, y / 2)) << "x=" << x << " y=" << y;
+	}
+}
+
+// Large enough to be scaled on the worker threads.
+TEST(SdlBilinearScaleTest, BilinearScaleKeepsUniformColors)
+{
+	const SDLSurfaceUniquePtr src = CreateSurface32(64, 48);
+	for (int y = 0; y < 48; ++y) {
+		for (int x = 0; x < 64; ++x)
+			PixelAt32(src.get(), x, y) = x < 32 ? 0xFF336699 : 0;
+	}
+	const SDLSurfaceUniquePtr dst = CreateSurface32(640, 480);
+	BilinearScale32(src.get(), dst.get());
+	for (int y = 0; y < 480; ++y) {
+		EXPECT_EQ(PixelAt32(dst.get(), 0, y), 0xFF336699) << "y=" << y;
+		EXPECT_EQ(PixelAt32(dst.get(), 300, y), 0xFF336699) << "y=" << y;
+		EXPECT_EQ(PixelAt32(dst.get(), 639, y), 0) << "y=" << y;
+	}
+}
+
+TEST(SdlBilinearScaleTest, DownscaleByHalfMatchesReference)
+{
+	constexpr uint8_t Transparent = 1;
+	constexpr int Width = 21;
+	constexpr int Height = 9;
+	static uint8_t blendingTable[256][256];
+	std::mt19937 rng(0);
+	for (auto &row : blendingTable) {
+		for (uint8_t &blended : row)
+			blended = static_cast<uint8_t>(rng());
+	}
+	const SDLSurfaceUniquePtr src = SDLWrap::CreateRGBSurface(0, Width * 2, Height * 2, 8, 0, 0, 0, 0);
+	for (int y = 0; y < Height * 2; ++y) {
+		for (int x = 0; x < Width * 2; ++x)
+			PixelAt8(src.get(), x, y) = rng() % 3 == 0 ? Transparent : static_cast<uint8_t>(rng());
+	}
+	const SDLSurfaceUniquePtr dst = SDLWrap::CreateRGBSurface(0, Width, Height, 8, 0, 0, 0, 0);
+	BilinearDownscaleByHalf8(src.get(), blendingTable, dst.get(), Transparent);
+
+	const auto blend = [&](uint8_t a, uint8_t b) {
+		if (a == Transparent)
+			a = b;
+		if (b == Transparent)
+			b = a;
+		return blendingTable[a][b];
+	};
+	for (int y = 0; y < Height; ++y) {
+		for (int x = 0; x < Width; ++x) {
+			const uint8_t top = blend(PixelAt8(src.get(), 2 * x, 2 * y), PixelAt8(src.get(), 2 * x + 1, 2 * y));
+			const uint8_t bottom = blend(PixelAt8(src.get(), 2 * x, 2 * y + 1), PixelAt8(src.get(), 2 * x + 1, 2 * y + 1));
+			EXPECT_EQ(PixelAt8(dst.get(), x, y), blend(top, bottom)) << "x=" << x << " y=" << y;
+		}
+	}
+}
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DiabloUI/ui_flags.hpp"
+#include "engine/point.hpp"
+#include "engine/rectangle.hpp"
+#include "engine/render/text_render.hpp"
+#include "engine/surface.hpp"
+#include "init.h"
+
+namespace devilution {
+namespace {
+
+constexpr int SurfaceWidth = 320;
+constexpr int SurfaceHeight = 160;
+
+struct DrawnText {
+	std::vector<uint8_t> pixels;
+	uint32_t bytesDrawn;
+};
+
+/**
+ * @brief Draws the text on a blank surface.
+ * @param cached Draw from a cached layout, otherwise the string is decoded, measured and wrapped while drawing.
+ */
+DrawnText Draw(std::string_view text, const Rectangle &rect, TextRenderOptions opts, bool cached)
+{
+	OwnedSurface out { SurfaceWidth, SurfaceHeight };
+	std::memset(out.begin(), 0, static_cast<size_t>(out.pitch()) * out.h());
+
+	// Asking for the cursor position bypasses the layout cache, there is no cursor to draw though.
+	std::optional<Point> cursorPosition;
+	if (!cached)
+		opts.renderedCursorPositionOut = &cursorPosition;
+
+	DrawnText drawn;
+	drawn.bytesDrawn = DrawString(out, text, rect, opts);
+	for (int y = 0; y < out.h(); ++y)
+		drawn.pixels.insert(drawn.pixels.end(), out.at(0, y), out.at(out.w(), y));
+	return drawn;
+}
+
+void ExpectSameAsUncached(std::string_view text, const Rectangle &rect, const TextRenderOptions &opts)
+{
+	const DrawnText expected = Draw(text, rect, opts, /*cached=*/false);
+	// The first draw lays the text out, the second one reuses the layout.
+	for (int i = 0; i < 2; ++i) {
+		const DrawnText actual = Draw(text, rect, opts, /*cached=*/true);
+		EXPECT_EQ(actual.bytesDrawn, expected.bytesDrawn) << "draw " << i;
+		EXPECT_EQ(actual.pixels, expected.pixels) << "draw " << i;
+	}
+}
+
+class TextRenderTest : public ::testing::Test {
+public:
+	void SetUp() override
+	{
+		UnloadFonts();
+	}
+
+	static void SetUpTestSuite()
+	{
+		LoadCoreArchives();
+	}
+
+	static void TearDownTestSuite()
+	{
+		UnloadFonts();
+	}
+};
+
+constexpr std::string_view LongText = "The sanctity of this place has been fouled by the stench of evil, the dead do not rest.";
+
+TEST_F(TextRenderTest, SingleLineMatchesUncached)
+{
+	ExpectSameAsUncached("Short Sword", { { 10, 10 }, { 200, 0 } }, { .flags = UiFlags::ColorWhite });
+	ExpectSameAsUncached("Short Sword", { { 10, 10 }, { 200, 20 } }, { .flags = UiFlags::ColorBlue | UiFlags::AlignCenter });
+	ExpectSameAsUncached("Short Sword", { { 10, 10 }, { 200, 20 } }, { .flags = UiFlags::ColorGold | UiFlags::AlignRight | UiFlags::Outlined });
+}
+
+TEST_F(TextRenderTest, WrappedMatchesUncached)
+{
+	for (const UiFlags align : { UiFlags::None, UiFlags::AlignCenter, UiFlags::AlignRight }) {
+		ExpectSameAsUncached(LongText, { { 5, 5 }, { 120, 0 } }, { .flags = UiFlags::ColorWhite | align });
+		ExpectSameAsUncached(LongText, { { 5, 5 }, { 120, 100 } }, { .flags = UiFlags::ColorWhite | align | UiFlags::VerticalCenter, .lineHeight = 14 });
+	}
+	ExpectSameAsUncached("First line\nSecond, longer line\n\nFourth", { { 5, 5 }, { 150, 0 } }, { .flags = UiFlags::ColorWhite | UiFlags::AlignCenter });
+}
+
+TEST_F(TextRenderTest, ClippedMatchesUncached)
+{
+	// Cut off at the bottom of the rectangle and of the surface.
+	ExpectSameAsUncached(LongText, { { 5, 5 }, { 100, 30 } }, { .flags = UiFlags::ColorWhite });
+	ExpectSameAsUncached(LongText, { { 5, SurfaceHeight - 20 }, { 100, 0 } }, { .flags = UiFlags::ColorRed | UiFlags::AlignCenter });
+	// Partially outside of the surface.
+	ExpectSameAsUncached(LongText, { { -40, -6 }, { 150, 60 } }, { .flags = UiFlags::ColorWhite });
+	ExpectSameAsUncached(LongText, { { SurfaceWidth - 60, 5 }, { 150, 60 } }, { .flags = UiFlags::ColorWhite | UiFlags::FontSize24 });
+}
+
+TEST_F(TextRenderTest, KernedMatchesUncached)
+{
+	for (const int width : { 40, 60, 90, 300 }) {
+		ExpectSameAsUncached("Ring of the Heavens", { { 5, 5 }, { width, 20 } }, { .flags = UiFlags::ColorWhite | UiFlags::KerningFitSpacing, .spacing = 2 });
+		ExpectSameAsUncached("Ring of the Heavens", { { 5, 5 }, { width, 20 } }, { .flags = UiFlags::ColorWhite | UiFlags::KerningFitSpacing | UiFlags::AlignCenter });
+	}
+}
+
+TEST_F(TextRenderTest, ReusedLayoutMatchesUncached)
+{
+	// Left aligned text reuses its layout for other positions and sizes as long as it wraps and is cut off the same way.
+	const TextRenderOptions opts { .flags = UiFlags::ColorWhite };
+	for (const Rectangle &rect : {
+	         Rectangle { { 0, 0 }, { 300, 0 } },
+	         Rectangle { { 20, 40 }, { 300, 0 } },
+	         Rectangle { { 20, 40 }, { 290, 0 } },
+	         Rectangle { { 20, 40 }, { 150, 0 } },
+	         Rectangle { { 20, 40 }, { 80, 0 } },
+	         Rectangle { { 20, 40 }, { 80, 20 } },
+	         Rectangle { { 20, 40 }, { 300, 0 } },
+	         Rectangle { { 20, SurfaceHeight - 14 }, { 80, 0 } },
+	     }) {
+		SCOPED_TRACE(testing::Message() << "x=" << rect.position.x << " y=" << rect.position.y << " w=" << rect.size.width << " h=" << rect.size.height);
+		const DrawnText expected = Draw(LongText, rect, opts, /*cached=*/false);
+		const DrawnText actual = Draw(LongText, rect, opts, /*cached=*/true);
+		EXPECT_EQ(actual.bytesDrawn, expected.bytesDrawn);
+		EXPECT_EQ(actual.pixels, expected.pixels);
+	}
+}
+
+TEST_F(TextRenderTest, WordWrapCacheIsKeyedByWidthSizeAndSpacing)
+{
+	struct WrapArgs {
+		unsigned width;
+		GameFontTables size;
+		int spacing;
+	};
+	const WrapArgs args[] = {
+		{ 100, GameFont12, 1 },
+		{ 200, GameFont12, 1 },
+		{ 100, GameFont24, 1 },
+		{ 100, GameFont12, 3 },
+	};
+
+	std::vector<std::string> expected;
+	for (const WrapArgs &arg : args) {
+		UnloadFonts();
+		expected.push_back(WordWrapString(LongText, arg.width, arg.size, arg.spacing));
+	}
+	EXPECT_NE(expected[0], expected[1]);
+	EXPECT_NE(expected[0], expected[2]);
+	EXPECT_NE(expected[0], expected[3]);
+
+	UnloadFonts();
+	for (int pass = 0; pass < 2; ++pass) {
+		for (size_t i = 0; i < std::size(args); ++i)
+			EXPECT_EQ(WordWrapString(LongText, args[i].width, args[i].size, args[i].spacing), expected[i]) << "pass " << pass << ", args " << i;
+	}
+}
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "utils/thread_pool.hpp"
+
+namespace devilution {
+namespace {
+
+TEST(ThreadPoolTest, ParallelForRunsEveryJobOnce)
+{
+	ThreadPool pool(3);
+	std::vector<int> calls(100);
+	pool.parallelFor(static_cast<unsigned>(calls.size()), [&calls](unsigned i) { ++calls[i]; });
+	for (int count : calls)
+		EXPECT_EQ(count, 1);
+}
+
+TEST(ThreadPoolTest, ParallelForWithoutWorkers)
+{
+	ThreadPool pool(0);
+	int sum = 0;
+	pool.parallelFor(5, [&sum](unsigned i) { sum += static_cast<int>(i); });
+	EXPECT_EQ(sum, 10);
+}
+
+TEST(ThreadPoolTest, NestedParallelForDoesNotDeadlock)
+{
+	ThreadPool pool(2);
+	std::atomic<int> count { 0 };
+	pool.parallelFor(4, [&](unsigned) {
+		pool.parallelFor(4, [&count](unsigned) { ++count; });
+	});
+	EXPECT_EQ(count, 16);
+}
+
+TEST(ThreadPoolTest, SubmittedTasksRunBeforeShutdown)
+{
+	std::atomic<int> count { 0 };
+	{
+		ThreadPool pool(2);
+		for (int i = 0; i < 50; ++i)
+			pool.submit([&count]() { ++count; });
+	}
+	EXPECT_EQ(count, 50);
+}
+
+} // namespace
+} // namespace devilution
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "engine/render/view_change_tracker.hpp"
+
+namespace devilution {
+namespace {
+
+constexpr int ReachAbove = 100;
+constexpr int ReachBelow = 20;
+constexpr int ViewHeight = 480;
+
+void AddFrame(ViewChangeTracker &tracker, const std::vector<uint64_t> &fingerprints, uint64_t viewKey = 1)
+{
+	tracker.beginFrame(viewKey, ViewHeight);
+	for (size_t i = 0; i < fingerprints.size(); ++i)
+		tracker.addTile(fingerprints[i], static_cast<int>(i) * 50);
+}
+
+TEST(ViewChangeTrackerTest, FirstFrameRedrawsEverything)
+{
+	ViewChangeTracker tracker { ReachAbove, ReachBelow };
+	AddFrame(tracker, { 1, 2, 3 });
+	EXPECT_TRUE(tracker.endFrame());
+}
+
+TEST(ViewChangeTrackerTest, UnchangedFrameRedrawsNothing)
+{
+	ViewChangeTracker tracker { ReachAbove, ReachBelow };
+	AddFrame(tracker, { 1, 2, 3 });
+	tracker.endFrame();
+	AddFrame(tracker, { 1, 2, 3 });
+	EXPECT_FALSE(tracker.endFrame());
+	EXPECT_TRUE(tracker.dirtySpans().empty());
+}
+
+TEST(ViewChangeTrackerTest, ChangedTilesAreMergedAndClipped)
+{
+	ViewChangeTracker tracker { ReachAbove, ReachBelow };
+	const std::vector<uint64_t> fingerprints { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	AddFrame(tracker, fingerprints);
+	tracker.endFrame();
+
+	std::vector<uint64_t> changed = fingerprints;
+	changed[0] = 100;  // y = 0
+	changed[2] = 102;  // y = 100
+	changed[9] = 109;  // y = 450
+	changed[10] = 110; // y = 500, below the view
+	AddFrame(tracker, changed);
+	EXPECT_FALSE(tracker.endFrame());
+	const std::vector<RowSpan> expected { { 0, 120 }, { 350, 480 } };
+	EXPECT_EQ(tracker.dirtySpans(), expected);
+}
+
+TEST(ViewChangeTrackerTest, ViewKeyChangeRedrawsEverything)
+{
+	ViewChangeTracker tracker { ReachAbove, ReachBelow };
+	AddFrame(tracker, { 1, 2, 3 });
+	tracker.endFrame();
+	AddFrame(tracker, { 1, 2, 3 }, 2);
+	EXPECT_TRUE(tracker.endFrame());
+	AddFrame(tracker, { 1, 2, 3 }, 2);
+	EXPECT_FALSE(tracker.endFrame());
+}
+
+TEST(ViewChangeTrackerTest, TileCountChangeRedrawsEverything)
+{
+	ViewChangeTracker tracker { ReachAbove, ReachBelow };
+	AddFrame(tracker, { 1, 2, 3 });
+	tracker.endFrame();
+	AddFrame(tracker, { 1, 2 });
+	EXPECT_TRUE(tracker.endFrame());
+	AddFrame(tracker, { 1, 2, 3 });
+	EXPECT_TRUE(tracker.endFrame());
+}
+
+TEST(ViewChangeTrackerTest, InvalidateRedrawsEverything)
+{
+	ViewChangeTracker tracker { ReachAbove, ReachBelow };
+	AddFrame(tracker, { 1, 2, 3 });
+	tracker.endFrame();
+	tracker.invalidate();
+	AddFrame(tracker, { 1, 2, 3 });
+	EXPECT_TRUE(tracker.endFrame());
+}
+
+TEST(FingerprintTest, DependsOnOrderAndValues)
+{
+	Fingerprint a;
+	a.add(1, 2);
+	Fingerprint b;
+	b.add(2, 1);
+	Fingerprint c;
+	c.add(1, 2);
+	EXPECT_NE(a.value(), b.value());
+	EXPECT_EQ(a.value(), c.value());
+}
+
+} // namespace
+} // namespace devilution
@@ -395,6 +395,7 @@ TEST(Writehero, pfile_write_hero)
 	UnPackPlayer(pks, *MyPlayer);
 	AssertPlayer(Players[0]);
 	pfile_write_hero();
+	ASSERT_TRUE(pfile_wait_for_pending_saves());
 
 	const char *path = "multi_0.sv";
 	uintmax_t fileSize;